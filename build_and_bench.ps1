@@ -0,0 +1,93 @@
+# Build and Run Benchmark Suite for Bus Management System
+
+Write-Host "`n========================================" -ForegroundColor Cyan
+Write-Host "   Building Benchmark Suite" -ForegroundColor Cyan
+Write-Host "========================================`n" -ForegroundColor Cyan
+
+# Create directories if they don't exist
+if (-not (Test-Path "build")) {
+    New-Item -ItemType Directory -Path "build" | Out-Null
+}
+
+if (-not (Test-Path "bin")) {
+    New-Item -ItemType Directory -Path "bin" | Out-Null
+}
+
+# Compile all source files needed for benchmarking (optimized)
+Write-Host "Compiling source files..." -ForegroundColor Yellow
+
+$sourceFiles = @(
+    "src/Bus.cpp",
+    "src/Driver.cpp",
+    "src/Route.cpp",
+    "src/Schedule.cpp",
+    "src/SymbolTable.cpp",
+    "src/TimetableAudit.cpp",
+    "src/AssignmentPlanner.cpp",
+    "src/Transaction.cpp",
+    "src/TravelTimeMatrix.cpp",
+    "src/LoadArena.cpp",
+    "src/User.cpp",
+    "src/MappedFile.cpp",
+    "src/SnapshotFormat.cpp",
+    "src/DataLoader.cpp",
+    "src/DataSaver.cpp",
+    "src/OperationLog.cpp",
+    "src/IntervalIndex.cpp",
+    "src/AvailabilityIndex.cpp",
+    "src/DepartureBoard.cpp",
+    "src/JourneyPlanner.cpp",
+    "src/ScanKernels.cpp",
+    "src/ScheduleStore.cpp",
+    "src/ScheduleQuery.cpp",
+    "src/ScheduleView.cpp",
+    "src/FlushScheduler.cpp",
+    "src/StartupLoader.cpp",
+    "src/DisplayManager.cpp",
+    "src/LoginManager.cpp",
+    "src/RouteManager.cpp",
+    "src/BusManager.cpp",
+    "src/DriverManager.cpp",
+    "src/ScheduleManager.cpp",
+    "src/AllocationCounter.cpp",
+    "src/BenchmarkRunner.cpp",
+    "src/bench_runner.cpp"
+)
+
+$objectFiles = @()
+
+foreach ($sourceFile in $sourceFiles) {
+    $objectFile = "build/" + [System.IO.Path]::GetFileNameWithoutExtension($sourceFile) + ".o"
+    $objectFiles += $objectFile
+    
+    Write-Host "  Compiling $sourceFile..." -ForegroundColor Gray
+    g++ -std=c++17 -Wall -O2 -Iinclude -c $sourceFile -o $objectFile
+    
+    if ($LASTEXITCODE -ne 0) {
+        Write-Host "`nCompilation failed for $sourceFile" -ForegroundColor Red
+        exit 1
+    }
+}
+
+# Link object files
+Write-Host "`nLinking object files..." -ForegroundColor Yellow
+g++ -std=c++17 -Wall -O2 $objectFiles -o "bin/BenchRunner.exe" -lpsapi
+
+if ($LASTEXITCODE -ne 0) {
+    Write-Host "`nLinking failed" -ForegroundColor Red
+    exit 1
+}
+
+Write-Host "`nBuild completed successfully!" -ForegroundColor Green
+Write-Host "Benchmark executable: bin/BenchRunner.exe`n" -ForegroundColor Green
+
+# Run the tests
+Write-Host "========================================" -ForegroundColor Cyan
+Write-Host "   Running Benchmark Suite" -ForegroundColor Cyan
+Write-Host "========================================`n" -ForegroundColor Cyan
+
+# Optional first argument: number of generated schedules
+& "bin/BenchRunner.exe" $args
+
+Write-Host "`nPress any key to continue..."
+$null = $Host.UI.RawUI.ReadKey("NoEcho,IncludeKeyDown")
@@ -21,9 +21,28 @@ $sourceFiles = @(
     "src/Driver.cpp",
     "src/Route.cpp",
     "src/Schedule.cpp",
+    "src/SymbolTable.cpp",
+    "src/TimetableAudit.cpp",
+    "src/AssignmentPlanner.cpp",
+    "src/Transaction.cpp",
+    "src/TravelTimeMatrix.cpp",
+    "src/LoadArena.cpp",
     "src/User.cpp",
+    "src/MappedFile.cpp",
+    "src/SnapshotFormat.cpp",
     "src/DataLoader.cpp",
     "src/DataSaver.cpp",
+    "src/OperationLog.cpp",
+    "src/IntervalIndex.cpp",
+    "src/AvailabilityIndex.cpp",
+    "src/DepartureBoard.cpp",
+    "src/JourneyPlanner.cpp",
+    "src/ScanKernels.cpp",
+    "src/ScheduleStore.cpp",
+    "src/ScheduleQuery.cpp",
+    "src/ScheduleView.cpp",
+    "src/FlushScheduler.cpp",
+    "src/StartupLoader.cpp",
     "src/DisplayManager.cpp",
     "src/LoginManager.cpp",
     "src/RouteManager.cpp",
@@ -40,6 +40,10 @@ private:
     void updateSchedule();
     void removeSchedule();
     void viewSchedules();
+    void viewDeparturesBetween();
+    void auditTimetable();
+    void findFreeResources();
+    void autoAssignTrips();
 
     void clearInputBuffer();
     string getInput(const string &prompt);
@@ -0,0 +1,16 @@
+﻿#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+
+// Counts calls to the global operator new and the bytes currently held
+// through it. Only binaries that link AllocationCounter.cpp (the benchmark
+// runner) replace operator new, so the numbers are meaningful there alone.
+class AllocationCounter
+{
+public:
+    static size_t count();
+    static size_t liveBytes();
+};
+
+#endif
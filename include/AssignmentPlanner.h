@@ -0,0 +1,43 @@
+﻿#ifndef ASSIGNMENTPLANNER_H
+#define ASSIGNMENTPLANNER_H
+
+#include <cstdint>
+#include <vector>
+#include "FixedId.h"
+#include "Schedule.h"
+#include "SymbolTable.h"
+
+using std::vector;
+
+// Picks a bus and a driver for each unassigned trip without double-booking
+// either. Each date and resource kind is planned on its own by interval
+// partitioning: trips are taken by departure, and each goes to a resource
+// already in use that day whose free gap covers it (the gap ending soonest,
+// so longer gaps stay open for longer trips), or else to the next idle
+// resource on the roster. With no earlier schedules that day this opens
+// exactly as many resources as trips run at once, the fewest possible.
+// Idle resources are taken in roster order, so later dates reuse the same
+// ones. Dates and kinds are shared out across worker threads.
+class AssignmentPlanner
+{
+public:
+    struct Report
+    {
+        // Trips given both a bus and a driver, in input order.
+        vector<Schedule> assigned;
+        // Trips with an invalid date or times, or left over when the roster
+        // ran out.
+        vector<EntityId> unassigned;
+        size_t busesUsed = 0;   // Distinct buses the plan gives trips to
+        size_t driversUsed = 0; // Distinct drivers the plan gives trips to
+        size_t datesPlanned = 0;
+    };
+
+    // Bus and driver IDs in trips are ignored. Existing schedules keep their
+    // resources busy; rosters list the resources that may be given trips.
+    // A threadCount of 0 uses one thread per hardware thread.
+    static Report run(const vector<Schedule> &trips, const vector<Schedule> &schedules,
+                      const vector<Symbol> &buses, const vector<Symbol> &drivers, unsigned threadCount = 0);
+};
+
+#endif
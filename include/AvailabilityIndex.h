@@ -0,0 +1,67 @@
+﻿#ifndef AVAILABILITYINDEX_H
+#define AVAILABILITYINDEX_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "IntervalIndex.h"
+#include "SymbolTable.h"
+
+using std::unordered_map;
+using std::vector;
+
+// Minute-by-minute occupancy of buses or drivers. Each (resource, day
+// number) with schedules has a row of 1440 bits, one per minute since
+// midnight, set while a schedule runs [departure, arrival). A day stores
+// its rows word by word, so word w of every row sits in one contiguous
+// column. A free-resource query ANDs the window's masks down the two or
+// three columns it covers, marks the busy rows in a bitmap over a roster
+// of resources, and reads the roster entries left clear off that bitmap
+// 64 at a time.
+class AvailabilityIndex
+{
+public:
+    static constexpr int32_t MINUTES_PER_DAY = 24 * 60;
+    static constexpr size_t WORDS_PER_ROW = (MINUTES_PER_DAY + 63) / 64;
+
+    void clear();
+
+    // Marks [start, end) busy.
+    void occupy(Symbol resource, int32_t day, int16_t start, int16_t end);
+    // Redraws a row from the intervals the resource still has on the day,
+    // since clearing one schedule's minutes could free minutes another
+    // overlapping schedule holds; nullptr drops the row.
+    void redraw(Symbol resource, int32_t day, const IntervalIndex::Group *intervals);
+
+    bool isFree(Symbol resource, int32_t day, int16_t start, int16_t end) const;
+
+    // The resources findFree picks from, in the order it returns them.
+    void setRoster(const vector<Symbol> &resources);
+    // Roster entries with no busy minute in [start, end) on the day.
+    vector<Symbol> findFree(int32_t day, int16_t start, int16_t end) const;
+
+    size_t rowCount() const;
+
+private:
+    struct Day
+    {
+        unordered_map<Symbol, uint32_t> rowOf;
+        vector<Symbol> resources; // Owner of each row
+        vector<uint64_t> words;   // Word w of row r at w * capacity + r
+        size_t capacity = 0;
+    };
+
+    unordered_map<int32_t, Day> days;
+    vector<Symbol> roster;
+    // Roster position by symbol, UINT32_MAX for symbols not on the roster.
+    vector<uint32_t> rosterPosition;
+    size_t rows = 0;
+
+    // The resource's row on the day, added cleared if missing.
+    uint32_t row(Symbol resource, int32_t day);
+    static void setMinutes(Day &entry, uint32_t position, int16_t start, int16_t end);
+    // Masks for words [start / 64, (end - 1) / 64] of a row; false for an empty window.
+    static bool windowMasks(int16_t start, int16_t end, size_t &first, vector<uint64_t> &masks);
+};
+
+#endif
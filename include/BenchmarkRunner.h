@@ -0,0 +1,58 @@
+﻿#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+class BenchmarkRunner
+{
+private:
+    string dataDir;
+    size_t scheduleCount;
+    size_t busCount;
+    size_t driverCount;
+    size_t routeCount;
+    size_t lookupScheduleCount;
+
+    // Bus and driver count for the in-memory lookup benchmark
+    static const size_t LOOKUP_ENTITY_COUNT = 100000;
+
+    // Result tracking
+    void printBenchmarkHeader(const string &category);
+    void logResult(const string &name, double milliseconds, const string &note = "");
+
+    // Synthetic data set written in the same CSV format as data/
+    void generateDataset();
+    string dataFile(const string &name) const;
+
+    // Individual benchmarks
+    void benchmarkLoaders();
+    void benchmarkParallelLoader();
+    void benchmarkStartup();
+    void benchmarkSnapshot();
+    void benchmarkArenaLoading();
+    void benchmarkMutationLog();
+    void benchmarkBatchImport();
+    void benchmarkLookups();
+    void benchmarkTimetableBuild();
+    void benchmarkScans();
+    void benchmarkRemovals();
+    void benchmarkAudit();
+    void benchmarkJourneyPlanner();
+    void benchmarkDepartureBoard();
+    void benchmarkAvailability();
+    void benchmarkAssignment();
+    void benchmarkTravelTimes();
+    void benchmarkAllocations();
+    void benchmarkFootprint();
+
+public:
+    BenchmarkRunner(const string &dataDirectory, size_t schedules, size_t lookupSchedules = 10000000);
+
+    void runAllBenchmarks();
+};
+
+#endif // BENCHMARKRUNNER_H
@@ -2,26 +2,32 @@
 #define BUS_H
 
 #include <string>
+#include <string_view>
 #include <iostream>
+#include "FixedId.h"
+#include "LoadArena.h"
+#include "SymbolTable.h"
 
 using std::string;
+using std::string_view;
 
 class Bus
 {
 private:
-    string id;
+    EntityId id;
+    std::pmr::string model; // allocated from LoadArena::current()
     int capacity;
-    string model;
-    string status;
+    Symbol status; // interned, see SymbolTable
 
 public:
     Bus();
-    Bus(const string &id, int capacity, const string &model, const string &status);
+    Bus(const string &id, int capacity, string_view model, string_view status);
 
-    string getId() const;
+    const EntityId &getId() const;
     int getCapacity() const;
-    string getModel() const;
-    string getStatus() const;
+    string_view getModel() const;
+    const string &getStatus() const;
+    Symbol getStatusSymbol() const;
 
     void setId(const string &id);
     void setCapacity(int capacity);
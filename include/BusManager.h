@@ -4,28 +4,80 @@
 #include <string>
 #include <vector>
 #include "Bus.h"
+#include "FlushScheduler.h"
+#include "IdIndex.h"
+#include "OperationLog.h"
 
 using std::string;
 using std::vector;
 
 class BusManager
 {
+public:
+    // Stays valid while other buses are added and removed; resolving it
+    // after the bus itself is removed yields nullptr.
+    using Handle = SlotMap<Bus>::Handle;
+
 private:
     vector<Bus> &buses;
     string dataFile;
+    OperationLog log;
+    size_t compactionThreshold;
+    FlushScheduler *flusher;
+    size_t flushHandle;
+    mutex compactMutex; // One compaction at a time, so checkpoints land in order
+    SlotMap<Bus> slots;
+    IdIndex<Bus> index;
+    size_t revision;
+
+    bool persist(char operation, const EntityId &busId, const Bus *bus = nullptr);
+    bool persistBatch(const vector<LogEntry> &entries);
+    // The flusher's job: syncs the log, and compacts once it is due.
+    bool commitLog();
+
+    // The checks behind addBus, updateBus and removeBus, which print why a
+    // change is refused, and the unchecked changes they guard. Transaction
+    // runs them for a whole batch under one data lock.
+    bool checkAdd(const Bus &newBus) const;
+    bool checkUpdate(const EntityId &busId, const Bus &updatedBus) const;
+    bool checkRemove(const EntityId &busId) const;
+    void applyAdd(const Bus &newBus);
+    void applyUpdate(const EntityId &busId, const Bus &updatedBus);
+    void applyRemove(const EntityId &busId);
+
+    friend class Transaction;
 
 public:
     BusManager(vector<Bus> &busList, const string &filename);
 
     bool addBus(const Bus &newBus);
-    bool updateBus(const string &busId, const Bus &updatedBus);
-    bool removeBus(const string &busId);
+    bool updateBus(const EntityId &busId, const Bus &updatedBus);
+    bool updateBus(Handle handle, const Bus &updatedBus);
+    bool removeBus(const EntityId &busId);
+
+    Bus *findBus(const EntityId &busId);
+    Handle findBusHandle(const EntityId &busId) const;
+    Bus *getBus(Handle handle);
+    bool busExists(const EntityId &busId) const;
 
-    Bus *findBus(const string &busId);
-    bool busExists(const string &busId) const;
+    // Bumped by every add, update and remove.
+    size_t getRevision() const;
 
     bool saveToFile();
 
+    // Mutations are appended to <dataFile>.log; once the log holds
+    // compactionThreshold entries it is folded back into the data file.
+    // The records are formatted under the flusher's data lock and written
+    // outside it; changes logged meanwhile stay in the log.
+    bool compact();
+    void setCompactionThreshold(size_t entries);
+
+    // Hands durability to a shared group-commit flusher: mutations still go
+    // to the log at once, and after its commit window the flusher syncs the
+    // log, folding it into the data file once it holds compactionThreshold
+    // entries. The scheduler must be destroyed first.
+    void attachFlusher(FlushScheduler &scheduler);
+
     void displayAllBuses() const;
 
     bool validateBus(const Bus &bus) const;
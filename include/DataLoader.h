@@ -1,32 +1,91 @@
 ﻿#ifndef DATALOADER_H
 #define DATALOADER_H
 
+#include <ostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "Bus.h"
 #include "Driver.h"
 #include "Route.h"
 #include "Schedule.h"
 #include "User.h"
+#include "SystemData.h"
 
+using std::ostream;
 using std::string;
+using std::string_view;
 using std::vector;
 
+enum class LoadMode
+{
+    STREAM,
+    MAPPED,
+    PARALLEL // mapped; schedules.txt is also split across threads
+};
+
 class DataLoader
 {
 public:
+    static void setLoadMode(LoadMode mode);
+    static LoadMode getLoadMode();
+
+    // Worker threads for PARALLEL mode; 0 means one per hardware thread.
+    static void setThreadCount(unsigned count);
+    static unsigned getThreadCount();
+
+    // Sends this thread's "Loaded ..." summaries and load errors to the given
+    // streams instead of cout/cerr; pass nullptr to restore the defaults.
+    static void redirectOutput(ostream *messages, ostream *errors);
+
     static vector<Bus> loadBuses(const string &filename);
     static vector<Driver> loadDrivers(const string &filename);
     static vector<Route> loadRoutes(const string &filename);
     static vector<Schedule> loadSchedules(const string &filename);
     static vector<User> loadCredentials(const string &filename);
 
+    // Unassigned trips, one "ScheduleID,RouteID,Date,DepartureTime,ArrivalTime"
+    // per line, as schedules with no bus or driver.
+    static vector<Schedule> loadTrips(const string &filename);
+
+    // Fills data from a binary snapshot written by DataSaver::saveSnapshot.
+    // Returns false, leaving data untouched, if the snapshot is missing,
+    // corrupt, from another format version or older than sourceFiles.
+    static bool loadSnapshot(const string &filename, const vector<string> &sourceFiles, SystemData &data);
+
     static vector<string> splitCSV(const string &line, char delimiter = ',');
 
     static vector<string> parseKeyStops(const string &stopsStr);
 
+    // Splits line into at most maxFields slices without allocating and
+    // returns the total number of fields, matching splitCSV's count.
+    static size_t splitFields(string_view line, string_view *fields, size_t maxFields,
+                              char delimiter = ',');
+
+    // Parse a single CSV record in the data file format; on failure the
+    // entity is left unchanged and error describes the problem. A schedule
+    // whose date or time cannot be read still parses, as INVALID_DAY or
+    // INVALID_TIME with error set, so every load mode keeps the row.
+    static bool parseBusRecord(string_view record, Bus &bus, string &error);
+    static bool parseDriverRecord(string_view record, Driver &driver, string &error);
+    static bool parseRouteRecord(string_view record, Route &route, string &error);
+    static bool parseScheduleRecord(string_view record, Schedule &schedule, string &error);
+    static bool parseUserRecord(string_view record, User &user, string &error);
+
 private:
+    static LoadMode loadMode;
+    static unsigned threadCount;
+
+    static vector<Bus> loadBusesMapped(const string &filename);
+    static vector<Driver> loadDriversMapped(const string &filename);
+    static vector<Route> loadRoutesMapped(const string &filename);
+    static vector<Schedule> loadSchedulesMapped(const string &filename);
+    static vector<Schedule> loadSchedulesParallel(const string &filename);
+    static vector<User> loadCredentialsMapped(const string &filename);
+
     static void logError(const string &filename, int lineNumber, const string &error);
+    static ostream &messageStream();
+    static ostream &errorStream();
 };
 
 #endif
@@ -1,6 +1,7 @@
 ﻿#ifndef DATASAVER_H
 #define DATASAVER_H
 
+#include <ostream>
 #include <string>
 #include <vector>
 #include "Bus.h"
@@ -8,18 +9,55 @@
 #include "Route.h"
 #include "Schedule.h"
 #include "User.h"
+#include "SystemData.h"
 
+using std::ostream;
 using std::string;
 using std::vector;
 
 class DataSaver
 {
 public:
+    // Sends this thread's "Successfully saved ..." messages and save errors
+    // to the given streams instead of cout/cerr; nullptr restores the defaults.
+    static void redirectOutput(ostream *messages, ostream *errors);
+
+    // Writes contents to <filename>.tmp, syncs it to disk and renames it over
+    // filename, so readers see either the old file or the new one in full.
+    static bool writeFileAtomically(const string &filename, const string &contents);
+
+    // One CSV record in the data file format, without the line ending.
+    static string formatBus(const Bus &bus);
+    static string formatDriver(const Driver &driver);
+    static string formatRoute(const Route &route);
+    static string formatSchedule(const Schedule &schedule);
+    // Same record written into line, reusing its capacity.
+    static void formatSchedule(const Schedule &schedule, string &line);
+    static string formatUser(const User &user);
+
+    // Whole data file contents, one record per line.
+    static string formatBuses(const vector<Bus> &buses);
+    static string formatDrivers(const vector<Driver> &drivers);
+    static string formatRoutes(const vector<Route> &routes);
+    static string formatSchedules(const vector<Schedule> &schedules);
+
+    // Writes contents formatted above and reports the count of what it saved.
+    static bool saveFormatted(const string &filename, const string &contents, size_t count, const string &what);
+
     static bool saveBuses(const string &filename, const vector<Bus> &buses);
     static bool saveDrivers(const string &filename, const vector<Driver> &drivers);
     static bool saveRoutes(const string &filename, const vector<Route> &routes);
     static bool saveSchedules(const string &filename, const vector<Schedule> &schedules);
     static bool saveCredentials(const string &filename, const vector<User> &users);
+
+    // Writes all entities as a binary snapshot (see SnapshotFormat.h) stamped
+    // with the current size and modification time of sourceFiles.
+    static bool saveSnapshot(const string &filename, const SystemData &data,
+                             const vector<string> &sourceFiles);
+
+private:
+    static ostream &messageStream();
+    static ostream &errorStream();
 };
 
 #endif
@@ -0,0 +1,70 @@
+﻿#ifndef DEPARTUREBOARD_H
+#define DEPARTUREBOARD_H
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Route.h"
+#include "Schedule.h"
+#include "SlotMap.h"
+#include "SymbolTable.h"
+
+using std::string_view;
+using std::unordered_map;
+using std::vector;
+
+// Departures from each stop, sorted by time. A trip leaves its route's
+// origin at its departure time and each key stop later by the route's
+// estimated travel time spread evenly over the stops; the destination is
+// only arrived at, so it has no departures. Entries name schedules by slot
+// handle, so they survive other schedules moving in the list.
+class DepartureBoard
+{
+public:
+    using Handle = SlotMap<Schedule>::Handle;
+
+    static constexpr int32_t MINUTES_PER_DAY = 24 * 60;
+
+    struct Departure
+    {
+        // Minutes since day 0 (day number * 1440 + minute); 64 bits, as
+        // late years parseDate accepts overflow 32.
+        int64_t time;
+        Handle schedule;
+    };
+
+    void build(const vector<Route> &routes, const vector<Schedule> &schedules, const SlotMap<Schedule> &slots);
+    void clear();
+
+    // Keep the board in step with one schedule; a schedule whose route
+    // is unknown has no departures.
+    void insert(const Schedule &schedule, Handle handle);
+    void erase(const Schedule &schedule, Handle handle);
+
+    // The first count departures from stop at or after the given time,
+    // earliest first. Empty for an unknown stop.
+    vector<Departure> next(string_view stop, int32_t day, int16_t minute, size_t count) const;
+
+    bool isBuilt() const;
+    size_t departureCount() const;
+
+private:
+    struct RouteStops
+    {
+        vector<Symbol> stops; // Origin and key stops, in order
+        int32_t travelTime;
+        uint32_t hops;        // Stops including the destination, less one
+    };
+
+    unordered_map<Symbol, RouteStops> routeStops;
+    unordered_map<Symbol, vector<Departure>> boards;
+    size_t departures = 0;
+    bool built = false;
+
+    // Calls visit(stop, time) for each stop the schedule departs from.
+    template <typename Visit>
+    void forEachStop(const Schedule &schedule, Visit visit) const;
+};
+
+#endif
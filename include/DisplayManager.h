@@ -1,13 +1,19 @@
 ﻿#ifndef DISPLAYMANAGER_H
 #define DISPLAYMANAGER_H
 
+#include <utility>
 #include <vector>
+#include "AssignmentPlanner.h"
 #include "Bus.h"
 #include "Driver.h"
+#include "JourneyPlanner.h"
 #include "Route.h"
 #include "Schedule.h"
+#include "ScheduleView.h"
+#include "TimetableAudit.h"
 #include "User.h"
 
+using std::pair;
 using std::vector;
 
 class DisplayManager
@@ -16,8 +22,18 @@ public:
     static void displayBuses(const vector<Bus> &buses);
     static void displayDrivers(const vector<Driver> &drivers);
     static void displayRoutes(const vector<Route> &routes);
+    static void displayRoutes(const vector<const Route *> &routes);
     static void displaySchedules(const vector<Schedule> &schedules);
+    static void displaySchedules(const ScheduleView &schedules);
     static void displayUsers(const vector<User> &users);
+    static void displayConflictReport(const TimetableAudit::Report &report);
+    static void displayItineraries(const vector<JourneyPlanner::Itinerary> &itineraries);
+    // Departure time (day number * 1440 + minute) at the stop, and the trip.
+    static void displayDepartures(const string &stop, const vector<pair<int64_t, const Schedule *>> &departures);
+    // Lists at most limit IDs of each kind, with the total.
+    static void displayFreeResources(const vector<Symbol> &freeBuses, const vector<Symbol> &freeDrivers,
+                                     size_t limit);
+    static void displayAssignmentReport(const AssignmentPlanner::Report &report);
 
     static void displayBus(const Bus &bus);
     static void displayDriver(const Driver &driver);
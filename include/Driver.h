@@ -2,27 +2,32 @@
 #define DRIVER_H
 
 #include <string>
+#include <string_view>
 #include <iostream>
+#include "FixedId.h"
+#include "LoadArena.h"
 
 using std::string;
+using std::string_view;
 
 class Driver
 {
 private:
-    string id;
-    string name;
-    string contactInfo;
-    string licenseDetails;
+    EntityId id;
+    // Allocated from LoadArena::current()
+    std::pmr::string name;
+    std::pmr::string contactInfo;
+    std::pmr::string licenseDetails;
 
 public:
     Driver();
-    Driver(const string &id, const string &name,
-           const string &contactInfo, const string &licenseDetails);
+    Driver(const string &id, string_view name,
+           string_view contactInfo, string_view licenseDetails);
 
-    string getId() const;
-    string getName() const;
-    string getContactInfo() const;
-    string getLicenseDetails() const;
+    const EntityId &getId() const;
+    string_view getName() const;
+    string_view getContactInfo() const;
+    string_view getLicenseDetails() const;
 
     void setId(const string &id);
     void setName(const string &name);
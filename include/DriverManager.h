@@ -4,28 +4,80 @@
 #include <string>
 #include <vector>
 #include "Driver.h"
+#include "FlushScheduler.h"
+#include "IdIndex.h"
+#include "OperationLog.h"
 
 using std::string;
 using std::vector;
 
 class DriverManager
 {
+public:
+    // Stays valid while other drivers are added and removed; resolving it
+    // after the driver itself is removed yields nullptr.
+    using Handle = SlotMap<Driver>::Handle;
+
 private:
     vector<Driver> &drivers;
     string dataFile;
+    OperationLog log;
+    size_t compactionThreshold;
+    FlushScheduler *flusher;
+    size_t flushHandle;
+    mutex compactMutex; // One compaction at a time, so checkpoints land in order
+    SlotMap<Driver> slots;
+    IdIndex<Driver> index;
+    size_t revision;
+
+    bool persist(char operation, const EntityId &driverId, const Driver *driver = nullptr);
+    bool persistBatch(const vector<LogEntry> &entries);
+    // The flusher's job: syncs the log, and compacts once it is due.
+    bool commitLog();
+
+    // The checks behind addDriver, updateDriver and removeDriver, which print why a
+    // change is refused, and the unchecked changes they guard. Transaction
+    // runs them for a whole batch under one data lock.
+    bool checkAdd(const Driver &newDriver) const;
+    bool checkUpdate(const EntityId &driverId, const Driver &updatedDriver) const;
+    bool checkRemove(const EntityId &driverId) const;
+    void applyAdd(const Driver &newDriver);
+    void applyUpdate(const EntityId &driverId, const Driver &updatedDriver);
+    void applyRemove(const EntityId &driverId);
+
+    friend class Transaction;
 
 public:
     DriverManager(vector<Driver> &driverList, const string &filename);
 
     bool addDriver(const Driver &newDriver);
-    bool updateDriver(const string &driverId, const Driver &updatedDriver);
-    bool removeDriver(const string &driverId);
+    bool updateDriver(const EntityId &driverId, const Driver &updatedDriver);
+    bool updateDriver(Handle handle, const Driver &updatedDriver);
+    bool removeDriver(const EntityId &driverId);
+
+    Driver *findDriver(const EntityId &driverId);
+    Handle findDriverHandle(const EntityId &driverId) const;
+    Driver *getDriver(Handle handle);
+    bool driverExists(const EntityId &driverId) const;
 
-    Driver *findDriver(const string &driverId);
-    bool driverExists(const string &driverId) const;
+    // Bumped by every add, update and remove.
+    size_t getRevision() const;
 
     bool saveToFile();
 
+    // Mutations are appended to <dataFile>.log; once the log holds
+    // compactionThreshold entries it is folded back into the data file.
+    // The records are formatted under the flusher's data lock and written
+    // outside it; changes logged meanwhile stay in the log.
+    bool compact();
+    void setCompactionThreshold(size_t entries);
+
+    // Hands durability to a shared group-commit flusher: mutations still go
+    // to the log at once, and after its commit window the flusher syncs the
+    // log, folding it into the data file once it holds compactionThreshold
+    // entries. The scheduler must be destroyed first.
+    void attachFlusher(FlushScheduler &scheduler);
+
     void displayAllDrivers() const;
 
     bool validateDriver(const Driver &driver) const;
@@ -0,0 +1,139 @@
+﻿#ifndef FIXEDID_H
+#define FIXEDID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+using std::ostream;
+using std::size_t;
+using std::string;
+using std::string_view;
+
+// ID of up to N characters stored inline and zero-padded to whole 64-bit
+// words, with the length in the last byte. Copying is a memcpy, and
+// comparing or hashing two IDs reads a few words without touching the heap.
+// Text longer than N is cut to N characters and marked as overflowed, so it
+// never compares equal to a valid ID and validation can reject it.
+template <size_t N>
+class FixedId
+{
+public:
+    static constexpr size_t CAPACITY = N;
+
+private:
+    static_assert(N > 0 && N < 255, "FixedId length must fit in its length byte");
+
+    // At least one spare byte for the length.
+    static constexpr size_t STORAGE = (N / 8 + 1) * 8;
+    static constexpr char OVERFLOWED = static_cast<char>(0xFF);
+
+    char chars[STORAGE];
+
+public:
+    constexpr FixedId() : chars{} {}
+
+    // Implicit, so manager calls taking an ID accept strings and literals.
+    constexpr FixedId(string_view text) : chars{}
+    {
+        size_t length = text.size() <= N ? text.size() : N;
+        for (size_t i = 0; i < length; ++i)
+        {
+            chars[i] = text[i];
+        }
+        chars[STORAGE - 1] = text.size() <= N ? static_cast<char>(length) : OVERFLOWED;
+    }
+
+    constexpr FixedId(const char *text) : FixedId(string_view(text)) {}
+
+    FixedId(const string &text) : FixedId(string_view(text)) {}
+
+    static constexpr bool fits(string_view text)
+    {
+        return text.size() <= N;
+    }
+
+    // False if the text it was built from was longer than N.
+    constexpr bool isValid() const
+    {
+        return chars[STORAGE - 1] != OVERFLOWED;
+    }
+
+    constexpr size_t size() const
+    {
+        return isValid() ? static_cast<unsigned char>(chars[STORAGE - 1]) : N;
+    }
+
+    constexpr bool empty() const
+    {
+        return chars[STORAGE - 1] == 0;
+    }
+
+    constexpr string_view view() const
+    {
+        return string_view(chars, size());
+    }
+
+    string str() const
+    {
+        return string(chars, size());
+    }
+
+    size_t hash() const
+    {
+        uint64_t h = 0;
+        for (size_t i = 0; i < STORAGE; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, chars + i, 8);
+            h = (h ^ word) * 0x9E3779B97F4A7C15ULL;
+            h ^= h >> 29;
+        }
+        return static_cast<size_t>(h);
+    }
+
+    friend bool operator==(const FixedId &a, const FixedId &b)
+    {
+        return std::memcmp(a.chars, b.chars, STORAGE) == 0;
+    }
+
+    friend bool operator!=(const FixedId &a, const FixedId &b)
+    {
+        return !(a == b);
+    }
+
+    friend bool operator<(const FixedId &a, const FixedId &b)
+    {
+        return a.view() < b.view();
+    }
+
+    friend ostream &operator<<(ostream &out, const FixedId &id)
+    {
+        return out << id.view();
+    }
+};
+
+// AdminDashboard's validateId caps IDs at 20 characters.
+using EntityId = FixedId<20>;
+
+static_assert(std::is_trivially_copyable<EntityId>::value, "EntityId must copy as plain bytes");
+static_assert(sizeof(EntityId) == 24, "EntityId should fill three words");
+
+namespace std
+{
+    template <size_t N>
+    struct hash<FixedId<N>>
+    {
+        size_t operator()(const FixedId<N> &id) const
+        {
+            return id.hash();
+        }
+    };
+}
+
+#endif
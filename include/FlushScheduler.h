@@ -0,0 +1,87 @@
+﻿#ifndef FLUSHSCHEDULER_H
+#define FLUSHSCHEDULER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::condition_variable;
+using std::function;
+using std::mutex;
+using std::string;
+using std::thread;
+using std::unique_lock;
+using std::vector;
+
+// Group-commit writer shared by the managers. A mutation appends to its
+// log and marks the file dirty; a background thread waits for the commit
+// window to close and then runs each dirty file's flush function once,
+// however many mutations it saw. Managers hold dataLock() while mutating
+// and while taking the snapshot a flush writes, but not during the write.
+class FlushScheduler
+{
+public:
+    using FlushFn = function<bool()>;
+
+    static const unsigned DEFAULT_WINDOW_MS = 250;
+
+    // Locks the scheduler's data lock for the guard's lifetime; a null
+    // scheduler makes the guard a no-op.
+    class Guard
+    {
+    private:
+        unique_lock<mutex> lock;
+
+    public:
+        explicit Guard(FlushScheduler *scheduler);
+    };
+
+    explicit FlushScheduler(unsigned windowMs = DEFAULT_WINDOW_MS);
+    ~FlushScheduler();
+
+    FlushScheduler(const FlushScheduler &) = delete;
+    FlushScheduler &operator=(const FlushScheduler &) = delete;
+
+    // Returns the handle passed to markDirty for this file.
+    size_t registerFile(const string &name, FlushFn flushFn);
+    void markDirty(size_t handle);
+
+    // Barrier: writes every dirty file on the calling thread and returns
+    // once nothing is pending. Must not be called while holding dataLock().
+    bool flush();
+
+    void setWindow(unsigned windowMs);
+    unsigned getWindow() const;
+
+    mutex &dataLock();
+
+    size_t pendingCount() const;
+    size_t getWriteCount() const;
+
+private:
+    struct Entry
+    {
+        string name;
+        FlushFn flushFn;
+        bool dirty;
+    };
+
+    vector<Entry> entries;
+    unsigned window;
+    bool stopping;
+    size_t writeCount;
+
+    mutex dataMutex;
+    mutex writeMutex; // Held by writeDirty, so a barrier waits for a write in progress
+    mutable mutex stateMutex;
+    condition_variable wakeUp;
+    thread worker;
+
+    void run();
+    bool writeDirty(bool quiet);
+};
+
+#endif
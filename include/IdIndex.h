@@ -0,0 +1,110 @@
+﻿#ifndef IDINDEX_H
+#define IDINDEX_H
+
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+#include "FixedId.h"
+#include "SlotMap.h"
+
+using std::unordered_map;
+using std::vector;
+
+// Hash index from entity ID to the entity's slot-map handle.
+// When a file holds duplicate IDs the first one wins, as with a linear scan.
+template <typename T>
+class IdIndex
+{
+public:
+    using Handle = typename SlotMap<T>::Handle;
+
+private:
+    // Nodes come from a pool that reuses freed blocks, so adding an entity
+    // rarely reaches the global heap.
+    std::pmr::unsynchronized_pool_resource pool;
+    std::pmr::unordered_map<EntityId, Handle> handles{&pool};
+    bool duplicates = false;
+
+public:
+    void rebuild(const vector<T> &entities, const SlotMap<T> &slots)
+    {
+        handles.clear();
+        handles.reserve(entities.size());
+        duplicates = false;
+        for (size_t i = 0; i < entities.size(); ++i)
+        {
+            if (!handles.emplace(entities[i].getId(), slots.handleAt(i)).second)
+            {
+                duplicates = true;
+            }
+        }
+    }
+
+    // Returns a null handle when the ID is unknown.
+    Handle find(const EntityId &id) const
+    {
+        auto it = handles.find(id);
+        return it == handles.end() ? Handle() : it->second;
+    }
+
+    bool contains(const EntityId &id) const
+    {
+        return handles.count(id) > 0;
+    }
+
+    void insert(const EntityId &id, Handle handle)
+    {
+        handles.emplace(id, handle);
+    }
+
+    void rename(const EntityId &oldId, const EntityId &newId)
+    {
+        if (oldId == newId)
+        {
+            return;
+        }
+
+        auto it = handles.find(oldId);
+        if (it != handles.end())
+        {
+            Handle handle = it->second;
+            handles.erase(it);
+            handles.emplace(newId, handle);
+        }
+    }
+
+    // Erases the entity from the slot map along with its index entry.
+    void erase(const EntityId &id, vector<T> &entities, SlotMap<T> &slots)
+    {
+        auto it = handles.find(id);
+        if (it == handles.end())
+        {
+            return;
+        }
+        slots.erase(it->second);
+        handles.erase(it);
+
+        if (!duplicates)
+        {
+            return;
+        }
+
+        // A remaining duplicate of the erased ID becomes the match; only
+        // files that loaded with duplicate IDs pay for this scan.
+        for (size_t i = 0; i < entities.size(); ++i)
+        {
+            if (entities[i].getId() == id)
+            {
+                handles.emplace(id, slots.handleAt(i));
+                break;
+            }
+        }
+    }
+
+    size_t size() const
+    {
+        return handles.size();
+    }
+};
+
+#endif
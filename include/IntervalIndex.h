@@ -0,0 +1,63 @@
+﻿#ifndef INTERVALINDEX_H
+#define INTERVALINDEX_H
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "FixedId.h"
+#include "SymbolTable.h"
+
+using std::string;
+using std::unordered_map;
+using std::vector;
+
+// Schedule intervals in minutes since midnight, grouped by (resource,
+// day number) and sorted by departure time. Each interval also carries the
+// running maximum of arrival times up to it, so an overlap check is a
+// binary search for the last departure before the query ends plus a walk
+// back that stops once no earlier interval can reach it. Resources are
+// interned bus or driver IDs.
+class IntervalIndex
+{
+public:
+    struct Interval
+    {
+        int16_t start;
+        int16_t end;
+        EntityId scheduleId;
+        int16_t maxEnd = 0; // Latest end up to here in the group; kept by the index
+    };
+    using Group = std::pmr::vector<Interval>;
+
+    void clear();
+    void insert(Symbol resource, int32_t day, const Interval &interval);
+    bool erase(Symbol resource, int32_t day, const Interval &interval);
+
+    // An interval overlapping [start, end) whose schedule is not excludeId,
+    // using the same test as Schedule::hasTimeOverlap; nullptr if none.
+    const Interval *findOverlap(Symbol resource, int32_t day,
+                                int16_t start, int16_t end,
+                                const EntityId &excludeId = EntityId()) const;
+
+    // The resource's intervals on the day, by departure; nullptr if none.
+    const Group *intervalsOf(Symbol resource, int32_t day) const;
+
+    size_t size() const;
+
+private:
+    // Map nodes and group storage come from a pool that reuses freed blocks,
+    // so indexing a schedule rarely reaches the global heap.
+    std::pmr::unsynchronized_pool_resource pool;
+    // Keyed by resource and day packed into one word, so a new group costs
+    // one hash node rather than a node in a per-resource map of days.
+    std::pmr::unordered_map<uint64_t, Group> groups{&pool};
+    size_t count = 0;
+
+    static uint64_t groupKey(Symbol resource, int32_t day);
+    const Group *findGroup(Symbol resource, int32_t day) const;
+    static void refreshMaxEnd(Group &group, size_t from);
+};
+
+#endif
@@ -0,0 +1,114 @@
+﻿#ifndef JOURNEYPLANNER_H
+#define JOURNEYPLANNER_H
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "FixedId.h"
+#include "Route.h"
+#include "Schedule.h"
+#include "SymbolTable.h"
+
+using std::string_view;
+using std::unordered_map;
+using std::vector;
+
+class RouteManager;
+class ScheduleManager;
+
+// Earliest-arrival journeys with transfers, found by a round-based (RAPTOR)
+// search over the dated trips. A route's stops are its origin, key stops and
+// destination in order; a trip runs them from its departure to its arrival,
+// and the times at key stops are spread evenly in between, since schedules
+// only record the two ends. Trips of a route with the same duration form a
+// pattern that never overtakes itself, so boarding is a binary search over
+// the pattern's departures. Round k finds the best arrivals using k trips.
+class JourneyPlanner
+{
+public:
+    // Times are minutes since day 0 (day number * 1440 + minute); 64 bits,
+    // as late years parseDate accepts overflow 32.
+    struct Leg
+    {
+        EntityId scheduleId;
+        EntityId routeId;
+        Symbol from;
+        Symbol to;
+        int64_t departure;
+        int64_t arrival;
+    };
+
+    struct Itinerary
+    {
+        vector<Leg> legs;
+
+        int64_t arrival() const;
+        size_t transfers() const;
+    };
+
+    struct Options
+    {
+        size_t maxTransfers = 3;
+        // Time to change between trips at a stop; boarding the first trip
+        // at the origin needs none.
+        int transferMinutes = 5;
+    };
+
+    static constexpr int32_t MINUTES_PER_DAY = 24 * 60;
+
+    void build(const vector<Route> &routes, const vector<Schedule> &schedules);
+
+    // Rebuilds from the managers only if either changed since the last call.
+    void refresh(const RouteManager &routeManager, const ScheduleManager &scheduleManager);
+
+    // One itinerary per transfer count that arrives earlier than every
+    // itinerary with fewer transfers, fewest transfers first; the last one
+    // is the earliest arrival. Empty if either stop is unknown or the
+    // destination cannot be reached.
+    vector<Itinerary> plan(string_view from, string_view to, int32_t day, int16_t minute) const;
+    vector<Itinerary> plan(string_view from, string_view to, int32_t day, int16_t minute,
+                           const Options &options) const;
+
+    size_t stopCount() const;
+    size_t patternCount() const;
+    size_t tripCount() const;
+
+private:
+    struct Pattern
+    {
+        uint32_t route;     // Position in routeIds
+        uint32_t firstStop; // Into patternStops
+        uint32_t stopCount;
+        int32_t duration;
+        uint32_t firstTrip; // Into tripDepartures and tripIds
+        uint32_t tripCount;
+    };
+
+    struct StopVisit
+    {
+        uint32_t pattern;
+        uint32_t position;
+    };
+
+    vector<Symbol> stopNames;
+    unordered_map<Symbol, uint32_t> stopIndex;
+    vector<EntityId> routeIds;
+    vector<Pattern> patterns;
+    vector<uint32_t> patternStops;
+    // Departures from the first stop, ascending within each pattern.
+    vector<int64_t> tripDepartures;
+    vector<EntityId> tripIds;
+    // Patterns through each stop: visits[visitStart[s], visitStart[s + 1]).
+    vector<uint32_t> visitStart;
+    vector<StopVisit> visits;
+
+    bool built = false;
+    size_t routeRevision = 0;
+    size_t scheduleRevision = 0;
+
+    uint32_t addStop(Symbol name);
+    int32_t offset(const Pattern &pattern, uint32_t position) const;
+};
+
+#endif
@@ -0,0 +1,79 @@
+﻿#ifndef LOADARENA_H
+#define LOADARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+// Monotonic region for the text fields and stop lists of one loaded file.
+// Entities constructed on a thread while a Scope is active allocate from
+// the arena instead of the heap; destroying the arena frees the whole region
+// in a few large blocks rather than one free per string. The arena must
+// outlive every entity loaded into it (SystemData keeps them together).
+class LoadArena
+{
+private:
+    // Passes allocations through to the heap, counting the bytes held.
+    class CountingResource : public std::pmr::memory_resource
+    {
+    private:
+        size_t bytes = 0;
+
+        void *do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void *pointer, size_t size, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    public:
+        size_t getBytes() const;
+    };
+
+    static const size_t INITIAL_BLOCK_SIZE = 64 * 1024;
+    static thread_local std::pmr::memory_resource *active;
+
+    CountingResource upstream;
+    std::pmr::monotonic_buffer_resource region;
+
+public:
+    class Scope
+    {
+    private:
+        std::pmr::memory_resource *previous;
+
+    public:
+        // A null arena leaves the thread allocating from the heap.
+        explicit Scope(LoadArena *arena);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+
+    LoadArena();
+
+    LoadArena(const LoadArena &) = delete;
+    LoadArena &operator=(const LoadArena &) = delete;
+
+    std::pmr::memory_resource *resource();
+
+    // Bytes the region currently holds from the heap.
+    size_t reservedBytes() const;
+
+    // Where entities constructed on this thread allocate: the arena of the
+    // innermost active Scope, or the default heap resource.
+    static std::pmr::memory_resource *current();
+
+    // Replaces entity with a copy of value allocated from the heap. Plain
+    // assignment keeps entity's allocator, so each update of an entity
+    // loaded into an arena would take new space the arena never frees.
+    // value may be entity itself.
+    template <typename T>
+    static void replace(T &entity, const T &value)
+    {
+        T copy(value); // pmr copies take the default resource
+        entity.~T();
+        new (&entity) T(std::move(copy));
+    }
+};
+
+#endif
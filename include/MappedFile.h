@@ -0,0 +1,41 @@
+﻿#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <string_view>
+
+using std::string;
+using std::string_view;
+
+// Read-only memory mapping of a whole file. The view stays valid until
+// the MappedFile is closed or destroyed.
+class MappedFile
+{
+private:
+    const char *data;
+    size_t length;
+    bool opened;
+#ifdef _WIN32
+    void *fileHandle;
+    void *mappingHandle;
+#else
+    int fd;
+#endif
+
+public:
+    MappedFile();
+    explicit MappedFile(const string &filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const string &filename);
+    void close();
+
+    bool isOpen() const;
+    size_t size() const;
+    string_view view() const;
+};
+
+#endif
@@ -0,0 +1,192 @@
+﻿#ifndef OPERATIONLOG_H
+#define OPERATIONLOG_H
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "FixedId.h"
+
+using std::ofstream;
+using std::string;
+using std::string_view;
+using std::vector;
+
+struct LogEntry
+{
+    char operation; // 'A' add, 'U' update, 'R' remove, 'C' checkpoint
+    string id;      // ID the operation targets (the old ID for updates);
+                    // for a checkpoint, the checksum of the base file
+    string record;  // CSV record in the data file format; empty for removes
+};
+
+// Append-only log of mutations made since the base data file was last
+// rewritten. Each entry is one line: operation, ID and record separated
+// by tabs. A final line without a newline is a torn write and is ignored.
+//
+// Compaction appends a checkpoint holding the checksum of the contents it
+// is about to write, syncs the log, rewrites the base file and then drops
+// the entries up to the checkpoint. If it stops after the rewrite, the base
+// file matches the checkpoint and replay starts after it; otherwise replay
+// starts from the top, so no entry is applied twice.
+class OperationLog
+{
+private:
+    string logFile;
+    size_t entryCount;
+    size_t checkpointEnd; // Entries up to and including the last checkpoint
+    ofstream stream;      // opened by the first append, closed by clear()
+
+    // Index of the first entry baseFile does not already include.
+    size_t firstUnfolded(const vector<LogEntry> &entries, const string &baseFile) const;
+
+public:
+    static const size_t DEFAULT_COMPACTION_THRESHOLD = 512;
+
+    OperationLog(const string &filename);
+
+    bool append(char operation, string_view id, const string &record = "");
+    // Writes every entry and flushes once.
+    bool appendAll(const vector<LogEntry> &entries);
+    vector<LogEntry> readEntries() const;
+    bool clear();
+
+    // Forces appended entries to disk.
+    bool sync();
+
+    // Records that the base file is about to be rewritten with contents.
+    bool checkpoint(const string &contents);
+    // Drops the entries up to the last checkpoint, once its contents are
+    // safely in the base file, keeping any appended since.
+    bool trimToCheckpoint();
+
+    size_t size() const;
+    const string &getFilename() const;
+
+    // Re-applies the logged operations that baseFile, which entities were
+    // loaded from, does not already include, and returns how many.
+    template <typename T, typename ParseFn>
+    size_t replay(vector<T> &entities, ParseFn parse, const string &baseFile) const;
+};
+
+template <typename T, typename ParseFn>
+size_t OperationLog::replay(vector<T> &entities, ParseFn parse, const string &baseFile) const
+{
+    vector<LogEntry> entries = readEntries();
+    entries.erase(entries.begin(), entries.begin() + firstUnfolded(entries, baseFile));
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [](const LogEntry &entry)
+                                 { return entry.operation == 'C'; }),
+                  entries.end());
+
+    // Position of each ID's first row, as a front-to-back search would find
+    // it. Removed rows are only marked, and the list is compacted once at
+    // the end, so replay is linear and keeps the order of the rows.
+    const size_t missing = static_cast<size_t>(-1);
+    std::unordered_map<EntityId, size_t> positions;
+    positions.reserve(entities.size());
+    bool duplicates = false;
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        duplicates = !positions.emplace(entities[i].getId(), i).second || duplicates;
+    }
+    vector<bool> removed(entities.size(), false);
+
+    auto findById = [&positions, missing](const EntityId &id)
+    {
+        auto found = positions.find(id);
+        return found == positions.end() ? missing : found->second;
+    };
+    auto place = [&positions](const EntityId &id, size_t position)
+    {
+        auto [found, added] = positions.emplace(id, position);
+        if (!added && position < found->second)
+        {
+            found->second = position;
+        }
+    };
+    // Drops id's row at position from the lookup; a later duplicate of the
+    // ID, which only files loaded with duplicates have, becomes the match.
+    auto forget = [&](const EntityId &id, size_t position)
+    {
+        positions.erase(id);
+        if (!duplicates)
+        {
+            return;
+        }
+        for (size_t i = 0; i < entities.size(); ++i)
+        {
+            if (i != position && !removed[i] && entities[i].getId() == id)
+            {
+                positions.emplace(id, i);
+                break;
+            }
+        }
+    };
+
+    for (const auto &entry : entries)
+    {
+        EntityId entryId(entry.id);
+        if (entry.operation == 'R')
+        {
+            size_t position = findById(entryId);
+            if (position != missing)
+            {
+                removed[position] = true;
+                forget(entryId, position);
+            }
+            continue;
+        }
+
+        T entity;
+        string error;
+        if (!parse(entry.record, entity, error))
+        {
+            std::cerr << "Error in " << logFile << ": " << error << std::endl;
+            continue;
+        }
+
+        size_t position = findById(entryId);
+        if (position == missing)
+        {
+            position = findById(entity.getId());
+        }
+
+        if (position != missing)
+        {
+            EntityId previousId = entities[position].getId();
+            entities[position] = entity;
+            if (previousId != entity.getId())
+            {
+                forget(previousId, position);
+                place(entity.getId(), position);
+            }
+        }
+        else
+        {
+            place(entity.getId(), entities.size());
+            entities.push_back(entity);
+            removed.push_back(false);
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        if (!removed[i])
+        {
+            if (kept != i)
+            {
+                entities[kept] = std::move(entities[i]);
+            }
+            kept++;
+        }
+    }
+    entities.erase(entities.begin() + kept, entities.end());
+
+    return entries.size();
+}
+
+#endif
@@ -1,7 +1,9 @@
 ﻿#ifndef PASSENGERMENU_H
 #define PASSENGERMENU_H
 
+#include "JourneyPlanner.h"
 #include "RouteManager.h"
+#include "ScheduleManager.h"
 #include <vector>
 
 using std::string;
@@ -11,6 +13,8 @@ class PassengerMenu
 {
 private:
     RouteManager &routeManager;
+    ScheduleManager &scheduleManager;
+    JourneyPlanner planner;
 
     void clearInputBuffer();
     string getInput(const string &prompt);
@@ -21,9 +25,11 @@ private:
     void searchByDestination();
     void searchByStop();
     void viewTravelTime();
+    void planJourney();
+    void viewNextDepartures();
 
 public:
-    PassengerMenu(RouteManager &rm);
+    PassengerMenu(RouteManager &rm, ScheduleManager &sm);
 
     void show();
 
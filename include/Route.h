@@ -2,31 +2,38 @@
 #define ROUTE_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
+#include "FixedId.h"
+#include "LoadArena.h"
+#include "SymbolTable.h"
 
 using std::string;
+using std::string_view;
 using std::vector;
 
 class Route
 {
 private:
-    string id;
-    string origin;
-    string destination;
-    vector<string> keyStops;
+    EntityId id;
+    // Allocated from LoadArena::current()
+    std::pmr::string origin;
+    std::pmr::string destination;
+    std::pmr::vector<Symbol> keyStops; // interned stop names, see SymbolTable
     int estimatedTravelTime;
 
 public:
     Route();
-    Route(const string &id, const string &origin,
-          const string &destination, const vector<string> &keyStops,
+    Route(const string &id, string_view origin,
+          string_view destination, const vector<string> &keyStops,
           int estimatedTravelTime);
 
-    string getId() const;
-    string getOrigin() const;
-    string getDestination() const;
+    const EntityId &getId() const;
+    string_view getOrigin() const;
+    string_view getDestination() const;
     vector<string> getKeyStops() const;
+    const std::pmr::vector<Symbol> &getKeyStopSymbols() const;
     int getEstimatedTravelTime() const;
 
     void setId(const string &id);
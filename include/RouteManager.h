@@ -2,35 +2,112 @@
 #define ROUTEMANAGER_H
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "Route.h"
+#include "FlushScheduler.h"
+#include "IdIndex.h"
+#include "OperationLog.h"
+#include "TravelTimeMatrix.h"
 
 using std::string;
+using std::unordered_map;
 using std::vector;
 
 class RouteManager
 {
+public:
+    // Stays valid while other routes are added and removed; resolving it
+    // after the route itself is removed yields nullptr.
+    using Handle = SlotMap<Route>::Handle;
+
 private:
     vector<Route> &routes;
     string dataFile;
+    OperationLog log;
+    size_t compactionThreshold;
+    FlushScheduler *flusher;
+    size_t flushHandle;
+    mutex compactMutex; // One compaction at a time, so checkpoints land in order
+    SlotMap<Route> slots;
+    IdIndex<Route> index;
+    size_t revision;
+    // Built on the first travel time query, then kept current by every
+    // change and saved to <dataFile>.times whenever the log is compacted.
+    TravelTimeMatrix travelTimes;
+
+    // Route IDs by origin, destination and key stop
+    unordered_map<string, vector<EntityId>> routesByOrigin;
+    unordered_map<string, vector<EntityId>> routesByDestination;
+    unordered_map<string, vector<EntityId>> routesByStop;
+
+    bool persist(char operation, const EntityId &routeId, const Route *route = nullptr);
+    bool persistBatch(const vector<LogEntry> &entries);
+    // The flusher's job: syncs the log, and compacts once it is due.
+    bool commitLog();
+
+    // The checks behind addRoute, updateRoute and removeRoute, which print why a
+    // change is refused, and the unchecked changes they guard. Transaction
+    // runs them for a whole batch under one data lock.
+    bool checkAdd(const Route &newRoute) const;
+    bool checkUpdate(const EntityId &routeId, const Route &updatedRoute) const;
+    bool checkRemove(const EntityId &routeId) const;
+    void applyAdd(const Route &newRoute);
+    void applyUpdate(const EntityId &routeId, const Route &updatedRoute);
+    void applyRemove(const EntityId &routeId);
+
+    friend class Transaction;
+
+    void indexRoute(const Route &route);
+    void unindexRoute(const Route &route);
+    vector<const Route *> resolveRoutes(const unordered_map<string, vector<EntityId>> &lookup,
+                                        const string &key) const;
 
 public:
     RouteManager(vector<Route> &routeList, const string &filename);
 
     bool addRoute(const Route &newRoute);
-    bool updateRoute(const string &routeId, const Route &updatedRoute);
-    bool removeRoute(const string &routeId);
+    bool updateRoute(const EntityId &routeId, const Route &updatedRoute);
+    bool updateRoute(Handle handle, const Route &updatedRoute);
+    bool removeRoute(const EntityId &routeId);
+
+    Route *findRoute(const EntityId &routeId);
+    Handle findRouteHandle(const EntityId &routeId) const;
+    Route *getRoute(Handle handle);
+    bool routeExists(const EntityId &routeId) const;
+
+    // The route list, in slot order; invalidated by the next add, update or
+    // remove, each of which also bumps the revision.
+    const vector<Route> &getRoutes() const;
+    size_t getRevision() const;
 
-    Route *findRoute(const string &routeId);
-    bool routeExists(const string &routeId) const;
+    // Shortest travel time in minutes from one stop to another along chains
+    // of routes, or TravelTimeMatrix::UNREACHABLE. A table lookup once the
+    // matrix is loaded from <dataFile>.times or built.
+    int getTravelTime(const string &fromStop, const string &toStop);
 
     bool saveToFile();
 
+    // Mutations are appended to <dataFile>.log; once the log holds
+    // compactionThreshold entries it is folded back into the data file.
+    // The records are formatted under the flusher's data lock and written
+    // outside it; changes logged meanwhile stay in the log.
+    bool compact();
+    void setCompactionThreshold(size_t entries);
+
+    // Hands durability to a shared group-commit flusher: mutations still go
+    // to the log at once, and after its commit window the flusher syncs the
+    // log, folding it into the data file once it holds compactionThreshold
+    // entries. The scheduler must be destroyed first.
+    void attachFlusher(FlushScheduler &scheduler);
+
     void displayAllRoutes() const;
 
-    vector<Route> findRoutesByOrigin(const string &origin) const;
-    vector<Route> findRoutesByDestination(const string &destination) const;
-    vector<Route> findRoutesByStop(const string &stop) const;
+    // Matches in list order. The pointers refer into the route list and
+    // stay valid until the next add, update or remove.
+    vector<const Route *> findRoutesByOrigin(const string &origin) const;
+    vector<const Route *> findRoutesByDestination(const string &destination) const;
+    vector<const Route *> findRoutesByStop(const string &stop) const;
 
     bool validateRoute(const Route &route) const;
 };
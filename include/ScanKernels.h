@@ -0,0 +1,51 @@
+﻿#ifndef SCANKERNELS_H
+#define SCANKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+// Column scan kernels behind ScheduleStore's queries. Results are selection
+// bitmaps: bit i % 64 of word i / 64 is set when row i matches. AVX2 and SSE2
+// versions are picked at startup from what the CPU supports, with a scalar
+// fallback for other targets.
+class ScanKernels
+{
+public:
+    enum class Level
+    {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+
+    // Best level this CPU and build support.
+    static Level supportedLevel();
+    static Level getLevel();
+    // Forces a lower level (for benchmarks and tests); clamped to supportedLevel().
+    static void setLevel(Level level);
+    static const char *levelName(Level level);
+
+    static size_t wordCount(size_t rows);
+
+    // Overwrites bits[0, wordCount(count)) with values[i] == value.
+    static void selectEqual(const uint32_t *values, size_t count, uint32_t value, uint64_t *bits);
+    // Sets the bits of all count rows.
+    static void selectAll(size_t count, uint64_t *bits);
+
+    // The keep* kernels clear the bits of rows that fail their test. Words
+    // that are already zero are skipped, so they are cheap after a selective
+    // first filter.
+    static void keepEqual(const uint32_t *values, size_t count, uint32_t value, uint64_t *bits);
+
+    // Keeps rows whose value lies in [low, high].
+    static void keepRange(const int16_t *values, size_t count, int16_t low, int16_t high, uint64_t *bits);
+
+    static size_t countSelected(const vector<uint64_t> &bits);
+    // Row numbers of the set bits, in ascending order.
+    static vector<uint32_t> selectedRows(const vector<uint64_t> &bits);
+};
+
+#endif
@@ -1,37 +1,62 @@
 ﻿#ifndef SCHEDULE_H
 #define SCHEDULE_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <iostream>
+#include "FixedId.h"
+#include "SymbolTable.h"
 
 using std::string;
+using std::string_view;
 
 class Schedule
 {
 private:
-    string id;
-    string routeId;
-    string busId;
-    string driverId;
-    string date;
-    string departureTime;
-    string arrivalTime;
+    EntityId id;
+    Symbol routeId;  // interned, see SymbolTable
+    Symbol busId;
+    Symbol driverId;
+    int32_t day;       // days since 1970-01-01
+    int16_t departure; // minutes since midnight
+    int16_t arrival;   // minutes since midnight
 
 public:
+    // Stored when a date or time is empty or cannot be parsed.
+    static constexpr int32_t INVALID_DAY = INT32_MIN;
+    static constexpr int16_t INVALID_TIME = -1;
+
     Schedule();
     Schedule(const string &id, const string &routeId,
              const string &busId, const string &driverId,
              const string &date, const string &departureTime,
              const string &arrivalTime);
+    Schedule(const string &id, const string &routeId,
+             const string &busId, const string &driverId,
+             int32_t day, int16_t departureMinutes, int16_t arrivalMinutes);
+    Schedule(const string &id, Symbol routeId, Symbol busId, Symbol driverId,
+             int32_t day, int16_t departureMinutes, int16_t arrivalMinutes);
+
+    const EntityId &getId() const;
+    const string &getRouteId() const;
+    const string &getBusId() const;
+    const string &getDriverId() const;
 
-    string getId() const;
-    string getRouteId() const;
-    string getBusId() const;
-    string getDriverId() const;
+    // Interned handles of the IDs above; equal handles mean equal IDs.
+    Symbol getRouteSymbol() const;
+    Symbol getBusSymbol() const;
+    Symbol getDriverSymbol() const;
+
+    // Text forms (YYYY-MM-DD, HH:MM), formatted on each call; empty when invalid.
     string getDate() const;
     string getDepartureTime() const;
     string getArrivalTime() const;
 
+    int32_t getDay() const;
+    int16_t getDepartureMinutes() const;
+    int16_t getArrivalMinutes() const;
+
     void setId(const string &id);
     void setRouteId(const string &routeId);
     void setBusId(const string &busId);
@@ -43,6 +68,12 @@ public:
     void display() const;
 
     bool hasTimeOverlap(const Schedule &other) const;
+
+    // YYYY-MM-DD (a real calendar date) and H:MM or HH:MM (00:00 to 23:59).
+    static int32_t parseDate(string_view text);
+    static int16_t parseTime(string_view text);
+    static string formatDate(int32_t day);
+    static string formatTime(int16_t minutes);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,9 +1,21 @@
 ﻿#ifndef SCHEDULEMANAGER_H
 #define SCHEDULEMANAGER_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "Schedule.h"
+#include "AssignmentPlanner.h"
+#include "AvailabilityIndex.h"
+#include "DepartureBoard.h"
+#include "FlushScheduler.h"
+#include "IdIndex.h"
+#include "IntervalIndex.h"
+#include "OperationLog.h"
+#include "ScheduleQuery.h"
+#include "ScheduleStore.h"
+#include "ScheduleView.h"
+#include "TimetableAudit.h"
 #include "Route.h"
 #include "Bus.h"
 #include "Driver.h"
@@ -11,14 +23,78 @@
 using std::string;
 using std::vector;
 
+class RouteManager;
+class BusManager;
+class DriverManager;
+
 class ScheduleManager
 {
+public:
+    // Stays valid while other schedules are added and removed; resolving it
+    // after the schedule itself is removed yields nullptr.
+    using Handle = SlotMap<Schedule>::Handle;
+
 private:
     vector<Schedule> &schedules;
     vector<Route> &routes;
     vector<Bus> &buses;
     vector<Driver> &drivers;
     string dataFile;
+    OperationLog log;
+    size_t compactionThreshold;
+    FlushScheduler *flusher;
+    size_t flushHandle;
+    mutex compactMutex; // One compaction at a time, so checkpoints land in order
+    SlotMap<Schedule> slots;
+    IdIndex<Schedule> index;
+    size_t revision;
+    ScheduleStore store;
+    IntervalIndex busIntervals;
+    IntervalIndex driverIntervals;
+    // Built on the first departure query, then kept current by every
+    // change; rebuilt when the route manager's revision moves on.
+    DepartureBoard departures;
+    size_t departureRouteRevision;
+    // Minute occupancy by bus and by driver, built on the first
+    // free-resource query and then kept current by every change. The
+    // rosters are redrawn when the bus or driver manager's revision moves on.
+    AvailabilityIndex busAvailability;
+    AvailabilityIndex driverAvailability;
+    bool availabilityBuilt;
+    size_t busRosterRevision;
+    size_t driverRosterRevision;
+    // Rows with an unreadable date or time: counted on load, then kept
+    // current by applyAdd, applyUpdate and applyRemove.
+    size_t unreadableCount;
+    bool unreadableWarned;
+    string recordBuffer; // Reused by persist, so logging a change does not allocate
+    const RouteManager *routeLookup;
+    const BusManager *busLookup;
+    const DriverManager *driverLookup;
+
+    bool persist(char operation, const EntityId &scheduleId, const Schedule *schedule = nullptr);
+    bool persistBatch(const vector<LogEntry> &entries);
+    // The flusher's job: syncs the log, and compacts once it is due.
+    bool commitLog();
+
+    // The checks behind addSchedule, updateSchedule and removeSchedule, which print why a
+    // change is refused, and the unchecked changes they guard. Transaction
+    // runs them for a whole batch under one data lock.
+    bool checkAdd(const Schedule &newSchedule) const;
+    bool checkUpdate(const EntityId &scheduleId, const Schedule &updatedSchedule) const;
+    bool checkRemove(const EntityId &scheduleId) const;
+    void applyAdd(const Schedule &newSchedule);
+    void applyUpdate(const EntityId &scheduleId, const Schedule &updatedSchedule);
+    void applyRemove(const EntityId &scheduleId);
+
+    friend class Transaction;
+
+    void indexIntervals(const Schedule &schedule);
+    void unindexIntervals(const Schedule &schedule);
+
+    // Interned IDs of the Active buses and of all drivers, in list order.
+    vector<Symbol> activeBusRoster() const;
+    vector<Symbol> driverRoster() const;
 
 public:
     ScheduleManager(vector<Schedule> &scheduleList,
@@ -27,25 +103,90 @@ public:
                     vector<Driver> &driverList,
                     const string &filename);
 
+    // Reference checks ask these managers' ID indexes instead of scanning
+    // the route, bus and driver lists.
+    void setReferenceLookups(const RouteManager &routeManager, const BusManager &busManager,
+                             const DriverManager &driverManager);
+
     bool addSchedule(const Schedule &newSchedule);
-    bool updateSchedule(const string &scheduleId, const Schedule &updatedSchedule);
-    bool removeSchedule(const string &scheduleId);
+    bool updateSchedule(const EntityId &scheduleId, const Schedule &updatedSchedule);
+    bool updateSchedule(Handle handle, const Schedule &updatedSchedule);
+    bool removeSchedule(const EntityId &scheduleId);
+
+    Schedule *findSchedule(const EntityId &scheduleId);
+    Handle findScheduleHandle(const EntityId &scheduleId) const;
+    Schedule *getSchedule(Handle handle);
+    bool scheduleExists(const EntityId &scheduleId) const;
 
-    Schedule *findSchedule(const string &scheduleId);
-    bool scheduleExists(const string &scheduleId) const;
-    vector<Schedule> getSchedulesByDriver(const string &driverId) const;
-    vector<Schedule> getSchedulesByDate(const string &date) const;
-    vector<Schedule> getSchedulesByBus(const string &busId) const;
+    // The schedule list, in slot order; invalidated by the next add, update or
+    // remove, each of which also bumps the revision.
+    const vector<Schedule> &getSchedules() const;
+    size_t getRevision() const;
 
+    // Queries return views into the schedule list rather than copies; a view
+    // is invalidated by the next add, update or remove.
+    ScheduleView getSchedulesByDriver(const string &driverId) const;
+    ScheduleView getSchedulesByDate(const string &date) const;
+    ScheduleView getSchedulesByBus(const string &busId) const;
+    ScheduleView findSchedules(const ScheduleQuery &query) const;
+
+    // Columnar copy of the schedule list that the getSchedulesBy* scans run over.
+    const ScheduleStore &getStore() const;
+
+    // Every pair of schedules that double-books a bus or driver, including
+    // rows loaded from the data file, which the add and update checks never
+    // see against each other.
+    TimetableAudit::Report auditTimetable(unsigned threadCount = 0) const;
+
+    // The first count departures from a stop at or after the given day and
+    // minute, earliest first. Resolve them with getSchedule before the next
+    // add, update or remove.
+    vector<DepartureBoard::Departure> getNextDepartures(const string &stop, int32_t day, int16_t minute,
+                                                        size_t count);
+
+    // Active buses and all drivers with nothing scheduled in [start, end) on
+    // the day, as interned IDs in list order.
+    void findFreeResources(int32_t day, int16_t start, int16_t end, vector<Symbol> &freeBuses,
+                           vector<Symbol> &freeDrivers);
+
+    // Buses and drivers for trips whose bus and driver IDs are ignored,
+    // planned around the schedules already in the list. Nothing is added;
+    // stage report.assigned in a Transaction to commit them together.
+    AssignmentPlanner::Report planAssignments(const vector<Schedule> &trips, unsigned threadCount = 0) const;
+
+    // Rows loaded with an unreadable date or time. While there are any the
+    // data file is not rewritten, so the original text is not lost.
+    size_t unreadableRows() const;
+
+    // Refuses, leaving the file as it is, while unreadableRows() is nonzero.
     bool saveToFile();
 
+    // Mutations are appended to <dataFile>.log; once the log holds
+    // compactionThreshold entries it is folded back into the data file.
+    // The records are formatted under the flusher's data lock and written
+    // outside it; changes logged meanwhile stay in the log.
+    bool compact();
+    void setCompactionThreshold(size_t entries);
+
+    // Hands durability to a shared group-commit flusher: mutations still go
+    // to the log at once, and after its commit window the flusher syncs the
+    // log, folding it into the data file once it holds compactionThreshold
+    // entries. The scheduler must be destroyed first.
+    void attachFlusher(FlushScheduler &scheduler);
+
     void displayAllSchedules() const;
+    void displaySchedules(const ScheduleView &view) const;
     void displaySchedule(const Schedule &schedule) const;
+    void displayConflictReport(const TimetableAudit::Report &report) const;
+    void displayDepartures(const string &stop, const vector<DepartureBoard::Departure> &upcoming) const;
+    void displayFreeResources(const vector<Symbol> &freeBuses, const vector<Symbol> &freeDrivers,
+                              size_t limit = SIZE_MAX) const;
+    void displayAssignmentReport(const AssignmentPlanner::Report &report) const;
 
     bool validateSchedule(const Schedule &schedule) const;
     bool hasValidReferences(const Schedule &schedule) const;
-    bool hasBusOverlap(const Schedule &schedule, const string &excludeScheduleId = "") const;
-    bool hasDriverOverlap(const Schedule &schedule, const string &excludeScheduleId = "") const;
+    bool hasBusOverlap(const Schedule &schedule, const EntityId &excludeScheduleId = "") const;
+    bool hasDriverOverlap(const Schedule &schedule, const EntityId &excludeScheduleId = "") const;
 };
 
 #endif 
\ No newline at end of file
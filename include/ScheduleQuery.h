@@ -0,0 +1,56 @@
+﻿#ifndef SCHEDULEQUERY_H
+#define SCHEDULEQUERY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ScheduleStore.h"
+#include "SymbolTable.h"
+
+using std::string;
+using std::vector;
+
+// A conjunction of schedule filters, e.g.
+//     ScheduleQuery().driver("D101").date("2025-12-15")
+// evaluated over a ScheduleStore in one pass: the first filter scans its
+// column and each further filter only reads the 64-row blocks that still
+// have a match. An unknown ID or an unparsable date or time matches nothing.
+class ScheduleQuery
+{
+public:
+    ScheduleQuery &route(const string &routeId);
+    ScheduleQuery &bus(const string &busId);
+    ScheduleQuery &driver(const string &driverId);
+    ScheduleQuery &date(const string &date);
+    // Departure between fromTime and toTime, both inclusive.
+    ScheduleQuery &departingBetween(const string &fromTime, const string &toTime);
+
+    ScheduleStore::Bitmap match(const ScheduleStore &store) const;
+    ScheduleStore::RowList select(const ScheduleStore &store) const;
+
+private:
+    enum class Column
+    {
+        ROUTE,
+        BUS,
+        DRIVER,
+        DAY
+    };
+
+    struct Equality
+    {
+        Column column;
+        uint32_t value;
+    };
+
+    vector<Equality> equalities;
+    bool hasWindow = false;
+    int16_t windowFrom = 0;
+    int16_t windowTo = 0;
+    bool matchesNothing = false;
+
+    ScheduleQuery &symbolEquals(Column column, const string &id);
+    static const uint32_t *columnData(const ScheduleStore &store, Column column);
+};
+
+#endif
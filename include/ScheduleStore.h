@@ -0,0 +1,66 @@
+﻿#ifndef SCHEDULESTORE_H
+#define SCHEDULESTORE_H
+
+#include <cstdint>
+#include <vector>
+#include "Schedule.h"
+#include "SymbolTable.h"
+
+using std::vector;
+
+// Packed columns of the schedule fields that scans filter on: interned
+// route, bus and driver IDs, day numbers and departure/arrival minutes
+// (20 bytes per schedule). Row i mirrors slot i of the owning manager's
+// schedule list, which stays the row view used for display and saving.
+class ScheduleStore
+{
+public:
+    // Matching row numbers, in ascending order.
+    using RowList = vector<uint32_t>;
+    // Bit i % 64 of word i / 64 is set when row i matches (see ScanKernels).
+    using Bitmap = vector<uint64_t>;
+
+    void rebuild(const vector<Schedule> &schedules);
+    void append(const Schedule &schedule);
+    void assign(size_t row, const Schedule &schedule);
+    // Moves the last row into row, matching the manager's slot map.
+    void erase(size_t row);
+    void reserve(size_t rows);
+
+    size_t size() const;
+
+    const vector<Symbol> &routeColumn() const;
+    const vector<Symbol> &busColumn() const;
+    const vector<Symbol> &driverColumn() const;
+    const vector<int32_t> &dayColumn() const;
+    const vector<int16_t> &departureColumn() const;
+    const vector<int16_t> &arrivalColumn() const;
+
+    // Single-column equality scans. Each runs the SIMD kernels over one
+    // packed column, so the scan never touches the other fields.
+    Bitmap matchRoute(Symbol route) const;
+    Bitmap matchBus(Symbol bus) const;
+    Bitmap matchDriver(Symbol driver) const;
+    Bitmap matchDay(int32_t day) const;
+
+    // Rows on day whose departure lies in [from, to], in minutes since
+    // midnight. The departure column is only read for words with a match
+    // on the day.
+    Bitmap matchDepartingBetween(int32_t day, int16_t from, int16_t to) const;
+
+    RowList selectByRoute(Symbol route) const;
+    RowList selectByBus(Symbol bus) const;
+    RowList selectByDriver(Symbol driver) const;
+    RowList selectByDay(int32_t day) const;
+    RowList selectDepartingBetween(int32_t day, int16_t from, int16_t to) const;
+
+private:
+    vector<Symbol> routes;
+    vector<Symbol> buses;
+    vector<Symbol> drivers;
+    vector<int32_t> days;
+    vector<int16_t> departures;
+    vector<int16_t> arrivals;
+};
+
+#endif
@@ -0,0 +1,57 @@
+﻿#ifndef SCHEDULEVIEW_H
+#define SCHEDULEVIEW_H
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include "Schedule.h"
+#include "ScheduleStore.h"
+
+using std::vector;
+
+// Read-only view of some rows of a schedule list: it holds row numbers, not
+// copies. Like an iterator, it is invalidated when the list is modified.
+class ScheduleView
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Schedule;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Schedule *;
+        using reference = const Schedule &;
+
+        Iterator(const ScheduleView *view, size_t position);
+
+        reference operator*() const;
+        pointer operator->() const;
+        Iterator &operator++();
+        Iterator operator++(int);
+        bool operator==(const Iterator &other) const;
+        bool operator!=(const Iterator &other) const;
+
+    private:
+        const ScheduleView *view;
+        size_t position;
+    };
+
+    ScheduleView();
+    // Every row of the list, in order.
+    explicit ScheduleView(const vector<Schedule> &schedules);
+    ScheduleView(const vector<Schedule> &schedules, ScheduleStore::RowList rows);
+
+    size_t size() const;
+    bool empty() const;
+    const Schedule &operator[](size_t position) const;
+    Iterator begin() const;
+    Iterator end() const;
+
+private:
+    const vector<Schedule> *schedules;
+    ScheduleStore::RowList rows;
+    bool allRows;
+};
+
+#endif
@@ -0,0 +1,173 @@
+﻿#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using std::vector;
+
+// Generational slot map over a manager's entity vector. The vector stays
+// dense, so scans and saves are unchanged; a Handle names a slot and the
+// generation it was issued in. Erasing moves the last entity into the gap
+// and bumps the slot's generation, so insert and erase are O(1) and a
+// handle to an erased entity resolves to nullptr instead of to whatever
+// now sits at its old position.
+template <typename T>
+class SlotMap
+{
+public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    struct Handle
+    {
+        uint32_t slot = npos;
+        uint32_t generation = 0;
+
+        bool isNull() const
+        {
+            return slot == npos;
+        }
+
+        bool operator==(const Handle &other) const
+        {
+            return slot == other.slot && generation == other.generation;
+        }
+
+        bool operator!=(const Handle &other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+private:
+    // While live, index is the entity's position in the vector; while
+    // free, it is the next slot on the free list.
+    struct Slot
+    {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    vector<T> &entities;
+    vector<Slot> slots;
+    vector<uint32_t> owners;
+    uint32_t freeHead;
+
+    Handle issue(uint32_t position)
+    {
+        uint32_t slot = freeHead;
+        if (slot == npos)
+        {
+            slot = static_cast<uint32_t>(slots.size());
+            slots.push_back(Slot{position, 0});
+        }
+        else
+        {
+            freeHead = slots[slot].index;
+            slots[slot].index = position;
+        }
+        owners.push_back(slot);
+        return Handle{slot, slots[slot].generation};
+    }
+
+public:
+    explicit SlotMap(vector<T> &entityList) : entities(entityList), freeHead(npos)
+    {
+        rebuild();
+    }
+
+    // Re-issues a handle for every entity after the vector was changed
+    // behind the map's back (log replay, reload). Outstanding handles go stale.
+    void rebuild()
+    {
+        for (Slot &slot : slots)
+        {
+            ++slot.generation;
+        }
+        owners.clear();
+        owners.reserve(entities.size());
+
+        // Reuse slots in ascending order so handles stay small.
+        freeHead = npos;
+        for (size_t i = slots.size(); i-- > 0;)
+        {
+            slots[i].index = freeHead;
+            freeHead = static_cast<uint32_t>(i);
+        }
+        for (size_t i = 0; i < entities.size(); ++i)
+        {
+            issue(static_cast<uint32_t>(i));
+        }
+    }
+
+    Handle insert(const T &entity)
+    {
+        entities.push_back(entity);
+        return issue(static_cast<uint32_t>(entities.size() - 1));
+    }
+
+    // Moves the last entity into the erased position. Returns false for a
+    // stale handle.
+    bool erase(Handle handle)
+    {
+        if (!contains(handle))
+        {
+            return false;
+        }
+
+        uint32_t position = slots[handle.slot].index;
+        uint32_t last = static_cast<uint32_t>(entities.size() - 1);
+        if (position != last)
+        {
+            entities[position] = std::move(entities[last]);
+            owners[position] = owners[last];
+            slots[owners[position]].index = position;
+        }
+        entities.pop_back();
+        owners.pop_back();
+
+        Slot &slot = slots[handle.slot];
+        ++slot.generation;
+        slot.index = freeHead;
+        freeHead = handle.slot;
+        return true;
+    }
+
+    bool contains(Handle handle) const
+    {
+        // Freeing a slot bumps its generation, so a matching generation
+        // means the slot is live and still holds the same entity.
+        return handle.slot < slots.size() && slots[handle.slot].generation == handle.generation;
+    }
+
+    T *get(Handle handle)
+    {
+        return contains(handle) ? &entities[slots[handle.slot].index] : nullptr;
+    }
+
+    const T *get(Handle handle) const
+    {
+        return contains(handle) ? &entities[slots[handle.slot].index] : nullptr;
+    }
+
+    // Position of the entity in the vector, or npos for a stale handle.
+    // Positions change when another entity is erased; handles do not.
+    uint32_t indexOf(Handle handle) const
+    {
+        return contains(handle) ? slots[handle.slot].index : npos;
+    }
+
+    Handle handleAt(size_t position) const
+    {
+        uint32_t slot = owners[position];
+        return Handle{slot, slots[slot].generation};
+    }
+
+    size_t size() const
+    {
+        return owners.size();
+    }
+};
+
+#endif
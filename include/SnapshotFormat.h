@@ -0,0 +1,70 @@
+﻿#ifndef SNAPSHOTFORMAT_H
+#define SNAPSHOTFORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+// Binary snapshot layout shared by DataSaver::saveSnapshot and
+// DataLoader::loadSnapshot. All integers are little-endian.
+//
+//   header   magic "BMSS", version, payload size, payload checksum,
+//            then size and modification time of every source text file
+//   payload  string table (count, then length-prefixed bytes)
+//            buses, drivers, routes, schedules, users: each a row count
+//            followed by fixed-width columns; text columns hold
+//            string-table indexes, schedule dates hold day numbers and
+//            schedule times hold departure << 16 | arrival minutes
+namespace SnapshotFormat
+{
+    const char MAGIC[4] = {'B', 'M', 'S', 'S'};
+    const uint32_t VERSION = 2;
+
+    struct SourceStamp
+    {
+        uint64_t size;
+        int64_t modified;
+    };
+
+    // Stamp of a source file, or false if it cannot be read.
+    bool stampFile(const string &filename, SourceStamp &stamp);
+
+    // FNV-1a over 64-bit words, used to detect truncated or corrupt payloads.
+    uint64_t checksum(string_view bytes);
+
+    inline void putU32(string &out, uint32_t value)
+    {
+        char bytes[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+        out.append(bytes, 4);
+    }
+
+    inline void putU64(string &out, uint64_t value)
+    {
+        putU32(out, static_cast<uint32_t>(value));
+        putU32(out, static_cast<uint32_t>(value >> 32));
+    }
+
+    inline uint32_t getU32(const char *in)
+    {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(in);
+        return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+               (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    inline uint64_t getU64(const char *in)
+    {
+        return static_cast<uint64_t>(getU32(in)) | (static_cast<uint64_t>(getU32(in + 4)) << 32);
+    }
+}
+
+#endif
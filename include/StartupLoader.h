@@ -0,0 +1,50 @@
+﻿#ifndef STARTUPLOADER_H
+#define STARTUPLOADER_H
+
+#include <string>
+#include <vector>
+#include "SystemData.h"
+
+using std::string;
+using std::vector;
+
+// Loads the five data files concurrently. Loader output is buffered per
+// file and printed in a fixed order once every file has been joined.
+// With a snapshot file set, a fresh snapshot is loaded instead and a
+// stale or missing one is rewritten after the text files are loaded.
+// With arena loading on, each file's entities allocate their text fields
+// and stop lists from a LoadArena that the returned SystemData owns.
+class StartupLoader
+{
+private:
+    struct FileTiming
+    {
+        string filename;
+        double milliseconds;
+    };
+
+    string busesFile;
+    string driversFile;
+    string routesFile;
+    string schedulesFile;
+    string credentialsFile;
+    string snapshotFile;
+    bool arenaLoading;
+
+    vector<FileTiming> timings;
+    double totalMilliseconds;
+
+public:
+    StartupLoader(const string &buses, const string &drivers, const string &routes,
+                  const string &schedules, const string &credentials);
+
+    void setSnapshotFile(const string &filename);
+    void setArenaLoading(bool enabled);
+    vector<string> getSourceFiles() const;
+
+    SystemData loadAll();
+
+    void displayTimings() const;
+};
+
+#endif
@@ -0,0 +1,40 @@
+﻿#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using std::string;
+using std::string_view;
+
+// 32-bit handle for an interned string. Equal strings share one handle, so
+// comparing handles is the same as comparing the text.
+using Symbol = uint32_t;
+
+// Process-wide table of interned IDs, stop names and statuses. Entries are
+// never removed, and the string behind a handle never moves, so references
+// returned by name() stay valid for the life of the program. Safe to use
+// from several threads (the parallel loader interns concurrently).
+class SymbolTable
+{
+public:
+    // Handle of the empty string.
+    static constexpr Symbol EMPTY = 0;
+
+    static Symbol intern(string_view text);
+
+    // Looks text up without adding it; false if it was never interned.
+    static bool find(string_view text, Symbol &symbol);
+
+    static const string &name(Symbol symbol);
+
+    static size_t size();
+
+    // Approximate bytes held by the table: string slots, text stored
+    // outside the strings themselves, and hash entries.
+    static size_t memoryUsage();
+};
+
+#endif
@@ -0,0 +1,45 @@
+﻿#ifndef SYSTEMDATA_H
+#define SYSTEMDATA_H
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Bus.h"
+#include "Driver.h"
+#include "LoadArena.h"
+#include "Route.h"
+#include "Schedule.h"
+#include "User.h"
+
+using std::unique_ptr;
+using std::vector;
+
+struct SystemData
+{
+    // Regions the entities were loaded into, if StartupLoader's arena
+    // loading was on. Declared first so they are destroyed last.
+    vector<unique_ptr<LoadArena>> arenas;
+    vector<Bus> buses;
+    vector<Driver> drivers;
+    vector<Route> routes;
+    vector<Schedule> schedules;
+    vector<User> users;
+
+    SystemData() = default;
+    SystemData(SystemData &&) = default;
+
+    // Member-wise assignment would free the old arenas before the old
+    // entities; swapping leaves them to be destroyed together with other.
+    SystemData &operator=(SystemData &&other) noexcept
+    {
+        arenas.swap(other.arenas);
+        buses.swap(other.buses);
+        drivers.swap(other.drivers);
+        routes.swap(other.routes);
+        schedules.swap(other.schedules);
+        users.swap(other.users);
+        return *this;
+    }
+};
+
+#endif
@@ -26,11 +26,28 @@ private:
     // Individual test methods
     bool testDataLoading();
     bool testBusValidation(BusManager &busManager);
+    bool testOperationLog(BusManager &busManager);
+    bool testGroupCommit();
+    bool testIdIndex(BusManager &busManager);
     bool testDriverValidation(DriverManager &driverManager);
     bool testRouteValidation(RouteManager &routeManager);
+    bool testRouteSearchIndexes(RouteManager &routeManager);
     bool testScheduleValidation(ScheduleManager &scheduleManager);
+    bool testScheduleEncoding();
+    bool testSymbolTable();
+    bool testFixedId(BusManager &busManager);
     bool testScheduleOverlap(ScheduleManager &scheduleManager);
+    bool testIntervalIndex();
+    bool testScheduleStore();
+    bool testTimetableAudit();
+    bool testJourneyPlanner();
+    bool testTravelTimeMatrix();
+    bool testScanKernels();
     bool testAuthentication(LoginManager &loginManager);
+    bool testTransactions(RouteManager &rm, BusManager &bm, DriverManager &dm, ScheduleManager &sm);
+    bool testDepartureBoard(RouteManager &rm, BusManager &bm, DriverManager &dm, ScheduleManager &sm);
+    bool testAvailabilityIndex(RouteManager &rm, BusManager &bm, DriverManager &dm, ScheduleManager &sm);
+    bool testAssignmentPlanner(RouteManager &rm, BusManager &bm, DriverManager &dm, ScheduleManager &sm);
     bool testCRUDOperations(RouteManager &rm, BusManager &bm, DriverManager &dm, ScheduleManager &sm);
     bool testEdgeCases(RouteManager &rm, BusManager &bm, DriverManager &dm, ScheduleManager &sm);
 
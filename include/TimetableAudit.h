@@ -0,0 +1,57 @@
+﻿#ifndef TIMETABLEAUDIT_H
+#define TIMETABLEAUDIT_H
+
+#include <cstdint>
+#include <vector>
+#include "FixedId.h"
+#include "Schedule.h"
+#include "ScheduleStore.h"
+#include "SymbolTable.h"
+
+using std::vector;
+
+// Checks a whole timetable for double-booked buses and drivers. Rows are
+// bucketed by date, and each date is sorted by (resource, departure) and
+// swept once, so the audit is O(n log n) plus one step per conflict found.
+// Dates are shared out across worker threads. Every overlapping pair is
+// reported, using the same test as Schedule::hasTimeOverlap.
+class TimetableAudit
+{
+public:
+    enum class Resource
+    {
+        Bus,
+        Driver
+    };
+
+    struct Conflict
+    {
+        Resource kind;
+        Symbol resource;
+        int32_t day;
+        // first departs no later than second.
+        EntityId first;
+        EntityId second;
+        // Minutes both schedules hold the resource.
+        int16_t overlapStart;
+        int16_t overlapEnd;
+    };
+
+    struct Report
+    {
+        // Bus conflicts, then driver conflicts, each by date, resource and
+        // overlap start.
+        vector<Conflict> conflicts;
+        size_t schedulesChecked = 0;
+        size_t datesChecked = 0;
+
+        size_t count(Resource kind) const;
+        bool clean() const;
+    };
+
+    // A threadCount of 0 uses one thread per hardware thread.
+    static Report run(const vector<Schedule> &schedules, const ScheduleStore &store,
+                      unsigned threadCount = 0);
+};
+
+#endif
@@ -0,0 +1,103 @@
+﻿#ifndef TRANSACTION_H
+#define TRANSACTION_H
+
+#include <string>
+#include <vector>
+#include "BusManager.h"
+#include "DriverManager.h"
+#include "OperationLog.h"
+#include "RouteManager.h"
+#include "ScheduleManager.h"
+
+using std::string;
+using std::vector;
+
+// Stages adds, updates and removes across the four managers and applies
+// them all or none. commit() runs each change's usual checks in staging
+// order against the data as changed by the ones before it, so a schedule
+// may use a bus added earlier in the batch and two staged schedules that
+// double-book a driver are caught. If every change passes, each manager
+// appends its share to its log in one write; otherwise the applied changes
+// are undone in reverse and nothing is written.
+class Transaction
+{
+public:
+    Transaction(RouteManager &routeManager, BusManager &busManager, DriverManager &driverManager,
+                ScheduleManager &scheduleManager);
+
+    void addRoute(const Route &route);
+    void updateRoute(const EntityId &routeId, const Route &route);
+    void removeRoute(const EntityId &routeId);
+
+    void addBus(const Bus &bus);
+    void updateBus(const EntityId &busId, const Bus &bus);
+    void removeBus(const EntityId &busId);
+
+    void addDriver(const Driver &driver);
+    void updateDriver(const EntityId &driverId, const Driver &driver);
+    void removeDriver(const EntityId &driverId);
+
+    void addSchedule(const Schedule &schedule);
+    void updateSchedule(const EntityId &scheduleId, const Schedule &schedule);
+    void removeSchedule(const EntityId &scheduleId);
+
+    // Empties the staged list whether or not the commit succeeds.
+    bool commit();
+    void clear();
+
+    size_t size() const;
+
+private:
+    enum class Target
+    {
+        Route,
+        Bus,
+        Driver,
+        Schedule
+    };
+
+    struct Change
+    {
+        Target target;
+        char operation; // 'A' add, 'U' update, 'R' remove, as in the log
+        EntityId id;    // ID the change targets (the old ID for updates)
+        size_t value;   // Position in the lane's values; unused for removes
+    };
+
+    // One manager's staged values, the entities its applied changes
+    // replaced or removed, and the log entries for both directions.
+    template <typename Manager, typename T>
+    struct Lane
+    {
+        Manager &manager;
+        vector<T> values;
+        vector<T> previous;
+        vector<LogEntry> entries;
+        vector<LogEntry> undoEntries;
+
+        explicit Lane(Manager &owner) : manager(owner) {}
+    };
+
+    Lane<RouteManager, Route> routes;
+    Lane<BusManager, Bus> buses;
+    Lane<DriverManager, Driver> drivers;
+    Lane<ScheduleManager, Schedule> schedules;
+    vector<Change> staged;
+
+    template <typename Manager, typename T>
+    void stage(Lane<Manager, T> &lane, Target target, char operation, const EntityId &id, const T *value);
+
+    template <typename Fn>
+    auto visit(Target target, Fn fn);
+
+    template <typename Manager, typename T>
+    static bool apply(Lane<Manager, T> &lane, const Change &change, Change &undo);
+
+    template <typename Manager, typename T>
+    static void revert(Lane<Manager, T> &lane, const Change &undo);
+
+    template <typename Manager, typename T>
+    static void resetLane(Lane<Manager, T> &lane);
+};
+
+#endif
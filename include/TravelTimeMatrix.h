@@ -0,0 +1,101 @@
+﻿#ifndef TRAVELTIMEMATRIX_H
+#define TRAVELTIMEMATRIX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Route.h"
+#include "SymbolTable.h"
+
+using std::string;
+using std::string_view;
+using std::unordered_map;
+using std::vector;
+
+// Shortest travel time between every ordered pair of stops over the route
+// graph: each route links its origin, key stops and destination in order,
+// with its estimated travel time spread evenly over the hops as the journey
+// planner does. Filled by one Dijkstra search per origin stop, spread over
+// worker threads, since the graph is sparse. Route changes are recorded as
+// they happen and applied together by refresh, which recomputes only the
+// origins whose shortest paths they can touch.
+//
+// File layout (little-endian): magic "BMTT", version, stop count, routes
+// fingerprint, payload checksum, then stop names (length-prefixed) and the
+// row-major matrix of 32-bit minutes.
+class TravelTimeMatrix
+{
+public:
+    static constexpr int32_t UNREACHABLE = -1;
+
+    void build(const vector<Route> &routes, unsigned threadCount = 0);
+
+    // Notes that a route changed from before to after, leaving the matrix
+    // stale until refresh; before is null for an added route and after for
+    // a removed one. Does nothing while the matrix is not built.
+    void recordChange(const Route *before, const Route *after);
+    // Applies the recorded changes, whose results are in routes. A stop new
+    // to the matrix changes its shape and rebuilds it. Returns the number
+    // of origin rows recomputed.
+    size_t refresh(const vector<Route> &routes, unsigned threadCount = 0);
+    bool isStale() const;
+
+    // recordChange followed by refresh.
+    size_t update(const vector<Route> &routes, const Route *before, const Route *after,
+                  unsigned threadCount = 0);
+
+    // Minutes from one stop to another, UNREACHABLE if no route chain links
+    // them or either stop is unknown. Zero from a stop to itself.
+    int32_t travelTime(string_view from, string_view to) const;
+
+    bool save(const string &filename, const vector<Route> &routes) const;
+    // The file contents save writes.
+    string encode(const vector<Route> &routes) const;
+    // False if the file is missing, corrupt or was built from other routes.
+    bool load(const string &filename, const vector<Route> &routes);
+
+    // Order-independent hash of the routes the matrix was built from.
+    static uint64_t fingerprint(const vector<Route> &routes);
+
+    bool isBuilt() const;
+    size_t stopCount() const;
+
+private:
+    struct Edge
+    {
+        uint32_t from;
+        uint32_t to;
+        int32_t minutes;
+    };
+
+    // A route hop between interned stop names, before it is mapped to
+    // matrix rows.
+    struct Hop
+    {
+        Symbol from;
+        Symbol to;
+        int32_t minutes;
+    };
+
+    vector<Symbol> stopNames;
+    unordered_map<Symbol, uint32_t> stopIndex;
+    // Outgoing edges of stop s: edges[edgeStart[s], edgeStart[s + 1]).
+    vector<uint32_t> edgeStart;
+    vector<Edge> edges;
+    vector<int32_t> times;
+    bool built = false;
+    // Hops of recorded changes not yet applied by refresh.
+    vector<Hop> pendingRemoved;
+    vector<Hop> pendingAdded;
+
+    static void routeHops(const Route &route, vector<Hop> &out);
+    // False if a hop visits a stop the matrix does not know.
+    bool hopEdges(const vector<Hop> &hops, vector<Edge> &out) const;
+    void indexStops(const vector<Route> &routes);
+    void buildEdges(const vector<Route> &routes);
+    void computeRows(const vector<uint32_t> &origins, unsigned threadCount);
+};
+
+#endif
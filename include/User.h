@@ -24,8 +24,8 @@ public:
     User();
     User(const string &username, const string &password, UserRole role);
 
-    string getUsername() const;
-    string getPassword() const;
+    const string &getUsername() const;
+    const string &getPassword() const;
     UserRole getRole() const;
     string getRoleString() const;
 
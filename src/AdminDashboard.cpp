@@ -1,4 +1,6 @@
 ﻿#include "../include/AdminDashboard.h"
+#include "../include/DataLoader.h"
+#include "../include/Transaction.h"
 #include <cstdlib>
 #include <iostream>
 #include <limits>
@@ -331,8 +333,8 @@ void AdminDashboard::updateRoute()
     clearInputBuffer();
     string id = getInput("Enter Route ID to update: ");
 
-    Route *route = routeManager.findRoute(id);
-    if (!route)
+    RouteManager::Handle handle = routeManager.findRouteHandle(id);
+    if (!routeManager.getRoute(handle))
     {
         cout << "Route not found." << endl;
         return;
@@ -356,40 +358,41 @@ void AdminDashboard::updateRoute()
         return;
     }
 
-    if (!origin.empty())
-    {
-        if (validateNotEmpty(origin, "Origin"))
-            route->setOrigin(origin);
-        else
-            return;
-    }
-    if (!destination.empty())
-    {
-        if (validateNotEmpty(destination, "Destination"))
-            route->setDestination(destination);
-        else
-            return;
-    }
-    if (!stopsInput.empty())
+    if (!origin.empty() && !validateNotEmpty(origin, "Origin"))
+        return;
+    if (!destination.empty() && !validateNotEmpty(destination, "Destination"))
+        return;
+
+    vector<string> stops;
+    stringstream ss(stopsInput);
+    string stop;
+    while (getline(ss, stop, '|'))
     {
-        vector<string> stops;
-        stringstream ss(stopsInput);
-        string stop;
-        while (getline(ss, stop, '|'))
+        string trimmedStop = trim(stop);
+        if (!trimmedStop.empty())
         {
-            string trimmedStop = trim(stop);
-            if (!trimmedStop.empty())
-            {
-                stops.push_back(trimmedStop);
-            }
+            stops.push_back(trimmedStop);
         }
-        if (!stops.empty())
-            route->setKeyStops(stops);
     }
+
+    // Edit a copy: the manager re-indexes the stored route from its old values.
+    const Route *route = routeManager.getRoute(handle);
+    if (!route)
+    {
+        cout << "Route no longer exists." << endl;
+        return;
+    }
+    Route updated = *route;
+    if (!origin.empty())
+        updated.setOrigin(origin);
+    if (!destination.empty())
+        updated.setDestination(destination);
+    if (!stops.empty())
+        updated.setKeyStops(stops);
     if (travelTime > 0)
-        route->setEstimatedTravelTime(travelTime);
+        updated.setEstimatedTravelTime(travelTime);
 
-    routeManager.updateRoute(id, *route);
+    routeManager.updateRoute(handle, updated);
 }
 
 void AdminDashboard::removeRoute()
@@ -504,8 +507,8 @@ void AdminDashboard::updateBus()
     clearInputBuffer();
     string id = getInput("Enter Bus ID to update: ");
 
-    Bus *bus = busManager.findBus(id);
-    if (!bus)
+    BusManager::Handle handle = busManager.findBusHandle(id);
+    if (!busManager.getBus(handle))
     {
         cout << "Bus not found." << endl;
         return;
@@ -526,24 +529,28 @@ void AdminDashboard::updateBus()
     string model = trim(getInput("Enter New Model (or press Enter to keep current): "));
     string status = trim(getInput("Enter New Status (or press Enter to keep current): "));
 
-    if (capacity > 0)
-        bus->setCapacity(capacity);
-    if (!model.empty())
+    if (!model.empty() && !validateNotEmpty(model, "Model"))
+        return;
+    if (!status.empty() && !validateStatus(status))
+        return;
+
+    // Re-resolve the handle rather than holding a pointer across the
+    // prompts, and edit a copy so a rejected update leaves the bus as it was.
+    const Bus *bus = busManager.getBus(handle);
+    if (!bus)
     {
-        if (validateNotEmpty(model, "Model"))
-            bus->setModel(model);
-        else
-            return;
+        cout << "Bus no longer exists." << endl;
+        return;
     }
+    Bus updated = *bus;
+    if (capacity > 0)
+        updated.setCapacity(capacity);
+    if (!model.empty())
+        updated.setModel(model);
     if (!status.empty())
-    {
-        if (validateStatus(status))
-            bus->setStatus(status);
-        else
-            return;
-    }
+        updated.setStatus(status);
 
-    busManager.updateBus(id, *bus);
+    busManager.updateBus(handle, updated);
 }
 
 void AdminDashboard::removeBus()
@@ -656,8 +663,8 @@ void AdminDashboard::updateDriver()
     driverManager.displayAllDrivers();
     string id = getInput("Enter Driver ID to update: ");
 
-    Driver *driver = driverManager.findDriver(id);
-    if (!driver)
+    DriverManager::Handle handle = driverManager.findDriverHandle(id);
+    if (!driverManager.getDriver(handle))
     {
         cout << "Driver not found." << endl;
         return;
@@ -668,29 +675,28 @@ void AdminDashboard::updateDriver()
     string contact = trim(getInput("Enter New Contact Info (or press Enter to keep current): "));
     string license = trim(getInput("Enter New License Details (or press Enter to keep current): "));
 
-    if (!name.empty())
+    if (!name.empty() && !validateNotEmpty(name, "Name"))
+        return;
+    if (!contact.empty() && !validateContact(contact))
+        return;
+    if (!license.empty() && !validateNotEmpty(license, "License Details"))
+        return;
+
+    const Driver *driver = driverManager.getDriver(handle);
+    if (!driver)
     {
-        if (validateNotEmpty(name, "Name"))
-            driver->setName(name);
-        else
-            return;
+        cout << "Driver no longer exists." << endl;
+        return;
     }
+    Driver updated = *driver;
+    if (!name.empty())
+        updated.setName(name);
     if (!contact.empty())
-    {
-        if (validateContact(contact))
-            driver->setContactInfo(contact);
-        else
-            return;
-    }
+        updated.setContactInfo(contact);
     if (!license.empty())
-    {
-        if (validateNotEmpty(license, "License Details"))
-            driver->setLicenseDetails(license);
-        else
-            return;
-    }
+        updated.setLicenseDetails(license);
 
-    driverManager.updateDriver(id, *driver);
+    driverManager.updateDriver(handle, updated);
 }
 
 void AdminDashboard::removeDriver()
@@ -725,7 +731,11 @@ void AdminDashboard::manageSchedules()
         cout << "2. Add Schedule" << endl;
         cout << "3. Update Schedule" << endl;
         cout << "4. Remove Schedule" << endl;
-        cout << "5. Back to Main Menu" << endl;
+        cout << "5. View Departures in a Time Window" << endl;
+        cout << "6. Audit Timetable for Conflicts" << endl;
+        cout << "7. Find Free Buses and Drivers" << endl;
+        cout << "8. Auto-Assign Buses and Drivers to Trips" << endl;
+        cout << "9. Back to Main Menu" << endl;
 
         choice = getIntInput("Enter your choice: ");
 
@@ -744,6 +754,18 @@ void AdminDashboard::manageSchedules()
             removeSchedule();
             break;
         case 5:
+            viewDeparturesBetween();
+            break;
+        case 6:
+            auditTimetable();
+            break;
+        case 7:
+            findFreeResources();
+            break;
+        case 8:
+            autoAssignTrips();
+            break;
+        case 9:
             back = true;
             break;
         default:
@@ -758,6 +780,115 @@ void AdminDashboard::viewSchedules()
     scheduleManager.displayAllSchedules();
 }
 
+void AdminDashboard::viewDeparturesBetween()
+{
+    cout << "\n--- Departures in a Time Window ---" << endl;
+
+    clearInputBuffer();
+
+    string date;
+    do
+    {
+        date = trim(getInput("Enter Date (YYYY-MM-DD): "));
+    } while (!validateDate(date));
+
+    string fromTime;
+    do
+    {
+        fromTime = trim(getInput("Enter Earliest Departure (HH:MM): "));
+    } while (!validateTime(fromTime));
+
+    string toTime;
+    do
+    {
+        toTime = trim(getInput("Enter Latest Departure (HH:MM): "));
+    } while (!validateTime(toTime));
+
+    scheduleManager.displaySchedules(
+        scheduleManager.findSchedules(ScheduleQuery().date(date).departingBetween(fromTime, toTime)));
+}
+
+void AdminDashboard::auditTimetable()
+{
+    cout << "\n";
+    scheduleManager.displayConflictReport(scheduleManager.auditTimetable());
+}
+
+void AdminDashboard::findFreeResources()
+{
+    cout << "\n--- Free Buses and Drivers ---" << endl;
+
+    clearInputBuffer();
+
+    string date;
+    do
+    {
+        date = trim(getInput("Enter Date (YYYY-MM-DD): "));
+    } while (!validateDate(date));
+
+    string fromTime;
+    do
+    {
+        fromTime = trim(getInput("Enter Start Time (HH:MM): "));
+    } while (!validateTime(fromTime));
+
+    string toTime;
+    do
+    {
+        toTime = trim(getInput("Enter End Time (HH:MM): "));
+    } while (!validateTime(toTime));
+
+    if (fromTime >= toTime)
+    {
+        cout << "Error: Start time must be before end time." << endl;
+        return;
+    }
+
+    vector<Symbol> freeBuses;
+    vector<Symbol> freeDrivers;
+    scheduleManager.findFreeResources(Schedule::parseDate(date), Schedule::parseTime(fromTime),
+                                      Schedule::parseTime(toTime), freeBuses, freeDrivers);
+    scheduleManager.displayFreeResources(freeBuses, freeDrivers);
+}
+
+void AdminDashboard::autoAssignTrips()
+{
+    cout << "\n--- Auto-Assign Buses and Drivers ---" << endl;
+    cout << "Trips file lines: ScheduleID,RouteID,Date,DepartureTime,ArrivalTime" << endl;
+
+    clearInputBuffer();
+
+    string filename = trim(getInput("Enter Trips File: "));
+    vector<Schedule> trips = DataLoader::loadTrips(filename);
+    if (trips.empty())
+    {
+        cout << "No trips to assign." << endl;
+        return;
+    }
+
+    AssignmentPlanner::Report report = scheduleManager.planAssignments(trips);
+    scheduleManager.displayAssignmentReport(report);
+    if (report.assigned.empty())
+    {
+        return;
+    }
+
+    string confirm = getInput("Add the assigned schedules? (yes/no): ");
+    if (confirm != "yes" && confirm != "y")
+    {
+        cout << "Operation cancelled." << endl;
+        return;
+    }
+
+    // All or none, so a rejected trip leaves no partial plan behind.
+    Transaction batch(routeManager, busManager, driverManager, scheduleManager);
+    for (const auto &schedule : report.assigned)
+    {
+        batch.addSchedule(schedule);
+    }
+    batch.commit();
+}
+
 void AdminDashboard::addSchedule()
 {
     
@@ -777,18 +908,6 @@ void AdminDashboard::addSchedule()
         routeId = trim(getInput("Enter Route ID: "));
     } while (!validateId(routeId));
 
-    string busId;
-    do
-    {
-        busId = trim(getInput("Enter Bus ID: "));
-    } while (!validateId(busId));
-
-    string driverId;
-    do
-    {
-        driverId = trim(getInput("Enter Driver ID: "));
-    } while (!validateId(driverId));
-
     string date;
     do
     {
@@ -813,6 +932,25 @@ void AdminDashboard::addSchedule()
         return;
     }
 
+    // Offer the buses and drivers that are free for the whole trip.
+    vector<Symbol> freeBuses;
+    vector<Symbol> freeDrivers;
+    scheduleManager.findFreeResources(Schedule::parseDate(date), Schedule::parseTime(departureTime),
+                                      Schedule::parseTime(arrivalTime), freeBuses, freeDrivers);
+    scheduleManager.displayFreeResources(freeBuses, freeDrivers, 16);
+
+    string busId;
+    do
+    {
+        busId = trim(getInput("Enter Bus ID: "));
+    } while (!validateId(busId));
+
+    string driverId;
+    do
+    {
+        driverId = trim(getInput("Enter Driver ID: "));
+    } while (!validateId(driverId));
+
     Schedule newSchedule(id, routeId, busId, driverId, date, departureTime, arrivalTime);
     scheduleManager.addSchedule(newSchedule);
 }
@@ -827,8 +965,8 @@ void AdminDashboard::updateSchedule()
     clearInputBuffer();
     string id = getInput("Enter Schedule ID to update: ");
 
-    Schedule *schedule = scheduleManager.findSchedule(id);
-    if (!schedule)
+    ScheduleManager::Handle handle = scheduleManager.findScheduleHandle(id);
+    if (!scheduleManager.getSchedule(handle))
     {
         cout << "Schedule not found." << endl;
         return;
@@ -855,20 +993,28 @@ void AdminDashboard::updateSchedule()
     if (!arrivalTime.empty() && !validateTime(arrivalTime))
         return;
 
+    // Edit a copy: the manager re-indexes the stored schedule from its old values.
+    const Schedule *schedule = scheduleManager.getSchedule(handle);
+    if (!schedule)
+    {
+        cout << "Schedule no longer exists." << endl;
+        return;
+    }
+    Schedule updated = *schedule;
     if (!routeId.empty())
-        schedule->setRouteId(routeId);
+        updated.setRouteId(routeId);
     if (!busId.empty())
-        schedule->setBusId(busId);
+        updated.setBusId(busId);
     if (!driverId.empty())
-        schedule->setDriverId(driverId);
+        updated.setDriverId(driverId);
     if (!date.empty())
-        schedule->setDate(date);
+        updated.setDate(date);
     if (!departureTime.empty())
-        schedule->setDepartureTime(departureTime);
+        updated.setDepartureTime(departureTime);
     if (!arrivalTime.empty())
-        schedule->setArrivalTime(arrivalTime);
+        updated.setArrivalTime(arrivalTime);
 
-    scheduleManager.updateSchedule(id, *schedule);
+    scheduleManager.updateSchedule(handle, updated);
 }
 
 void AdminDashboard::removeSchedule()
@@ -0,0 +1,85 @@
+﻿#include "../include/AllocationCounter.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+static atomic<size_t> allocations(0);
+static atomic<size_t> bytesInUse(0);
+
+// Each block is prefixed with its requested size so delete can subtract it;
+// the prefix is a full max_align_t to keep the returned pointer aligned.
+static constexpr size_t HEADER_SIZE = alignof(max_align_t);
+
+size_t AllocationCounter::count()
+{
+    return allocations.load(memory_order_relaxed);
+}
+
+size_t AllocationCounter::liveBytes()
+{
+    return bytesInUse.load(memory_order_relaxed);
+}
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (char *memory = static_cast<char *>(malloc(size + HEADER_SIZE)))
+    {
+        *reinterpret_cast<size_t *>(memory) = size;
+        bytesInUse.fetch_add(size, memory_order_relaxed);
+        return memory + HEADER_SIZE;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+    if (!memory)
+    {
+        return;
+    }
+    char *block = static_cast<char *>(memory) - HEADER_SIZE;
+    bytesInUse.fetch_sub(*reinterpret_cast<size_t *>(block), memory_order_relaxed);
+    free(block);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    operator delete(memory);
+}
+
+// Over-aligned blocks (std::pmr's new_delete_resource asks for these) keep
+// the malloc'd pointer and the size just below the aligned address.
+void *operator new(size_t size, align_val_t alignment)
+{
+    allocations.fetch_add(1, memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment) > HEADER_SIZE ? static_cast<size_t>(alignment) : HEADER_SIZE;
+    if (char *memory = static_cast<char *>(malloc(size + align + HEADER_SIZE)))
+    {
+        uintptr_t start = reinterpret_cast<uintptr_t>(memory) + HEADER_SIZE;
+        char *aligned = reinterpret_cast<char *>((start + align - 1) & ~(uintptr_t(align) - 1));
+        reinterpret_cast<void **>(aligned)[-2] = memory;
+        reinterpret_cast<size_t *>(aligned)[-1] = size;
+        bytesInUse.fetch_add(size, memory_order_relaxed);
+        return aligned;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void *memory, align_val_t) noexcept
+{
+    if (!memory)
+    {
+        return;
+    }
+    bytesInUse.fetch_sub(reinterpret_cast<size_t *>(memory)[-1], memory_order_relaxed);
+    free(reinterpret_cast<void **>(memory)[-2]);
+}
+
+void operator delete(void *memory, size_t, align_val_t alignment) noexcept
+{
+    operator delete(memory, alignment);
+}
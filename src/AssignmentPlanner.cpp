@@ -0,0 +1,252 @@
+﻿#include "../include/AssignmentPlanner.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <functional>
+#include <queue>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+using namespace std;
+
+namespace
+{
+    const uint32_t NOT_ON_ROSTER = UINT32_MAX;
+    const int16_t END_OF_DAY = 24 * 60;
+
+    struct Busy
+    {
+        uint32_t resource; // Roster position
+        int16_t start;
+        int16_t end;
+    };
+
+    struct Gap
+    {
+        int16_t start;
+        int16_t end;
+        uint32_t resource;
+    };
+
+    struct StartsLater
+    {
+        bool operator()(const Gap &a, const Gap &b) const
+        {
+            return a.start > b.start;
+        }
+    };
+
+    vector<uint32_t> rosterPositions(const vector<Symbol> &roster)
+    {
+        Symbol highest = roster.empty() ? 0 : *max_element(roster.begin(), roster.end());
+        vector<uint32_t> positions(static_cast<size_t>(highest) + 1, NOT_ON_ROSTER);
+        for (uint32_t position = 0; position < roster.size(); ++position)
+        {
+            positions[roster[position]] = position;
+        }
+        return positions;
+    }
+
+    // Plans one date for one resource kind. trips holds the date's trip
+    // rows by departure; busy the existing schedules of rostered resources
+    // that date. Writes a roster position, or NOT_ON_ROSTER, per trip row.
+    void partition(const vector<uint32_t> &trips, vector<Busy> &busy, const vector<Schedule> &tripList,
+                   size_t rosterSize, vector<uint32_t> &chosen)
+    {
+        // Gaps between each working resource's existing schedules.
+        sort(busy.begin(), busy.end(), [](const Busy &a, const Busy &b)
+             { return tie(a.resource, a.start) < tie(b.resource, b.start); });
+        priority_queue<Gap, vector<Gap>, StartsLater> pending;
+        vector<bool> working(rosterSize, false);
+        for (size_t i = 0; i < busy.size();)
+        {
+            uint32_t resource = busy[i].resource;
+            working[resource] = true;
+            int16_t freeFrom = 0;
+            for (; i < busy.size() && busy[i].resource == resource; ++i)
+            {
+                if (busy[i].start > freeFrom)
+                {
+                    pending.push({freeFrom, busy[i].start, resource});
+                }
+                freeFrom = max(freeFrom, busy[i].end);
+            }
+            if (freeFrom < END_OF_DAY)
+            {
+                pending.push({freeFrom, END_OF_DAY, resource});
+            }
+        }
+
+        // Gaps already open at the current departure, by end.
+        set<tuple<int16_t, int16_t, uint32_t>> open;
+        uint32_t nextIdle = 0;
+        for (uint32_t row : trips)
+        {
+            int16_t departure = tripList[row].getDepartureMinutes();
+            int16_t arrival = tripList[row].getArrivalMinutes();
+            while (!pending.empty() && pending.top().start <= departure)
+            {
+                const Gap &gap = pending.top();
+                open.emplace(gap.end, gap.start, gap.resource);
+                pending.pop();
+            }
+            while (!open.empty() && get<0>(*open.begin()) <= departure)
+            {
+                open.erase(open.begin());
+            }
+
+            uint32_t resource = NOT_ON_ROSTER;
+            int16_t gapEnd = END_OF_DAY;
+            auto fit = open.lower_bound({arrival, INT16_MIN, 0});
+            if (fit != open.end())
+            {
+                resource = get<2>(*fit);
+                gapEnd = get<0>(*fit);
+                open.erase(fit);
+            }
+            else
+            {
+                while (nextIdle < rosterSize && working[nextIdle])
+                {
+                    nextIdle++;
+                }
+                if (nextIdle < rosterSize)
+                {
+                    resource = nextIdle;
+                    working[nextIdle] = true;
+                }
+            }
+
+            chosen[row] = resource;
+            if (resource != NOT_ON_ROSTER && arrival < gapEnd)
+            {
+                pending.push({arrival, gapEnd, resource});
+            }
+        }
+    }
+}
+
+AssignmentPlanner::Report AssignmentPlanner::run(const vector<Schedule> &trips, const vector<Schedule> &schedules,
+                                                 const vector<Symbol> &buses, const vector<Symbol> &drivers,
+                                                 unsigned threadCount)
+{
+    Report report;
+
+    // Trip rows grouped by date, each date by departure.
+    unordered_map<int32_t, size_t> dateOf;
+    vector<int32_t> dates;
+    vector<vector<uint32_t>> tripsByDate;
+    for (uint32_t row = 0; row < trips.size(); ++row)
+    {
+        const Schedule &trip = trips[row];
+        if (trip.getDay() == Schedule::INVALID_DAY || trip.getDepartureMinutes() == Schedule::INVALID_TIME ||
+            trip.getArrivalMinutes() == Schedule::INVALID_TIME ||
+            trip.getDepartureMinutes() >= trip.getArrivalMinutes())
+        {
+            continue;
+        }
+        auto inserted = dateOf.emplace(trip.getDay(), dates.size());
+        if (inserted.second)
+        {
+            dates.push_back(trip.getDay());
+            tripsByDate.emplace_back();
+        }
+        tripsByDate[inserted.first->second].push_back(row);
+    }
+    report.datesPlanned = dates.size();
+
+    // Existing schedules that hold a rostered resource on a planned date.
+    vector<uint32_t> busPosition = rosterPositions(buses);
+    vector<uint32_t> driverPosition = rosterPositions(drivers);
+    vector<vector<Busy>> busyBuses(dates.size());
+    vector<vector<Busy>> busyDrivers(dates.size());
+    for (const auto &schedule : schedules)
+    {
+        auto date = dateOf.find(schedule.getDay());
+        if (date == dateOf.end() || schedule.getDepartureMinutes() >= schedule.getArrivalMinutes())
+        {
+            continue;
+        }
+        Symbol bus = schedule.getBusSymbol();
+        if (bus < busPosition.size() && busPosition[bus] != NOT_ON_ROSTER)
+        {
+            busyBuses[date->second].push_back(
+                {busPosition[bus], schedule.getDepartureMinutes(), schedule.getArrivalMinutes()});
+        }
+        Symbol driver = schedule.getDriverSymbol();
+        if (driver < driverPosition.size() && driverPosition[driver] != NOT_ON_ROSTER)
+        {
+            busyDrivers[date->second].push_back(
+                {driverPosition[driver], schedule.getDepartureMinutes(), schedule.getArrivalMinutes()});
+        }
+    }
+
+    if (threadCount == 0)
+    {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+    // Workers claim whole jobs, so each job's entries are written by one thread.
+    auto runJobs = [threadCount](size_t jobs, const function<void(size_t)> &job)
+    {
+        atomic<size_t> nextJob(0);
+        auto work = [&]()
+        {
+            for (size_t j = nextJob++; j < jobs; j = nextJob++)
+            {
+                job(j);
+            }
+        };
+        vector<thread> workers;
+        for (size_t w = 1; w < min<size_t>(threadCount, max<size_t>(jobs, 1)); ++w)
+        {
+            workers.emplace_back(work);
+        }
+        work();
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    };
+
+    runJobs(dates.size(), [&](size_t d)
+            { sort(tripsByDate[d].begin(), tripsByDate[d].end(), [&trips](uint32_t a, uint32_t b)
+                   { return make_tuple(trips[a].getDepartureMinutes(), trips[a].getArrivalMinutes(), a) <
+                            make_tuple(trips[b].getDepartureMinutes(), trips[b].getArrivalMinutes(), b); }); });
+
+    // Job 2d plans date d's buses and job 2d + 1 its drivers.
+    vector<uint32_t> busChosen(trips.size(), NOT_ON_ROSTER);
+    vector<uint32_t> driverChosen(trips.size(), NOT_ON_ROSTER);
+    runJobs(dates.size() * 2, [&](size_t job)
+            {
+        size_t d = job / 2;
+        if (job % 2 == 0)
+        {
+            partition(tripsByDate[d], busyBuses[d], trips, buses.size(), busChosen);
+        }
+        else
+        {
+            partition(tripsByDate[d], busyDrivers[d], trips, drivers.size(), driverChosen);
+        } });
+
+    vector<bool> busUsed(buses.size(), false);
+    vector<bool> driverUsed(drivers.size(), false);
+    for (uint32_t row = 0; row < trips.size(); ++row)
+    {
+        const Schedule &trip = trips[row];
+        if (busChosen[row] == NOT_ON_ROSTER || driverChosen[row] == NOT_ON_ROSTER)
+        {
+            report.unassigned.push_back(trip.getId());
+            continue;
+        }
+        report.assigned.emplace_back(trip.getId().str(), trip.getRouteSymbol(), buses[busChosen[row]],
+                                     drivers[driverChosen[row]], trip.getDay(), trip.getDepartureMinutes(),
+                                     trip.getArrivalMinutes());
+        report.busesUsed += !busUsed[busChosen[row]];
+        report.driversUsed += !driverUsed[driverChosen[row]];
+        busUsed[busChosen[row]] = true;
+        driverUsed[driverChosen[row]] = true;
+    }
+    return report;
+}
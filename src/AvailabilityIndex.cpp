@@ -0,0 +1,225 @@
+﻿#include "../include/AvailabilityIndex.h"
+#include "../include/ScanKernels.h"
+#include <algorithm>
+
+using namespace std;
+
+static const uint32_t NOT_ON_ROSTER = UINT32_MAX;
+
+void AvailabilityIndex::clear()
+{
+    days.clear();
+    rows = 0;
+}
+
+uint32_t AvailabilityIndex::row(Symbol resource, int32_t day)
+{
+    Day &entry = days[day];
+    auto found = entry.rowOf.find(resource);
+    if (found != entry.rowOf.end())
+    {
+        return found->second;
+    }
+    uint32_t position = static_cast<uint32_t>(entry.resources.size());
+    if (position == entry.capacity)
+    {
+        // Each column moves to its place in the larger block.
+        size_t capacity = max<size_t>(8, entry.capacity * 2);
+        vector<uint64_t> words(capacity * WORDS_PER_ROW, 0);
+        for (size_t w = 0; w < WORDS_PER_ROW; ++w)
+        {
+            copy(entry.words.begin() + w * entry.capacity, entry.words.begin() + (w + 1) * entry.capacity,
+                 words.begin() + w * capacity);
+        }
+        entry.words.swap(words);
+        entry.capacity = capacity;
+    }
+    entry.rowOf.emplace(resource, position);
+    entry.resources.push_back(resource);
+    rows++;
+    return position;
+}
+
+void AvailabilityIndex::setMinutes(Day &entry, uint32_t position, int16_t start, int16_t end)
+{
+    for (int32_t minute = max<int32_t>(start, 0); minute < min<int32_t>(end, MINUTES_PER_DAY);)
+    {
+        // Whole words at a time where the range allows.
+        int32_t bit = minute % 64;
+        int32_t span = min<int32_t>(64 - bit, min<int32_t>(end, MINUTES_PER_DAY) - minute);
+        uint64_t mask = span == 64 ? ~0ULL : ((1ULL << span) - 1) << bit;
+        entry.words[(minute / 64) * entry.capacity + position] |= mask;
+        minute += span;
+    }
+}
+
+bool AvailabilityIndex::windowMasks(int16_t start, int16_t end, size_t &first, vector<uint64_t> &masks)
+{
+    int32_t low = max<int32_t>(start, 0);
+    int32_t high = min<int32_t>(end, MINUTES_PER_DAY);
+    masks.clear();
+    if (low >= high)
+    {
+        return false;
+    }
+    first = static_cast<size_t>(low / 64);
+    size_t last = static_cast<size_t>((high - 1) / 64);
+    for (size_t w = first; w <= last; ++w)
+    {
+        uint64_t mask = ~0ULL;
+        if (w == first)
+        {
+            mask &= ~0ULL << (low % 64);
+        }
+        int32_t bitsInLast = high - static_cast<int32_t>(w) * 64;
+        if (w == last && bitsInLast < 64)
+        {
+            mask &= (1ULL << bitsInLast) - 1;
+        }
+        masks.push_back(mask);
+    }
+    return true;
+}
+
+void AvailabilityIndex::occupy(Symbol resource, int32_t day, int16_t start, int16_t end)
+{
+    if (start >= end)
+    {
+        return;
+    }
+    uint32_t position = row(resource, day);
+    setMinutes(days[day], position, start, end);
+}
+
+void AvailabilityIndex::redraw(Symbol resource, int32_t day, const IntervalIndex::Group *intervals)
+{
+    auto found = days.find(day);
+    if (found == days.end())
+    {
+        return;
+    }
+    Day &entry = found->second;
+    auto existing = entry.rowOf.find(resource);
+    if (existing == entry.rowOf.end())
+    {
+        return;
+    }
+    uint32_t position = existing->second;
+    for (size_t w = 0; w < WORDS_PER_ROW; ++w)
+    {
+        entry.words[w * entry.capacity + position] = 0;
+    }
+
+    if (intervals && !intervals->empty())
+    {
+        for (const auto &interval : *intervals)
+        {
+            setMinutes(entry, position, interval.start, interval.end);
+        }
+        return;
+    }
+
+    // Last row moves into the gap.
+    uint32_t last = static_cast<uint32_t>(entry.resources.size() - 1);
+    if (position != last)
+    {
+        for (size_t w = 0; w < WORDS_PER_ROW; ++w)
+        {
+            entry.words[w * entry.capacity + position] = entry.words[w * entry.capacity + last];
+            entry.words[w * entry.capacity + last] = 0;
+        }
+        entry.resources[position] = entry.resources[last];
+        entry.rowOf[entry.resources[position]] = position;
+    }
+    entry.rowOf.erase(resource);
+    entry.resources.pop_back();
+    rows--;
+    if (entry.resources.empty())
+    {
+        days.erase(found);
+    }
+}
+
+bool AvailabilityIndex::isFree(Symbol resource, int32_t day, int16_t start, int16_t end) const
+{
+    size_t first;
+    vector<uint64_t> masks;
+    auto found = days.find(day);
+    if (found == days.end() || !windowMasks(start, end, first, masks))
+    {
+        return true;
+    }
+    auto existing = found->second.rowOf.find(resource);
+    if (existing == found->second.rowOf.end())
+    {
+        return true;
+    }
+    const Day &entry = found->second;
+    for (size_t w = 0; w < masks.size(); ++w)
+    {
+        if (entry.words[(first + w) * entry.capacity + existing->second] & masks[w])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AvailabilityIndex::setRoster(const vector<Symbol> &resources)
+{
+    roster = resources;
+    Symbol highest = roster.empty() ? 0 : *max_element(roster.begin(), roster.end());
+    rosterPosition.assign(static_cast<size_t>(highest) + 1, NOT_ON_ROSTER);
+    for (uint32_t position = 0; position < roster.size(); ++position)
+    {
+        rosterPosition[roster[position]] = position;
+    }
+}
+
+vector<Symbol> AvailabilityIndex::findFree(int32_t day, int16_t start, int16_t end) const
+{
+    vector<uint64_t> available(ScanKernels::wordCount(roster.size()));
+    ScanKernels::selectAll(roster.size(), available.data());
+
+    size_t first;
+    vector<uint64_t> masks;
+    auto found = days.find(day);
+    if (found != days.end() && windowMasks(start, end, first, masks))
+    {
+        const Day &entry = found->second;
+        size_t rowTotal = entry.resources.size();
+        // OR the window's words of every row into one busy word per row,
+        // one contiguous column at a time.
+        vector<uint64_t> busy(rowTotal, 0);
+        for (size_t w = 0; w < masks.size(); ++w)
+        {
+            const uint64_t *column = entry.words.data() + (first + w) * entry.capacity;
+            uint64_t mask = masks[w];
+            for (size_t r = 0; r < rowTotal; ++r)
+            {
+                busy[r] |= column[r] & mask;
+            }
+        }
+        for (size_t r = 0; r < rowTotal; ++r)
+        {
+            Symbol resource = entry.resources[r];
+            if (busy[r] && resource < rosterPosition.size() && rosterPosition[resource] != NOT_ON_ROSTER)
+            {
+                uint32_t position = rosterPosition[resource];
+                available[position / 64] &= ~(1ULL << (position % 64));
+            }
+        }
+    }
+
+    vector<Symbol> freeResources;
+    for (uint32_t position : ScanKernels::selectedRows(available))
+    {
+        freeResources.push_back(roster[position]);
+    }
+    return freeResources;
+}
+
+size_t AvailabilityIndex::rowCount() const
+{
+    return rows;
+}
@@ -0,0 +1,1682 @@
+﻿#include "../include/BenchmarkRunner.h"
+#include "../include/AllocationCounter.h"
+#include "../include/AssignmentPlanner.h"
+#include "../include/AvailabilityIndex.h"
+#include "../include/DataLoader.h"
+#include "../include/DataSaver.h"
+#include "../include/FlushScheduler.h"
+#include "../include/DepartureBoard.h"
+#include "../include/IntervalIndex.h"
+#include "../include/JourneyPlanner.h"
+#include "../include/StartupLoader.h"
+#include "../include/BusManager.h"
+#include "../include/DriverManager.h"
+#include "../include/RouteManager.h"
+#include "../include/ScheduleManager.h"
+#include "../include/ScheduleQuery.h"
+#include "../include/ScheduleStore.h"
+#include "../include/ScheduleView.h"
+#include "../include/ScanKernels.h"
+#include "../include/SlotMap.h"
+#include "../include/TimetableAudit.h"
+#include "../include/Transaction.h"
+#include "../include/TravelTimeMatrix.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+template <typename Fn>
+static double timeMilliseconds(Fn fn)
+{
+    auto start = chrono::steady_clock::now();
+    fn();
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(end - start).count();
+}
+
+// Calendar date for a day offset from 2025-01-01.
+static string dateForDay(size_t day)
+{
+    static const int daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    int year = 2025;
+    int month = 0;
+    size_t remaining = day;
+
+    while (true)
+    {
+        bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        int length = daysInMonth[month] + (month == 1 && leap ? 1 : 0);
+        if (remaining < static_cast<size_t>(length))
+        {
+            break;
+        }
+        remaining -= length;
+        if (++month == 12)
+        {
+            month = 0;
+            year++;
+        }
+    }
+
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", year, month + 1, static_cast<int>(remaining) + 1);
+    return buffer;
+}
+
+static string timeForMinutes(int minutes)
+{
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%02d:%02d", minutes / 60, minutes % 60);
+    return buffer;
+}
+
+BenchmarkRunner::BenchmarkRunner(const string &dataDirectory, size_t schedules, size_t lookupSchedules)
+    : dataDir(dataDirectory), scheduleCount(schedules), lookupScheduleCount(lookupSchedules)
+{
+    busCount = max<size_t>(10, scheduleCount / 100);
+    driverCount = busCount;
+    routeCount = max<size_t>(10, scheduleCount / 1000);
+}
+
+string BenchmarkRunner::dataFile(const string &name) const
+{
+    return dataDir + name;
+}
+
+void BenchmarkRunner::printBenchmarkHeader(const string &category)
+{
+    cout << "\n========================================" << endl;
+    cout << "  " << category << endl;
+    cout << "========================================" << endl;
+}
+
+void BenchmarkRunner::logResult(const string &name, double milliseconds, const string &note)
+{
+    cout << "  " << left << setw(44) << name
+         << right << fixed << setprecision(2) << setw(12) << milliseconds << " ms";
+    if (!note.empty())
+    {
+        cout << "  (" << note << ")";
+    }
+    cout << endl;
+}
+
+void BenchmarkRunner::generateDataset()
+{
+    printBenchmarkHeader("GENERATING DATASET");
+
+    double elapsed = timeMilliseconds([&]()
+                                      {
+        ofstream buses(dataFile("buses.txt"));
+        for (size_t i = 0; i < busCount; ++i)
+        {
+            buses << "B" << i << "," << 40 + i % 20 << ",Model " << i % 7 << ","
+                  << (i % 10 == 9 ? "Maintenance" : "Active") << '\n';
+        }
+
+        ofstream drivers(dataFile("drivers.txt"));
+        for (size_t i = 0; i < driverCount; ++i)
+        {
+            drivers << "D" << i << ",Driver " << i << ",555-" << 1000000 + i << ",Class "
+                    << (i % 2 ? 'A' : 'B') << '\n';
+        }
+
+        size_t stopCount = routeCount * 2;
+        ofstream routes(dataFile("routes.txt"));
+        for (size_t i = 0; i < routeCount; ++i)
+        {
+            routes << "R" << i << ",Stop " << i % stopCount << ",Stop " << (i + 7) % stopCount << ",";
+            for (size_t k = 1; k <= 4; ++k)
+            {
+                routes << "Stop " << (i + k * 3) % stopCount << (k < 4 ? "|" : "");
+            }
+            routes << "," << 30 + i % 90 << '\n';
+        }
+
+        // Each bus and its matching driver run eight non-overlapping trips a day.
+        ofstream schedules(dataFile("schedules.txt"));
+        size_t tripsPerDay = busCount * 8;
+        for (size_t i = 0; i < scheduleCount; ++i)
+        {
+            size_t slot = i % tripsPerDay;
+            size_t resource = slot % busCount;
+            int departure = 6 * 60 + static_cast<int>(slot / busCount) * 120;
+            schedules << "S" << i << ",R" << i % routeCount << ",B" << resource << ",D" << resource << ","
+                      << dateForDay(i / tripsPerDay) << "," << timeForMinutes(departure) << ","
+                      << timeForMinutes(departure + 90) << '\n';
+        }
+
+        ofstream credentials(dataFile("credentials.txt"));
+        credentials << "admin,admin,Admin\n";
+        for (size_t i = 0; i < driverCount; ++i)
+        {
+            credentials << "D" << i << ",driver" << i << ",Driver\n";
+        } });
+
+    cout << "  " << busCount << " buses, " << driverCount << " drivers, " << routeCount
+         << " routes, " << scheduleCount << " schedules" << endl;
+    logResult("Dataset generation", elapsed);
+}
+
+void BenchmarkRunner::benchmarkLoaders()
+{
+    printBenchmarkHeader("LOADER BENCHMARKS (STREAM vs MAPPED)");
+
+    const LoadMode modes[] = {LoadMode::STREAM, LoadMode::MAPPED};
+    const char *modeNames[] = {"stream", "mapped"};
+    double schedulesTime[2] = {0, 0};
+
+    for (int m = 0; m < 2; ++m)
+    {
+        DataLoader::setLoadMode(modes[m]);
+        string suffix = string(" [") + modeNames[m] + "]";
+
+        size_t count = 0;
+        double elapsed = timeMilliseconds([&]()
+                                          { count = DataLoader::loadBuses(dataFile("buses.txt")).size(); });
+        logResult("loadBuses" + suffix, elapsed, to_string(count) + " rows");
+
+        elapsed = timeMilliseconds([&]()
+                                   { count = DataLoader::loadDrivers(dataFile("drivers.txt")).size(); });
+        logResult("loadDrivers" + suffix, elapsed, to_string(count) + " rows");
+
+        elapsed = timeMilliseconds([&]()
+                                   { count = DataLoader::loadRoutes(dataFile("routes.txt")).size(); });
+        logResult("loadRoutes" + suffix, elapsed, to_string(count) + " rows");
+
+        elapsed = timeMilliseconds([&]()
+                                   { count = DataLoader::loadSchedules(dataFile("schedules.txt")).size(); });
+        schedulesTime[m] = elapsed;
+        logResult("loadSchedules" + suffix, elapsed, to_string(count) + " rows");
+
+        elapsed = timeMilliseconds([&]()
+                                   { count = DataLoader::loadCredentials(dataFile("credentials.txt")).size(); });
+        logResult("loadCredentials" + suffix, elapsed, to_string(count) + " rows");
+    }
+
+    DataLoader::setLoadMode(LoadMode::STREAM);
+    if (schedulesTime[1] > 0)
+    {
+        cout << "  Mapped schedule load speedup: " << fixed << setprecision(2)
+             << schedulesTime[0] / schedulesTime[1] << "x" << endl;
+    }
+}
+
+void BenchmarkRunner::benchmarkParallelLoader()
+{
+    printBenchmarkHeader("PARALLEL SCHEDULE LOADER SCALING");
+
+    unsigned hardwareThreads = max(1u, thread::hardware_concurrency());
+    cout << "  Hardware threads: " << hardwareThreads << endl;
+
+    DataLoader::setLoadMode(LoadMode::PARALLEL);
+    double singleThread = 0;
+    for (unsigned threads = 1; threads <= max(4u, hardwareThreads); threads *= 2)
+    {
+        DataLoader::setThreadCount(threads);
+        size_t count = 0;
+        double elapsed = timeMilliseconds([&]()
+                                          { count = DataLoader::loadSchedules(dataFile("schedules.txt")).size(); });
+        if (threads == 1)
+        {
+            singleThread = elapsed;
+        }
+
+        ostringstream note;
+        note << count << " rows, " << fixed << setprecision(2) << singleThread / elapsed << "x vs 1 thread";
+        logResult("loadSchedules [parallel, " + to_string(threads) + " threads]", elapsed, note.str());
+    }
+    DataLoader::setThreadCount(0);
+    DataLoader::setLoadMode(LoadMode::STREAM);
+}
+
+void BenchmarkRunner::benchmarkStartup()
+{
+    printBenchmarkHeader("STARTUP PIPELINE (SEQUENTIAL vs CONCURRENT)");
+
+    DataLoader::setLoadMode(LoadMode::PARALLEL);
+
+    double sequential = timeMilliseconds([&]()
+                                         {
+        SystemData data;
+        data.buses = DataLoader::loadBuses(dataFile("buses.txt"));
+        data.drivers = DataLoader::loadDrivers(dataFile("drivers.txt"));
+        data.routes = DataLoader::loadRoutes(dataFile("routes.txt"));
+        data.schedules = DataLoader::loadSchedules(dataFile("schedules.txt"));
+        data.users = DataLoader::loadCredentials(dataFile("credentials.txt")); });
+    logResult("Sequential load of all five files", sequential);
+
+    StartupLoader startupLoader(dataFile("buses.txt"), dataFile("drivers.txt"), dataFile("routes.txt"),
+                                dataFile("schedules.txt"), dataFile("credentials.txt"));
+    double concurrent = timeMilliseconds([&]()
+                                         { startupLoader.loadAll(); });
+    logResult("StartupLoader::loadAll (concurrent)", concurrent);
+    startupLoader.displayTimings();
+
+    DataLoader::setLoadMode(LoadMode::STREAM);
+}
+
+void BenchmarkRunner::benchmarkSnapshot()
+{
+    printBenchmarkHeader("COLD START (CSV vs BINARY SNAPSHOT)");
+
+    DataLoader::setLoadMode(LoadMode::PARALLEL);
+    StartupLoader startupLoader(dataFile("buses.txt"), dataFile("drivers.txt"), dataFile("routes.txt"),
+                                dataFile("schedules.txt"), dataFile("credentials.txt"));
+
+    SystemData data;
+    double csv = timeMilliseconds([&]()
+                                  { data = startupLoader.loadAll(); });
+    logResult("Cold start from CSV files", csv);
+
+    string snapshot = dataFile("snapshot.bin");
+    double save = timeMilliseconds([&]()
+                                   { DataSaver::saveSnapshot(snapshot, data, startupLoader.getSourceFiles()); });
+    logResult("DataSaver::saveSnapshot", save);
+
+    SystemData restored;
+    bool loaded = false;
+    double load = timeMilliseconds([&]()
+                                   { loaded = DataLoader::loadSnapshot(snapshot, startupLoader.getSourceFiles(), restored); });
+    logResult("Cold start from snapshot", load, loaded ? "fresh" : "REJECTED");
+
+    if (loaded && load > 0)
+    {
+        cout << "  Snapshot cold-start speedup: " << fixed << setprecision(2) << csv / load << "x" << endl;
+    }
+    DataLoader::setLoadMode(LoadMode::STREAM);
+}
+
+// Resident set size of this process, or 0 where it cannot be read.
+static size_t residentBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#else
+    ifstream statm("/proc/self/statm");
+    size_t pages = 0;
+    size_t resident = 0;
+    if (statm >> pages >> resident)
+    {
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+    return 0;
+#endif
+}
+
+static string megabytes(size_t bytes)
+{
+    ostringstream text;
+    text << fixed << setprecision(1) << bytes / (1024.0 * 1024.0) << " MB";
+    return text.str();
+}
+
+void BenchmarkRunner::benchmarkArenaLoading()
+{
+    printBenchmarkHeader("ARENA LOADING (HEAP vs LOADARENA)");
+
+    // Text fields longer than the small-string buffer, so each one is a
+    // separate heap block unless it comes from an arena.
+    const size_t rows = scheduleCount;
+    {
+        ofstream buses(dataFile("arena_buses.txt"));
+        for (size_t i = 0; i < rows; ++i)
+        {
+            buses << "AB" << i << "," << 40 + i % 20 << ",Intercity Coach Series " << i % 97 << ",Active\n";
+        }
+        ofstream drivers(dataFile("arena_drivers.txt"));
+        for (size_t i = 0; i < rows; ++i)
+        {
+            drivers << "AD" << i << ",Driver Firstname Lastname " << i << ",+92-300-" << 1000000 + i
+                    << " extension " << i % 100 << ",Heavy Transport Vehicle Licence " << i << '\n';
+        }
+        ofstream routes(dataFile("arena_routes.txt"));
+        for (size_t i = 0; i < rows / 10; ++i)
+        {
+            routes << "AR" << i << ",Central Terminal Stop " << i % 500 << ",Northern Terminal Stop "
+                   << (i + 7) % 500 << ",Stop " << i % 50 << "|Stop " << (i + 3) % 50 << "|Stop "
+                   << (i + 6) % 50 << "," << 30 + i % 90 << '\n';
+        }
+        ofstream schedules(dataFile("arena_schedules.txt"));
+        ofstream credentials(dataFile("arena_credentials.txt"));
+    }
+    cout << "  " << rows << " buses, " << rows << " drivers, " << rows / 10 << " routes with long text fields"
+         << endl;
+
+    DataLoader::setLoadMode(LoadMode::PARALLEL);
+    StartupLoader startupLoader(dataFile("arena_buses.txt"), dataFile("arena_drivers.txt"),
+                                dataFile("arena_routes.txt"), dataFile("arena_schedules.txt"),
+                                dataFile("arena_credentials.txt"));
+
+    // Arena first, so the heap run cannot reuse memory the arena run freed
+    // back to the allocator.
+    for (bool arena : {true, false})
+    {
+        startupLoader.setArenaLoading(arena);
+        string label = arena ? "arena" : "heap";
+
+        size_t residentBefore = residentBytes();
+        size_t allocationsBefore = AllocationCounter::count();
+        unique_ptr<SystemData> data;
+        streambuf *originalCout = cout.rdbuf(nullptr);
+        double load = timeMilliseconds([&]()
+                                       { data = make_unique<SystemData>(startupLoader.loadAll()); });
+        cout.rdbuf(originalCout);
+        size_t allocations = AllocationCounter::count() - allocationsBefore;
+        size_t residentAfter = residentBytes();
+
+        size_t arenaBytes = 0;
+        for (const auto &region : data->arenas)
+        {
+            arenaBytes += region->reservedBytes();
+        }
+
+        logResult("Load (" + label + ")", load, to_string(allocations) + " allocations");
+        cout << "  RSS growth (" << label << "): "
+             << megabytes(residentAfter > residentBefore ? residentAfter - residentBefore : 0);
+        if (arena)
+        {
+            cout << ", " << megabytes(arenaBytes) << " in " << data->arenas.size() << " arenas";
+        }
+        cout << endl;
+
+        double teardown = timeMilliseconds([&]()
+                                           { data.reset(); });
+        logResult("Teardown (" + label + ")", teardown);
+    }
+
+    DataLoader::setLoadMode(LoadMode::STREAM);
+}
+
+static string speedupNote(double baseline, double optimized)
+{
+    ostringstream note;
+    note << fixed << setprecision(2) << baseline / max(optimized, 1e-9) << "x";
+    return note.str();
+}
+
+void BenchmarkRunner::benchmarkMutationLog()
+{
+    printBenchmarkHeader("PER-MUTATION PERSISTENCE (REWRITE vs LOG APPEND)");
+
+    DataLoader::setLoadMode(LoadMode::PARALLEL);
+    StartupLoader startupLoader(dataFile("buses.txt"), dataFile("drivers.txt"), dataFile("routes.txt"),
+                                dataFile("schedules.txt"), dataFile("credentials.txt"));
+    SystemData data = startupLoader.loadAll();
+    DataLoader::setLoadMode(LoadMode::STREAM);
+
+    ScheduleManager scheduleManager(data.schedules, data.routes, data.buses, data.drivers,
+                                    dataFile("schedules.txt"));
+    scheduleManager.setCompactionThreshold(SIZE_MAX);
+    // Below the threshold a group commit only syncs the log.
+    FlushScheduler flusher(60000);
+    scheduleManager.attachFlusher(flusher);
+
+    // Keep manager chatter out of the report.
+    streambuf *originalCout = cout.rdbuf(nullptr);
+
+    double rewrite = timeMilliseconds([&]()
+                                      { scheduleManager.saveToFile(); });
+
+    const int mutations = 20;
+    double append = timeMilliseconds([&]()
+                                     {
+        for (int i = 0; i < mutations; ++i)
+        {
+            Schedule extra("BENCH_S" + to_string(i), "R0", "B0", "D0", "2099-01-01",
+                           timeForMinutes(i * 60), timeForMinutes(i * 60 + 30));
+            scheduleManager.addSchedule(extra);
+        } });
+    double commit = timeMilliseconds([&]()
+                                     { flusher.flush(); });
+    for (int i = 0; i < mutations; ++i)
+    {
+        scheduleManager.removeSchedule("BENCH_S" + to_string(i));
+    }
+    flusher.flush();
+
+    cout.rdbuf(originalCout);
+    filesystem::remove(dataFile("schedules.txt.log"));
+
+    logResult("Full schedules.txt rewrite (old per-edit cost)", rewrite);
+    logResult("addSchedule with log append", append / mutations, "per mutation, includes validation");
+    logResult("Group commit of those mutations (log fsync)", commit, speedupNote(rewrite, commit) + " faster than a rewrite");
+}
+
+void BenchmarkRunner::benchmarkBatchImport()
+{
+    printBenchmarkHeader("IMPORTING A DAY OF TRIPS (addSchedule EACH vs ONE TRANSACTION)");
+
+    const size_t trips = 5000;
+    const size_t resources = trips / 10;
+    vector<Route> routes = {Route("IMP_R0", "Stop A", "Stop B", {}, 60)};
+    vector<Bus> buses;
+    vector<Driver> drivers;
+    for (size_t i = 0; i < resources; ++i)
+    {
+        buses.emplace_back("IMP_B" + to_string(i), 50, "Model", "Active");
+        drivers.emplace_back("IMP_D" + to_string(i), "Driver " + to_string(i), "555-0100", "Class A");
+    }
+    auto tripOn = [trips, resources](size_t i, const string &date)
+    {
+        int departure = 5 * 60 + static_cast<int>(i % trips / resources) * 90;
+        return Schedule("IMP_S" + to_string(i), "IMP_R0", "IMP_B" + to_string(i % resources),
+                        "IMP_D" + to_string(i % resources), date, timeForMinutes(departure),
+                        timeForMinutes(departure + 80));
+    };
+
+    streambuf *originalCout = cout.rdbuf(nullptr);
+    RouteManager routeManager(routes, dataFile("import_routes.txt"));
+    BusManager busManager(buses, dataFile("import_buses.txt"));
+    DriverManager driverManager(drivers, dataFile("import_drivers.txt"));
+    vector<Schedule> schedules;
+    ScheduleManager scheduleManager(schedules, routes, buses, drivers, dataFile("import_schedules.txt"));
+    scheduleManager.setReferenceLookups(routeManager, busManager, driverManager);
+
+    size_t added = 0;
+    double individual = timeMilliseconds([&]()
+                                         {
+        for (size_t i = 0; i < trips; ++i)
+        {
+            added += scheduleManager.addSchedule(tripOn(i, "2099-01-01"));
+        } });
+
+    bool committed = false;
+    double batched = timeMilliseconds([&]()
+                                      {
+        Transaction transaction(routeManager, busManager, driverManager, scheduleManager);
+        for (size_t i = 0; i < trips; ++i)
+        {
+            transaction.addSchedule(tripOn(trips + i, "2099-01-02"));
+        }
+        committed = transaction.commit(); });
+    cout.rdbuf(originalCout);
+
+    for (const char *name : {"import_routes.txt", "import_buses.txt", "import_drivers.txt", "import_schedules.txt"})
+    {
+        filesystem::remove(dataFile(name));
+        filesystem::remove(dataFile(string(name) + ".log"));
+    }
+
+    logResult("addSchedule x" + to_string(trips), individual, to_string(added) + " added, one log write each");
+    logResult("Transaction of " + to_string(trips) + " adds", batched,
+              string(committed ? "committed" : "rolled back") + ", one log write, " + speedupNote(individual, batched));
+}
+
+// The pre-index lookup: a find_if scan per ID.
+template <typename T>
+static size_t linearLookups(const vector<T> &entities, const vector<EntityId> &ids, size_t count)
+{
+    size_t found = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const EntityId &id = ids[i];
+        auto it = find_if(entities.begin(), entities.end(),
+                          [&id](const T &entity)
+                          { return entity.getId() == id; });
+        found += (it != entities.end());
+    }
+    return found;
+}
+
+template <typename FindFn>
+static size_t indexedLookups(const vector<EntityId> &ids, FindFn find)
+{
+    size_t found = 0;
+    for (const auto &id : ids)
+    {
+        found += (find(id) != nullptr);
+    }
+    return found;
+}
+
+static string perLookupNote(double linear, size_t linearCount, double indexed, size_t indexedCount)
+{
+    double linearEach = linear * 1000.0 / linearCount;
+    double indexedEach = indexed * 1000.0 / indexedCount;
+    ostringstream note;
+    note << fixed << setprecision(3) << linearEach << " vs " << indexedEach << " us per lookup, "
+         << setprecision(0) << linearEach / max(indexedEach, 1e-9) << "x";
+    return note.str();
+}
+
+void BenchmarkRunner::benchmarkLookups()
+{
+    printBenchmarkHeader("ID LOOKUPS (LINEAR SCAN vs HASH INDEX)");
+
+    const size_t entityCount = LOOKUP_ENTITY_COUNT;
+    const size_t tripsPerDay = entityCount * 8;
+    vector<Bus> buses;
+    vector<Driver> drivers;
+    vector<Route> routes;
+    vector<Schedule> schedules;
+
+    double generation = timeMilliseconds([&]()
+                                         {
+        buses.reserve(entityCount);
+        drivers.reserve(entityCount);
+        for (size_t i = 0; i < entityCount; ++i)
+        {
+            buses.emplace_back("B" + to_string(i), 50, "Model", "Active");
+            drivers.emplace_back("D" + to_string(i), "Driver " + to_string(i), "555-0100", "Class A");
+        }
+        for (size_t i = 0; i < routeCount; ++i)
+        {
+            routes.emplace_back("R" + to_string(i), "Stop A", "Stop B", vector<string>(), 60);
+        }
+
+        schedules.reserve(lookupScheduleCount);
+        string date;
+        for (size_t i = 0; i < lookupScheduleCount; ++i)
+        {
+            size_t slot = i % tripsPerDay;
+            if (slot == 0)
+            {
+                date = dateForDay(i / tripsPerDay);
+            }
+            size_t resource = slot % entityCount;
+            int departure = 6 * 60 + static_cast<int>(slot / entityCount) * 120;
+            schedules.emplace_back("S" + to_string(i), "R" + to_string(i % routeCount),
+                                   "B" + to_string(resource), "D" + to_string(resource), date,
+                                   timeForMinutes(departure), timeForMinutes(departure + 90));
+        } });
+    cout << "  " << entityCount << " buses, " << entityCount << " drivers, " << lookupScheduleCount
+         << " schedules" << endl;
+    logResult("In-memory generation", generation);
+
+    // Manager construction now includes building the ID index.
+    streambuf *originalCout = cout.rdbuf(nullptr);
+    unique_ptr<RouteManager> routeManager;
+    unique_ptr<BusManager> busManager;
+    unique_ptr<DriverManager> driverManager;
+    unique_ptr<ScheduleManager> scheduleManager;
+    double build = timeMilliseconds([&]()
+                                    {
+        routeManager = make_unique<RouteManager>(routes, dataFile("lookup_routes.txt"));
+        busManager = make_unique<BusManager>(buses, dataFile("lookup_buses.txt"));
+        driverManager = make_unique<DriverManager>(drivers, dataFile("lookup_drivers.txt"));
+        scheduleManager = make_unique<ScheduleManager>(schedules, routes, buses, drivers,
+                                                       dataFile("lookup_schedules.txt")); });
+    cout.rdbuf(originalCout);
+    logResult("Manager construction (index build)", build);
+
+    mt19937_64 random(42);
+    auto sampleIds = [&random](const char *prefix, size_t range, size_t count)
+    {
+        vector<EntityId> ids;
+        ids.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            ids.emplace_back(prefix + to_string(random() % range));
+        }
+        return ids;
+    };
+
+    const size_t entityScans = 1000;
+    const size_t scheduleScans = 20;
+    size_t found = 0;
+
+    vector<EntityId> busIds = sampleIds("B", entityCount, 100000);
+    double linear = timeMilliseconds([&]()
+                                     { found += linearLookups(buses, busIds, entityScans); });
+    double indexed = timeMilliseconds([&]()
+                                      { found += indexedLookups(busIds, [&](const EntityId &id)
+                                                                { return busManager->findBus(id); }); });
+    logResult("findBus linear x" + to_string(entityScans), linear);
+    logResult("findBus indexed x" + to_string(busIds.size()), indexed,
+              perLookupNote(linear, entityScans, indexed, busIds.size()));
+
+    vector<EntityId> driverIds = sampleIds("D", entityCount, 100000);
+    linear = timeMilliseconds([&]()
+                              { found += linearLookups(drivers, driverIds, entityScans); });
+    indexed = timeMilliseconds([&]()
+                               { found += indexedLookups(driverIds, [&](const EntityId &id)
+                                                         { return driverManager->findDriver(id); }); });
+    logResult("findDriver linear x" + to_string(entityScans), linear);
+    logResult("findDriver indexed x" + to_string(driverIds.size()), indexed,
+              perLookupNote(linear, entityScans, indexed, driverIds.size()));
+
+    vector<EntityId> scheduleIds = sampleIds("S", lookupScheduleCount, 1000000);
+    linear = timeMilliseconds([&]()
+                              { found += linearLookups(schedules, scheduleIds, scheduleScans); });
+    // Hashing and comparing fixed-width IDs never allocates.
+    size_t allocationsBefore = AllocationCounter::count();
+    indexed = timeMilliseconds([&]()
+                               { found += indexedLookups(scheduleIds, [&](const EntityId &id)
+                                                         { return scheduleManager->findSchedule(id); }); });
+    size_t lookupAllocations = AllocationCounter::count() - allocationsBefore;
+    logResult("findSchedule linear x" + to_string(scheduleScans), linear);
+    logResult("findSchedule indexed x" + to_string(scheduleIds.size()), indexed,
+              perLookupNote(linear, scheduleScans, indexed, scheduleIds.size()));
+
+    cout << "  " << found << " lookups matched, " << lookupAllocations
+         << " heap allocations during indexed schedule lookups" << endl;
+}
+
+void BenchmarkRunner::benchmarkTimetableBuild()
+{
+    printBenchmarkHeader("TIMETABLE BUILD (addSchedule OVERLAP CHECKS)");
+
+    vector<Bus> buses;
+    vector<Driver> drivers;
+    vector<Route> routes;
+    vector<Schedule> schedules;
+    for (size_t i = 0; i < busCount; ++i)
+    {
+        buses.emplace_back("B" + to_string(i), 50, "Model", "Active");
+        drivers.emplace_back("D" + to_string(i), "Driver " + to_string(i), "555-0100", "Class A");
+    }
+    for (size_t i = 0; i < routeCount; ++i)
+    {
+        routes.emplace_back("R" + to_string(i), "Stop A", "Stop B", vector<string>(), 60);
+    }
+
+    const string timetableFile = dataFile("timetable_schedules.txt");
+    RouteManager routeManager(routes, dataFile("timetable_routes.txt"));
+    BusManager busManager(buses, dataFile("timetable_buses.txt"));
+    DriverManager driverManager(drivers, dataFile("timetable_drivers.txt"));
+    ScheduleManager scheduleManager(schedules, routes, buses, drivers, timetableFile);
+    scheduleManager.setReferenceLookups(routeManager, busManager, driverManager);
+    scheduleManager.setCompactionThreshold(SIZE_MAX);
+
+    // Same shape as the generated data set; every add passes all checks.
+    size_t trips = min<size_t>(scheduleCount, 200000);
+    size_t tripsPerDay = busCount * 8;
+    size_t added = 0;
+    streambuf *originalCout = cout.rdbuf(nullptr);
+    double elapsed = timeMilliseconds([&]()
+                                      {
+        for (size_t i = 0; i < trips; ++i)
+        {
+            size_t slot = i % tripsPerDay;
+            size_t resource = slot % busCount;
+            int departure = 6 * 60 + static_cast<int>(slot / busCount) * 120;
+            Schedule trip("S" + to_string(i), "R" + to_string(i % routeCount), "B" + to_string(resource),
+                          "D" + to_string(resource), dateForDay(i / tripsPerDay),
+                          timeForMinutes(departure), timeForMinutes(departure + 90));
+            added += scheduleManager.addSchedule(trip);
+        } });
+    cout.rdbuf(originalCout);
+    filesystem::remove(timetableFile + ".log");
+
+    ostringstream note;
+    note << added << " trips, " << fixed << setprecision(2) << elapsed * 1000.0 / max<size_t>(trips, 1)
+         << " us per add";
+    logResult("Bulk addSchedule", elapsed, note.str());
+}
+
+void BenchmarkRunner::benchmarkScans()
+{
+    printBenchmarkHeader("SCHEDULE SCANS (ROW LOOPS vs COLUMN KERNELS)");
+
+    // Same shape as the generated data set, built in memory.
+    const size_t tripsPerDay = busCount * 8;
+    vector<Schedule> schedules;
+    schedules.reserve(scheduleCount);
+    for (size_t i = 0; i < scheduleCount; ++i)
+    {
+        size_t slot = i % tripsPerDay;
+        size_t resource = slot % busCount;
+        int16_t departure = static_cast<int16_t>(6 * 60 + (slot / busCount) * 120);
+        schedules.emplace_back("S" + to_string(i), "R" + to_string(i % routeCount), "B" + to_string(resource),
+                               "D" + to_string(resource), static_cast<int32_t>(20000 + i / tripsPerDay),
+                               departure, static_cast<int16_t>(departure + 90));
+    }
+
+    ScheduleStore store;
+    double build = timeMilliseconds([&]()
+                                    { store.rebuild(schedules); });
+    logResult("ScheduleStore::rebuild", build, to_string(scheduleCount) + " rows");
+
+    const int repeats = 10;
+    const int32_t day = 20000 + static_cast<int32_t>(scheduleCount / tripsPerDay / 2);
+    const Symbol bus = SymbolTable::intern("B" + to_string(busCount / 2));
+    const int16_t from = 8 * 60;
+    const int16_t to = 12 * 60;
+    size_t loopMatches = 0;
+
+    // The previous implementation: test each Schedule and copy the matches.
+    double loopDay = timeMilliseconds([&]()
+                                      {
+        for (int r = 0; r < repeats; ++r)
+        {
+            vector<Schedule> result;
+            for (const auto &schedule : schedules)
+            {
+                if (schedule.getDay() == day)
+                {
+                    result.push_back(schedule);
+                }
+            }
+            loopMatches += result.size();
+        } });
+    double loopBus = timeMilliseconds([&]()
+                                      {
+        for (int r = 0; r < repeats; ++r)
+        {
+            vector<Schedule> result;
+            for (const auto &schedule : schedules)
+            {
+                if (schedule.getBusSymbol() == bus)
+                {
+                    result.push_back(schedule);
+                }
+            }
+            loopMatches += result.size();
+        } });
+    double loopWindow = timeMilliseconds([&]()
+                                         {
+        for (int r = 0; r < repeats; ++r)
+        {
+            vector<Schedule> result;
+            for (const auto &schedule : schedules)
+            {
+                if (schedule.getDay() == day && schedule.getDepartureMinutes() >= from &&
+                    schedule.getDepartureMinutes() <= to)
+                {
+                    result.push_back(schedule);
+                }
+            }
+            loopMatches += result.size();
+        } });
+    logResult("By day, loop + push_back x" + to_string(repeats), loopDay);
+    logResult("By bus, loop + push_back x" + to_string(repeats), loopBus);
+    logResult("Departing 08:00-12:00 on a day, loop x" + to_string(repeats), loopWindow);
+
+    const ScanKernels::Level supported = ScanKernels::supportedLevel();
+    for (int level = 0; level <= static_cast<int>(supported); ++level)
+    {
+        ScanKernels::setLevel(static_cast<ScanKernels::Level>(level));
+        const string name = ScanKernels::levelName(ScanKernels::getLevel());
+        size_t kernelMatches = 0;
+
+        double bitmapDay = timeMilliseconds([&]()
+                                            {
+            for (int r = 0; r < repeats; ++r)
+            {
+                kernelMatches += ScanKernels::countSelected(store.matchDay(day));
+            } });
+        double rowsDay = timeMilliseconds([&]()
+                                          {
+            for (int r = 0; r < repeats; ++r)
+            {
+                store.selectByDay(day);
+            } });
+        double rowsBus = timeMilliseconds([&]()
+                                          {
+            for (int r = 0; r < repeats; ++r)
+            {
+                kernelMatches += store.selectByBus(bus).size();
+            } });
+        double rowsWindow = timeMilliseconds([&]()
+                                             {
+            for (int r = 0; r < repeats; ++r)
+            {
+                kernelMatches += store.selectDepartingBetween(day, from, to).size();
+            } });
+
+        logResult("By day, " + name + " bitmap", bitmapDay, speedupNote(loopDay, bitmapDay));
+        logResult("By day, " + name + " row list", rowsDay, speedupNote(loopDay, rowsDay));
+        logResult("By bus, " + name + " row list", rowsBus, speedupNote(loopBus, rowsBus));
+        logResult("Departing 08:00-12:00, " + name + " row list", rowsWindow, speedupNote(loopWindow, rowsWindow));
+        if (kernelMatches != loopMatches)
+        {
+            cout << "  " << name << " results differ: " << kernelMatches << " vs " << loopMatches << endl;
+        }
+    }
+    ScanKernels::setLevel(supported);
+
+    // Driver AND date: the old dashboard copied the driver's schedules and
+    // filtered that copy by date; a query view does both in one pass.
+    const string driverId = "D" + to_string(busCount / 2);
+    const string date = Schedule::formatDate(day);
+    size_t copied = 0;
+    size_t viewed = 0;
+    double copyThenFilter = timeMilliseconds([&]()
+                                             {
+        for (int r = 0; r < repeats; ++r)
+        {
+            vector<Schedule> byDriver;
+            for (const auto &schedule : schedules)
+            {
+                if (schedule.getDriverId() == driverId)
+                {
+                    byDriver.push_back(schedule);
+                }
+            }
+            vector<Schedule> onDate;
+            for (const auto &schedule : byDriver)
+            {
+                if (schedule.getDay() == day)
+                {
+                    onDate.push_back(schedule);
+                }
+            }
+            copied += onDate.size();
+        } });
+    double queryView = timeMilliseconds([&]()
+                                        {
+        for (int r = 0; r < repeats; ++r)
+        {
+            ScheduleView view(schedules, ScheduleQuery().driver(driverId).date(date).select(store));
+            viewed += view.size();
+        } });
+    logResult("Driver AND date, copy then filter x" + to_string(repeats), copyThenFilter);
+    logResult("Driver AND date, query view x" + to_string(repeats), queryView,
+              speedupNote(copyThenFilter, queryView));
+    if (copied != viewed)
+    {
+        cout << "  Driver and date results differ: " << copied << " vs " << viewed << endl;
+    }
+}
+
+void BenchmarkRunner::benchmarkRemovals()
+{
+    printBenchmarkHeader("REMOVALS (VECTOR ERASE vs SLOT MAP)");
+
+    const size_t tripsPerDay = busCount * 8;
+    vector<Schedule> schedules;
+    schedules.reserve(scheduleCount);
+    for (size_t i = 0; i < scheduleCount; ++i)
+    {
+        size_t slot = i % tripsPerDay;
+        size_t resource = slot % busCount;
+        int16_t departure = static_cast<int16_t>(6 * 60 + (slot / busCount) * 120);
+        schedules.emplace_back("S" + to_string(i), "R" + to_string(i % routeCount), "B" + to_string(resource),
+                               "D" + to_string(resource), static_cast<int32_t>(20000 + i / tripsPerDay),
+                               departure, static_cast<int16_t>(departure + 90));
+    }
+
+    const size_t removals = min<size_t>(1000, scheduleCount / 2);
+    mt19937_64 random(42);
+
+    // The previous layout: erase shifts every later schedule down one place.
+    vector<Schedule> shifted = schedules;
+    double erase = timeMilliseconds([&]()
+                                    {
+        for (size_t i = 0; i < removals; ++i)
+        {
+            shifted.erase(shifted.begin() + random() % shifted.size());
+        } });
+    logResult("vector::erase x" + to_string(removals), erase, to_string(scheduleCount) + " rows");
+
+    SlotMap<Schedule> slots(schedules);
+    vector<SlotMap<Schedule>::Handle> handles;
+    handles.reserve(schedules.size());
+    for (size_t i = 0; i < schedules.size(); ++i)
+    {
+        handles.push_back(slots.handleAt(i));
+    }
+    shuffle(handles.begin(), handles.end(), random);
+
+    double slotErase = timeMilliseconds([&]()
+                                        {
+        for (size_t i = 0; i < removals; ++i)
+        {
+            slots.erase(handles[i]);
+        } });
+    logResult("SlotMap::erase x" + to_string(removals), slotErase, speedupNote(erase, slotErase));
+
+    size_t resolved = 0;
+    size_t stale = 0;
+    double lookups = timeMilliseconds([&]()
+                                      {
+        for (const auto &handle : handles)
+        {
+            if (slots.get(handle))
+            {
+                resolved++;
+            }
+            else
+            {
+                stale++;
+            }
+        } });
+    logResult("SlotMap::get x" + to_string(handles.size()), lookups,
+              to_string(stale) + " stale handles detected");
+    cout << "  " << resolved << " handles still resolve" << endl;
+}
+
+void BenchmarkRunner::benchmarkAudit()
+{
+    printBenchmarkHeader("TIMETABLE AUDIT (PER-ROW INDEX CHECK vs SWEEP LINE)");
+
+    // Every 997th trip runs an hour late into its bus and driver's next trip.
+    const size_t tripsPerDay = busCount * 8;
+    vector<Schedule> schedules;
+    schedules.reserve(scheduleCount);
+    for (size_t i = 0; i < scheduleCount; ++i)
+    {
+        size_t slot = i % tripsPerDay;
+        size_t resource = slot % busCount;
+        int16_t departure = static_cast<int16_t>(6 * 60 + (slot / busCount) * 120 + (i % 997 == 0 ? 60 : 0));
+        schedules.emplace_back("S" + to_string(i), "R" + to_string(i % routeCount), "B" + to_string(resource),
+                               "D" + to_string(resource), static_cast<int32_t>(20000 + i / tripsPerDay),
+                               departure, static_cast<int16_t>(departure + 90));
+    }
+    ScheduleStore store;
+    store.rebuild(schedules);
+
+    // What the add-time checks offer: one overlap per schedule, at most.
+    size_t flagged = 0;
+    double perRow = timeMilliseconds([&]()
+                                     {
+        IntervalIndex busIntervals;
+        IntervalIndex driverIntervals;
+        for (const auto &schedule : schedules)
+        {
+            IntervalIndex::Interval interval{schedule.getDepartureMinutes(), schedule.getArrivalMinutes(),
+                                             schedule.getId()};
+            busIntervals.insert(schedule.getBusSymbol(), schedule.getDay(), interval);
+            driverIntervals.insert(schedule.getDriverSymbol(), schedule.getDay(), interval);
+        }
+        for (const auto &schedule : schedules)
+        {
+            flagged += busIntervals.findOverlap(schedule.getBusSymbol(), schedule.getDay(),
+                                                schedule.getDepartureMinutes(), schedule.getArrivalMinutes(),
+                                                schedule.getId()) != nullptr;
+            flagged += driverIntervals.findOverlap(schedule.getDriverSymbol(), schedule.getDay(),
+                                                   schedule.getDepartureMinutes(), schedule.getArrivalMinutes(),
+                                                   schedule.getId()) != nullptr;
+        } });
+    logResult("IntervalIndex build + findOverlap per row", perRow,
+              to_string(flagged) + " rows flagged, pairs not listed");
+
+    unsigned hardwareThreads = max(1u, thread::hardware_concurrency());
+    double singleThread = 0;
+    for (unsigned threads = 1; threads <= max(4u, hardwareThreads); threads *= 2)
+    {
+        TimetableAudit::Report report;
+        double elapsed = timeMilliseconds([&]()
+                                          { report = TimetableAudit::run(schedules, store, threads); });
+        if (threads == 1)
+        {
+            singleThread = elapsed;
+        }
+        ostringstream note;
+        note << report.count(TimetableAudit::Resource::Bus) << " bus + "
+             << report.count(TimetableAudit::Resource::Driver) << " driver pairs, " << fixed << setprecision(2)
+             << singleThread / elapsed << "x vs 1 thread";
+        logResult("TimetableAudit::run [" + to_string(threads) + " threads]", elapsed, note.str());
+    }
+}
+
+void BenchmarkRunner::benchmarkJourneyPlanner()
+{
+    printBenchmarkHeader("JOURNEY PLANNING (RAPTOR OVER DATED TRIPS)");
+
+    const size_t plannerRoutes = 10000;
+    const size_t stopNames = 2000;
+    const size_t stopsPerRoute = 8;
+    const size_t days = 7;
+    mt19937_64 random(42);
+
+    vector<Route> routes;
+    routes.reserve(plannerRoutes);
+    for (size_t r = 0; r < plannerRoutes; ++r)
+    {
+        vector<string> keyStops;
+        for (size_t s = 0; s < stopsPerRoute; ++s)
+        {
+            keyStops.push_back("Stop " + to_string(random() % stopNames));
+        }
+        routes.emplace_back("R" + to_string(r), "Stop " + to_string(random() % stopNames),
+                            "Stop " + to_string(random() % stopNames), keyStops, 60);
+    }
+
+    // Each route runs at one of two speeds between 05:00 and 22:00.
+    vector<Schedule> trips;
+    trips.reserve(scheduleCount);
+    for (size_t i = 0; i < scheduleCount; ++i)
+    {
+        size_t route = i % plannerRoutes;
+        int16_t departure = static_cast<int16_t>(5 * 60 + random() % (17 * 60));
+        int16_t duration = static_cast<int16_t>(40 + (route % 5) * 10 + (i % 2) * 15);
+        trips.emplace_back("S" + to_string(i), "R" + to_string(route), "B0", "D0",
+                           static_cast<int32_t>(20000 + (i / plannerRoutes) % days), departure,
+                           static_cast<int16_t>(departure + duration));
+    }
+
+    JourneyPlanner planner;
+    double build = timeMilliseconds([&]()
+                                    { planner.build(routes, trips); });
+    logResult("Build (" + to_string(planner.stopCount()) + " stops, " + to_string(planner.patternCount()) +
+                  " patterns)",
+              build, to_string(planner.tripCount()) + " trips");
+
+    const size_t queries = 200;
+    vector<pair<string, string>> pairs;
+    for (size_t q = 0; q < queries; ++q)
+    {
+        pairs.emplace_back("Stop " + to_string(random() % stopNames), "Stop " + to_string(random() % stopNames));
+    }
+    size_t found = 0;
+    size_t transfers = 0;
+    double elapsed = timeMilliseconds([&]()
+                                      {
+        for (const auto &query : pairs)
+        {
+            vector<JourneyPlanner::Itinerary> itineraries =
+                planner.plan(query.first, query.second, 20000, static_cast<int16_t>(8 * 60));
+            if (!itineraries.empty())
+            {
+                found++;
+                transfers += itineraries.back().transfers();
+            }
+        } });
+    ostringstream note;
+    note << fixed << setprecision(3) << elapsed / queries << " ms per query, " << found << " answered, "
+         << setprecision(2) << static_cast<double>(transfers) / max<size_t>(found, 1) << " transfers on average";
+    logResult("plan x" + to_string(queries), elapsed, note.str());
+}
+
+void BenchmarkRunner::benchmarkDepartureBoard()
+{
+    printBenchmarkHeader("PER-STOP DEPARTURE BOARDS");
+
+    const size_t boardRoutes = 10000;
+    const size_t stopNames = 2000;
+    const size_t stopsPerRoute = 8;
+    mt19937_64 random(42);
+
+    vector<Route> routes;
+    routes.reserve(boardRoutes);
+    for (size_t r = 0; r < boardRoutes; ++r)
+    {
+        vector<string> keyStops;
+        for (size_t s = 0; s < stopsPerRoute; ++s)
+        {
+            keyStops.push_back("Stop " + to_string(random() % stopNames));
+        }
+        routes.emplace_back("R" + to_string(r), "Stop " + to_string(random() % stopNames),
+                            "Stop " + to_string(random() % stopNames), keyStops, 60);
+    }
+
+    vector<Schedule> trips;
+    trips.reserve(scheduleCount);
+    for (size_t i = 0; i < scheduleCount; ++i)
+    {
+        int16_t departure = static_cast<int16_t>(5 * 60 + random() % (17 * 60));
+        trips.emplace_back("S" + to_string(i), "R" + to_string(i % boardRoutes), "B0", "D0",
+                           static_cast<int32_t>(20000 + random() % 7), departure,
+                           static_cast<int16_t>(departure + 60));
+    }
+    SlotMap<Schedule> slots(trips);
+
+    DepartureBoard board;
+    double build = timeMilliseconds([&]()
+                                    { board.build(routes, trips, slots); });
+    logResult("build", build, to_string(board.departureCount()) + " departures");
+
+    // Baseline: join every schedule with its route's stops for each query.
+    unordered_map<Symbol, vector<Symbol>> stopsByRoute;
+    for (const auto &route : routes)
+    {
+        vector<Symbol> &stops = stopsByRoute[SymbolTable::intern(route.getId().view())];
+        stops.push_back(SymbolTable::intern(route.getOrigin()));
+        stops.insert(stops.end(), route.getKeyStopSymbols().begin(), route.getKeyStopSymbols().end());
+    }
+    const size_t scanQueries = 5;
+    size_t scanned = 0;
+    double scan = timeMilliseconds([&]()
+                                   {
+        for (size_t q = 0; q < scanQueries; ++q)
+        {
+            Symbol stop = SymbolTable::intern("Stop " + to_string(q));
+            int32_t after = 20000 * DepartureBoard::MINUTES_PER_DAY + 8 * 60;
+            vector<int32_t> times;
+            for (const auto &trip : trips)
+            {
+                const vector<Symbol> &stops = stopsByRoute[trip.getRouteSymbol()];
+                int32_t start = trip.getDay() * DepartureBoard::MINUTES_PER_DAY + trip.getDepartureMinutes();
+                for (size_t k = 0; k < stops.size(); ++k)
+                {
+                    int32_t time = start + 60 * static_cast<int32_t>(k) / static_cast<int32_t>(stops.size());
+                    if (stops[k] == stop && time >= after)
+                    {
+                        times.push_back(time);
+                    }
+                }
+            }
+            size_t count = min<size_t>(times.size(), 5);
+            partial_sort(times.begin(), times.begin() + count, times.end());
+            scanned += count;
+        } });
+    double scanPerQuery = scan / scanQueries;
+    logResult("Scan every schedule x" + to_string(scanQueries), scan, to_string(scanned) + " departures");
+
+    const size_t queries = 100000;
+    size_t found = 0;
+    double elapsed = timeMilliseconds([&]()
+                                      {
+        for (size_t q = 0; q < queries; ++q)
+        {
+            found += board.next("Stop " + to_string(q % stopNames), 20000 + static_cast<int32_t>(q % 7),
+                                static_cast<int16_t>(q % (24 * 60)), 5).size();
+        } });
+    ostringstream note;
+    note << fixed << setprecision(2) << elapsed * 1000.0 / queries << " us per query, "
+         << speedupNote(scanPerQuery * queries, elapsed);
+    logResult("next(K = 5) x" + to_string(queries), elapsed, note.str());
+
+    // Retiming a trip moves it on every board it appears on.
+    const size_t changes = 10000;
+    double update = timeMilliseconds([&]()
+                                     {
+        for (size_t c = 0; c < changes; ++c)
+        {
+            size_t row = random() % trips.size();
+            DepartureBoard::Handle handle = slots.handleAt(row);
+            board.erase(trips[row], handle);
+            int16_t departure = static_cast<int16_t>(5 * 60 + random() % (17 * 60));
+            trips[row].setDepartureTime(Schedule::formatTime(departure));
+            board.insert(trips[row], handle);
+        } });
+    ostringstream updateNote;
+    updateNote << fixed << setprecision(2) << update * 1000.0 / changes << " us per change";
+    logResult("erase + insert x" + to_string(changes), update, updateNote.str());
+}
+
+void BenchmarkRunner::benchmarkAvailability()
+{
+    printBenchmarkHeader("FREE BUS AND DRIVER LOOKUP");
+
+    const size_t resourceCount = 50000;
+    const int32_t days = 7;
+    mt19937_64 random(42);
+
+    vector<Symbol> resources(resourceCount);
+    for (size_t r = 0; r < resourceCount; ++r)
+    {
+        resources[r] = SymbolTable::intern("AV" + to_string(r));
+    }
+
+    struct Booking
+    {
+        Symbol resource;
+        int32_t day;
+        int16_t start;
+        int16_t end;
+    };
+    vector<Booking> bookings(scheduleCount);
+    for (auto &booking : bookings)
+    {
+        booking.resource = resources[random() % resourceCount];
+        booking.day = 20000 + static_cast<int32_t>(random() % days);
+        booking.start = static_cast<int16_t>(5 * 60 + random() % (17 * 60));
+        booking.end = static_cast<int16_t>(booking.start + 30 + random() % 90);
+    }
+
+    AvailabilityIndex bitmaps;
+    double build = timeMilliseconds([&]()
+                                    {
+        for (const auto &booking : bookings)
+        {
+            bitmaps.occupy(booking.resource, booking.day, booking.start, booking.end);
+        }
+        bitmaps.setRoster(resources); });
+    logResult("build", build, to_string(bitmaps.rowCount()) + " busy resource-days");
+
+    // Baseline: an overlap check per resource against the interval index.
+    IntervalIndex intervals;
+    for (size_t b = 0; b < bookings.size(); ++b)
+    {
+        intervals.insert(bookings[b].resource, bookings[b].day,
+                         {bookings[b].start, bookings[b].end, EntityId("S" + to_string(b))});
+    }
+    const size_t queries = 50;
+    auto window = [](size_t q, int16_t &start, int16_t &end)
+    {
+        start = static_cast<int16_t>(6 * 60 + (q * 37) % (14 * 60));
+        end = static_cast<int16_t>(start + 90);
+    };
+    size_t probed = 0;
+    double probe = timeMilliseconds([&]()
+                                    {
+        for (size_t q = 0; q < queries; ++q)
+        {
+            int16_t start;
+            int16_t end;
+            window(q, start, end);
+            for (Symbol resource : resources)
+            {
+                probed += intervals.findOverlap(resource, 20000 + static_cast<int32_t>(q % days), start, end) ==
+                          nullptr;
+            }
+        } });
+    logResult("Overlap check per resource x" + to_string(queries), probe, to_string(probed) + " free");
+
+    size_t found = 0;
+    double elapsed = timeMilliseconds([&]()
+                                      {
+        for (size_t q = 0; q < queries; ++q)
+        {
+            int16_t start;
+            int16_t end;
+            window(q, start, end);
+            found += bitmaps.findFree(20000 + static_cast<int32_t>(q % days), start, end).size();
+        } });
+    ostringstream note;
+    note << fixed << setprecision(1) << elapsed * 1000.0 / queries << " us per query, " << found << " free, "
+         << speedupNote(probe, elapsed);
+    logResult("findFree x" + to_string(queries), elapsed, note.str());
+}
+
+void BenchmarkRunner::benchmarkAssignment()
+{
+    printBenchmarkHeader("AUTOMATIC BUS AND DRIVER ASSIGNMENT");
+
+    const size_t rosterSize = 50000;
+    const int32_t days = 7;
+    size_t tripCount = min<size_t>(scheduleCount, 500000);
+    mt19937_64 random(42);
+
+    vector<Symbol> buses(rosterSize);
+    vector<Symbol> drivers(rosterSize);
+    for (size_t r = 0; r < rosterSize; ++r)
+    {
+        buses[r] = SymbolTable::intern("AB" + to_string(r));
+        drivers[r] = SymbolTable::intern("AD" + to_string(r));
+    }
+
+    // A week of new trips on rosters with nothing else booked, so the
+    // buses used should equal the most trips running at once on one day.
+    vector<Schedule> trips;
+    trips.reserve(tripCount);
+    for (size_t i = 0; i < tripCount; ++i)
+    {
+        int16_t departure = static_cast<int16_t>(5 * 60 + random() % (17 * 60));
+        trips.emplace_back("T" + to_string(i), "R0", "", "", static_cast<int32_t>(20000 + random() % days),
+                           departure, static_cast<int16_t>(departure + 30 + random() % 90));
+    }
+
+    unsigned hardwareThreads = max(1u, thread::hardware_concurrency());
+    double singleThread = 0;
+    for (unsigned threads = 1; threads <= max(4u, hardwareThreads); threads *= 2)
+    {
+        AssignmentPlanner::Report report;
+        double elapsed = timeMilliseconds([&]()
+                                          { report = AssignmentPlanner::run(trips, {}, buses, drivers, threads); });
+        if (threads == 1)
+        {
+            singleThread = elapsed;
+        }
+        ostringstream note;
+        note << report.assigned.size() << " trips, " << report.busesUsed << " buses, " << report.driversUsed
+             << " drivers, " << fixed << setprecision(2) << singleThread / elapsed << "x vs 1 thread";
+        logResult("AssignmentPlanner::run [" + to_string(threads) + " threads]", elapsed, note.str());
+    }
+}
+
+void BenchmarkRunner::benchmarkTravelTimes()
+{
+    printBenchmarkHeader("STOP-TO-STOP TRAVEL TIME MATRIX");
+
+    const size_t matrixRoutes = 3000;
+    const size_t stopNames = 1000;
+    const size_t stopsPerRoute = 8;
+    mt19937_64 random(42);
+
+    vector<Route> routes;
+    routes.reserve(matrixRoutes);
+    for (size_t r = 0; r < matrixRoutes; ++r)
+    {
+        vector<string> keyStops;
+        for (size_t s = 0; s < stopsPerRoute; ++s)
+        {
+            keyStops.push_back("Stop " + to_string(random() % stopNames));
+        }
+        routes.emplace_back("R" + to_string(r), "Stop " + to_string(random() % stopNames),
+                            "Stop " + to_string(random() % stopNames), keyStops,
+                            static_cast<int>(30 + random() % 120));
+    }
+
+    TravelTimeMatrix serial;
+    double serialBuild = timeMilliseconds([&]()
+                                          { serial.build(routes, 1); });
+    logResult("build [serial]", serialBuild,
+              to_string(serial.stopCount()) + " stops, " + to_string(matrixRoutes) + " routes");
+
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    TravelTimeMatrix matrix;
+    double parallelBuild = timeMilliseconds([&]()
+                                            { matrix.build(routes); });
+    logResult("build [hardware threads: " + to_string(threads) + "]", parallelBuild,
+              speedupNote(serialBuild, parallelBuild));
+
+    const string matrixFile = dataFile("travel_times.times");
+    double save = timeMilliseconds([&]()
+                                   { matrix.save(matrixFile, routes); });
+    logResult("save", save);
+    TravelTimeMatrix loaded;
+    bool reloaded = false;
+    double load = timeMilliseconds([&]()
+                                   { reloaded = loaded.load(matrixFile, routes); });
+    logResult("load", load, reloaded ? "fingerprint matched" : "rejected");
+    remove(matrixFile.c_str());
+
+    // Slowing one route and speeding up another, as updateRoute would.
+    const size_t updates = 10;
+    size_t rows = 0;
+    double update = timeMilliseconds([&]()
+                                     {
+        for (size_t u = 0; u < updates; ++u)
+        {
+            size_t position = random() % routes.size();
+            Route before = routes[position];
+            routes[position].setEstimatedTravelTime(before.getEstimatedTravelTime() + (u % 2 == 0 ? 30 : -20));
+            rows += matrix.update(routes, &before, &routes[position]);
+        } });
+    ostringstream updateNote;
+    updateNote << fixed << setprecision(1) << static_cast<double>(rows) / updates << " of " << matrix.stopCount()
+               << " rows recomputed on average, " << speedupNote(parallelBuild * updates, update) << " vs rebuilding";
+    logResult("update x" + to_string(updates), update, updateNote.str());
+
+    // The same kind of changes recorded as RouteManager does, then applied
+    // by the next query's single refresh.
+    size_t batchedRows = 0;
+    double batched = timeMilliseconds([&]()
+                                      {
+        for (size_t u = 0; u < updates; ++u)
+        {
+            size_t position = random() % routes.size();
+            Route before = routes[position];
+            routes[position].setEstimatedTravelTime(before.getEstimatedTravelTime() + (u % 2 == 0 ? 30 : -20));
+            matrix.recordChange(&before, &routes[position]);
+        }
+        batchedRows = matrix.refresh(routes); });
+    logResult("record x" + to_string(updates) + " + one refresh", batched,
+              to_string(batchedRows) + " rows recomputed, " + speedupNote(update, batched) + " vs updating each");
+
+    const size_t queries = 1000000;
+    vector<pair<string, string>> pairs;
+    for (size_t q = 0; q < 1000; ++q)
+    {
+        pairs.emplace_back("Stop " + to_string(random() % stopNames), "Stop " + to_string(random() % stopNames));
+    }
+    int64_t total = 0;
+    double elapsed = timeMilliseconds([&]()
+                                      {
+        for (size_t q = 0; q < queries; ++q)
+        {
+            const auto &query = pairs[q % pairs.size()];
+            total += matrix.travelTime(query.first, query.second);
+        } });
+    ostringstream note;
+    note << fixed << setprecision(1) << elapsed * 1e6 / queries << " ns per query (checksum " << total << ")";
+    logResult("travelTime x" + to_string(queries), elapsed, note.str());
+}
+
+void BenchmarkRunner::benchmarkAllocations()
+{
+    printBenchmarkHeader("HEAP ALLOCATIONS PER addSchedule");
+
+    vector<Bus> buses;
+    vector<Driver> drivers;
+    vector<Route> routes;
+    vector<Schedule> schedules;
+    for (size_t i = 0; i < busCount; ++i)
+    {
+        buses.emplace_back("B" + to_string(i), 50, "Model", "Active");
+        drivers.emplace_back("D" + to_string(i), "Driver " + to_string(i), "555-0100", "Class A");
+    }
+    for (size_t i = 0; i < routeCount; ++i)
+    {
+        routes.emplace_back("R" + to_string(i), "Stop A", "Stop B", vector<string>(), 60);
+    }
+
+    const string allocationFile = dataFile("allocation_schedules.txt");
+    RouteManager routeManager(routes, dataFile("allocation_routes.txt"));
+    BusManager busManager(buses, dataFile("allocation_buses.txt"));
+    DriverManager driverManager(drivers, dataFile("allocation_drivers.txt"));
+    ScheduleManager scheduleManager(schedules, routes, buses, drivers, allocationFile);
+    scheduleManager.setReferenceLookups(routeManager, busManager, driverManager);
+    scheduleManager.setCompactionThreshold(SIZE_MAX);
+
+    // Built up front so only the manager's own allocations are counted.
+    const size_t trips = min<size_t>(scheduleCount, 20000);
+    vector<Schedule> accepted;
+    vector<Schedule> rejected;
+    accepted.reserve(trips);
+    rejected.reserve(trips);
+    for (size_t i = 0; i < trips; ++i)
+    {
+        size_t resource = i % busCount;
+        int departure = 6 * 60 + static_cast<int>(i / busCount % 8) * 120;
+        string date = dateForDay(i / (busCount * 8));
+        accepted.emplace_back("S" + to_string(i), "R" + to_string(i % routeCount), "B" + to_string(resource),
+                              "D" + to_string(resource), date, timeForMinutes(departure),
+                              timeForMinutes(departure + 90));
+        rejected.emplace_back("X" + to_string(i), "R" + to_string(i % routeCount), "B" + to_string(resource),
+                              "D" + to_string(resource), date, timeForMinutes(departure + 30),
+                              timeForMinutes(departure + 60));
+    }
+    schedules.reserve(trips);
+
+    streambuf *originalCout = cout.rdbuf(nullptr);
+    size_t before = AllocationCounter::count();
+    for (const auto &trip : accepted)
+    {
+        scheduleManager.addSchedule(trip);
+    }
+    size_t acceptedAllocations = AllocationCounter::count() - before;
+
+    // Rejected by the overlap check: validation and lookups only.
+    before = AllocationCounter::count();
+    for (const auto &trip : rejected)
+    {
+        scheduleManager.addSchedule(trip);
+    }
+    size_t rejectedAllocations = AllocationCounter::count() - before;
+    cout.rdbuf(originalCout);
+    filesystem::remove(allocationFile + ".log");
+
+    cout << "  " << trips << " accepted and " << trips << " rejected adds" << endl;
+    cout << "  Allocations per accepted add:  " << fixed << setprecision(2)
+         << static_cast<double>(acceptedAllocations) / trips << endl;
+    cout << "  Allocations per rejected add:  " << fixed << setprecision(2)
+         << static_cast<double>(rejectedAllocations) / trips << endl;
+}
+
+// The entity layouts before interning, with every ID, stop and status
+// held as its own string, so the footprint benchmark can measure both in
+// one run.
+struct StringBus
+{
+    string id;
+    int capacity;
+    string model;
+    string status;
+};
+
+struct StringRoute
+{
+    string id;
+    string origin;
+    string destination;
+    vector<string> keyStops;
+    int estimatedTravelTime;
+};
+
+struct StringSchedule
+{
+    string id;
+    string routeId;
+    string busId;
+    string driverId;
+    int32_t day;
+    int16_t departure;
+    int16_t arrival;
+};
+
+void BenchmarkRunner::benchmarkFootprint()
+{
+    printBenchmarkHeader("MEMORY FOOTPRINT PER ENTITY");
+
+    const size_t entityCount = LOOKUP_ENTITY_COUNT;
+    const size_t tripsPerDay = entityCount * 8;
+    const size_t stopsPerRoute = 8;
+    const size_t stopNames = 500;
+
+    // Live heap bytes (vector storage, string text and interned symbols)
+    // held by the entities build() returns, which are freed before the next
+    // layout is built.
+    auto measure = [](auto build)
+    {
+        size_t before = AllocationCounter::liveBytes();
+        auto entities = build();
+        return AllocationCounter::liveBytes() - before;
+    };
+    auto busStatus = [](size_t i)
+    { return string(i % 10 == 0 ? "Maintenance" : "Active"); };
+    auto routeStops = [&](size_t i)
+    {
+        vector<string> stops;
+        for (size_t s = 0; s < stopsPerRoute; ++s)
+        {
+            stops.push_back("Stop " + to_string((i * 7 + s * 13) % stopNames));
+        }
+        return stops;
+    };
+    // Calls add(i, date, departure minute, resource) for every schedule.
+    auto forEachTrip = [&](auto add)
+    {
+        string date;
+        for (size_t i = 0; i < lookupScheduleCount; ++i)
+        {
+            size_t slot = i % tripsPerDay;
+            if (slot == 0)
+            {
+                date = dateForDay(i / tripsPerDay);
+            }
+            add(i, date, 6 * 60 + static_cast<int>(slot / entityCount) * 120, slot % entityCount);
+        }
+    };
+
+    size_t stringBusBytes = measure([&]()
+                                    {
+        vector<StringBus> buses;
+        buses.reserve(entityCount);
+        for (size_t i = 0; i < entityCount; ++i)
+        {
+            buses.push_back({"B" + to_string(i), 50, "Model", busStatus(i)});
+        }
+        return buses; });
+    size_t busBytes = measure([&]()
+                              {
+        vector<Bus> buses;
+        buses.reserve(entityCount);
+        for (size_t i = 0; i < entityCount; ++i)
+        {
+            buses.emplace_back("B" + to_string(i), 50, "Model", busStatus(i));
+        }
+        return buses; });
+
+    size_t stringRouteBytes = measure([&]()
+                                      {
+        vector<StringRoute> routes;
+        routes.reserve(entityCount);
+        for (size_t i = 0; i < entityCount; ++i)
+        {
+            routes.push_back({"R" + to_string(i), "Stop A", "Stop B", routeStops(i), 60});
+        }
+        return routes; });
+    size_t routeBytes = measure([&]()
+                                {
+        vector<Route> routes;
+        routes.reserve(entityCount);
+        for (size_t i = 0; i < entityCount; ++i)
+        {
+            routes.emplace_back("R" + to_string(i), "Stop A", "Stop B", routeStops(i), 60);
+        }
+        return routes; });
+
+    size_t stringScheduleBytes = measure([&]()
+                                         {
+        vector<StringSchedule> schedules;
+        schedules.reserve(lookupScheduleCount);
+        forEachTrip([&](size_t i, const string &date, int departure, size_t resource)
+                    { schedules.push_back({"S" + to_string(i), "R" + to_string(i % entityCount),
+                                           "B" + to_string(resource), "D" + to_string(resource),
+                                           Schedule::parseDate(date), static_cast<int16_t>(departure),
+                                           static_cast<int16_t>(departure + 90)}); });
+        return schedules; });
+    size_t scheduleBytes = measure([&]()
+                                   {
+        vector<Schedule> schedules;
+        schedules.reserve(lookupScheduleCount);
+        forEachTrip([&](size_t i, const string &date, int departure, size_t resource)
+                    { schedules.emplace_back("S" + to_string(i), "R" + to_string(i % entityCount),
+                                             "B" + to_string(resource), "D" + to_string(resource), date,
+                                             timeForMinutes(departure), timeForMinutes(departure + 90)); });
+        return schedules; });
+
+    auto report = [](const char *name, size_t stringInline, size_t inlineBytes, size_t stringBytes, size_t bytes,
+                     size_t count)
+    {
+        cout << "  " << left << setw(10) << name << right << setw(4) << stringInline << " -> " << setw(3)
+             << inlineBytes << " bytes inline, " << fixed << setprecision(1) << setw(6)
+             << static_cast<double>(stringBytes) / count << " -> " << setw(6) << static_cast<double>(bytes) / count
+             << " bytes in total" << endl;
+    };
+    cout << "  " << entityCount << " buses, " << entityCount << " routes (" << stopsPerRoute
+         << " stops each), " << lookupScheduleCount << " schedules" << endl;
+    cout << "  String fields (the layout before interning) -> symbols, per entity:" << endl;
+    report("Bus", sizeof(StringBus), sizeof(Bus), stringBusBytes, busBytes, entityCount);
+    report("Route", sizeof(StringRoute), sizeof(Route), stringRouteBytes, routeBytes, entityCount);
+    report("Schedule", sizeof(StringSchedule), sizeof(Schedule), stringScheduleBytes, scheduleBytes,
+           lookupScheduleCount);
+}
+
+void BenchmarkRunner::runAllBenchmarks()
+{
+    cout << "\n";
+    cout << "========================================" << endl;
+    cout << "  BUS MANAGEMENT SYSTEM BENCHMARKS" << endl;
+    cout << "========================================" << endl;
+
+    generateDataset();
+    benchmarkLoaders();
+    benchmarkParallelLoader();
+    benchmarkStartup();
+    benchmarkSnapshot();
+    benchmarkArenaLoading();
+    benchmarkMutationLog();
+    benchmarkBatchImport();
+    benchmarkLookups();
+    benchmarkTimetableBuild();
+    benchmarkScans();
+    benchmarkRemovals();
+    benchmarkAudit();
+    benchmarkJourneyPlanner();
+    benchmarkDepartureBoard();
+    benchmarkAvailability();
+    benchmarkAssignment();
+    benchmarkTravelTimes();
+    benchmarkAllocations();
+    benchmarkFootprint();
+}
@@ -3,11 +3,11 @@
 
 using namespace std;
 
-Bus::Bus() : id(""), capacity(0), model(""), status("Inactive") {}
-Bus::Bus(const string &id, int capacity, const string &model, const string &status)
-    : id(id), capacity(capacity), model(model), status(status) {}
+Bus::Bus() : id(), model(LoadArena::current()), capacity(0), status(SymbolTable::intern("Inactive")) {}
+Bus::Bus(const string &id, int capacity, string_view model, string_view status)
+    : id(id), model(model, LoadArena::current()), capacity(capacity), status(SymbolTable::intern(status)) {}
 
-string Bus::getId() const
+const EntityId &Bus::getId() const
 {
     return id;
 }
@@ -17,19 +17,24 @@ int Bus::getCapacity() const
     return capacity;
 }
 
-string Bus::getModel() const
+string_view Bus::getModel() const
 {
     return model;
 }
 
-string Bus::getStatus() const
+const string &Bus::getStatus() const
+{
+    return SymbolTable::name(status);
+}
+
+Symbol Bus::getStatusSymbol() const
 {
     return status;
 }
 
 void Bus::setId(const string &id)
 {
-    this->id = id;
+    this->id = EntityId(id);
 }
 
 void Bus::setCapacity(int capacity)
@@ -44,7 +49,7 @@ void Bus::setModel(const string &model)
 
 void Bus::setStatus(const string &status)
 {
-    this->status = status;
+    this->status = SymbolTable::intern(status);
 }
 
 void Bus::display() const
@@ -53,6 +58,6 @@ void Bus::display() const
          << setw(10) << id
          << setw(12) << capacity
          << setw(15) << model
-         << setw(15) << status
+         << setw(15) << SymbolTable::name(status)
          << endl;
 }
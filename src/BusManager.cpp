@@ -1,4 +1,5 @@
 ﻿#include "../include/BusManager.h"
+#include "../include/DataLoader.h"
 #include "../include/DataSaver.h"
 #include "../include/DisplayManager.h"
 #include <iostream>
@@ -7,7 +8,19 @@
 using namespace std;
 
 BusManager::BusManager(vector<Bus> &busList, const string &filename)
-    : buses(busList), dataFile(filename) {}
+    : buses(busList), dataFile(filename),
+      log(filename + ".log"), compactionThreshold(OperationLog::DEFAULT_COMPACTION_THRESHOLD),
+      flusher(nullptr), flushHandle(0), slots(buses), revision(0)
+{
+    size_t replayed = log.replay(buses, DataLoader::parseBusRecord, dataFile);
+    if (replayed > 0)
+    {
+        cout << "Replayed " << replayed << " logged bus changes from " << log.getFilename() << endl;
+        slots.rebuild();
+    }
+
+    index.rebuild(buses, slots);
+}
 
 bool BusManager::validateBus(const Bus &bus) const
 {
@@ -17,6 +30,12 @@ bool BusManager::validateBus(const Bus &bus) const
         return false;
     }
 
+    if (!bus.getId().isValid())
+    {
+        cout << "Error: Bus ID must be at most " << EntityId::CAPACITY << " characters." << endl;
+        return false;
+    }
+
     if (bus.getCapacity() <= 0)
     {
         cout << "Error: Bus capacity must be positive." << endl;
@@ -29,7 +48,7 @@ bool BusManager::validateBus(const Bus &bus) const
         return false;
     }
 
-    string status = bus.getStatus();
+    const string &status = bus.getStatus();
     if (status != "Active" && status != "Maintenance" && status != "Inactive")
     {
         cout << "Error: Bus status must be Active, Maintenance, or Inactive." << endl;
@@ -39,27 +58,32 @@ bool BusManager::validateBus(const Bus &bus) const
     return true;
 }
 
-bool BusManager::busExists(const string &busId) const
+bool BusManager::busExists(const EntityId &busId) const
 {
-    return any_of(buses.begin(), buses.end(),
-                  [&busId](const Bus &b)
-                  { return b.getId() == busId; });
+    return index.contains(busId);
 }
 
-Bus *BusManager::findBus(const string &busId)
+size_t BusManager::getRevision() const
 {
-    auto it = find_if(buses.begin(), buses.end(),
-                      [&busId](const Bus &b)
-                      { return b.getId() == busId; });
+    return revision;
+}
 
-    if (it != buses.end())
-    {
-        return &(*it);
-    }
-    return nullptr;
+Bus *BusManager::findBus(const EntityId &busId)
+{
+    return slots.get(index.find(busId));
 }
 
-bool BusManager::addBus(const Bus &newBus)
+BusManager::Handle BusManager::findBusHandle(const EntityId &busId) const
+{
+    return index.find(busId);
+}
+
+Bus *BusManager::getBus(Handle handle)
+{
+    return slots.get(handle);
+}
+
+bool BusManager::checkAdd(const Bus &newBus) const
 {
     if (!validateBus(newBus))
     {
@@ -71,49 +95,115 @@ bool BusManager::addBus(const Bus &newBus)
         cout << "Error: Bus with ID " << newBus.getId() << " already exists." << endl;
         return false;
     }
+    return true;
+}
 
-    buses.push_back(newBus);
-    cout << "Bus " << newBus.getId() << " added successfully." << endl;
+bool BusManager::checkUpdate(const EntityId &busId, const Bus &updatedBus) const
+{
+    if (!busExists(busId))
+    {
+        cout << "Error: Bus with ID " << busId << " not found." << endl;
+        return false;
+    }
 
-    return saveToFile();
+    if (!validateBus(updatedBus))
+    {
+        return false;
+    }
+
+    if (updatedBus.getId() != busId && busExists(updatedBus.getId()))
+    {
+        cout << "Error: Bus with ID " << updatedBus.getId() << " already exists." << endl;
+        return false;
+    }
+    return true;
 }
 
-bool BusManager::updateBus(const string &busId, const Bus &updatedBus)
+bool BusManager::checkRemove(const EntityId &busId) const
 {
-    Bus *bus = findBus(busId);
-    if (!bus)
+    if (!busExists(busId))
     {
         cout << "Error: Bus with ID " << busId << " not found." << endl;
         return false;
     }
+    return true;
+}
 
-    if (!validateBus(updatedBus))
+void BusManager::applyAdd(const Bus &newBus)
+{
+    revision++;
+    index.insert(newBus.getId(), slots.insert(newBus));
+}
+
+void BusManager::applyUpdate(const EntityId &busId, const Bus &updatedBus)
+{
+    revision++;
+    LoadArena::replace(*findBus(busId), updatedBus);
+    index.rename(busId, updatedBus.getId());
+}
+
+void BusManager::applyRemove(const EntityId &busId)
+{
+    revision++;
+    index.erase(busId, buses, slots);
+}
+
+bool BusManager::addBus(const Bus &newBus)
+{
+    FlushScheduler::Guard guard(flusher);
+
+    if (!checkAdd(newBus))
     {
         return false;
     }
 
-    *bus = updatedBus;
+    applyAdd(newBus);
+    cout << "Bus " << newBus.getId() << " added successfully." << endl;
+
+    return persist('A', newBus.getId(), &newBus);
+}
+
+bool BusManager::updateBus(const EntityId &busId, const Bus &updatedBus)
+{
+    FlushScheduler::Guard guard(flusher);
+
+    if (!checkUpdate(busId, updatedBus))
+    {
+        return false;
+    }
+
+    applyUpdate(busId, updatedBus);
     cout << "Bus " << busId << " updated successfully." << endl;
 
-    return saveToFile();
+    return persist('U', busId, &updatedBus);
 }
 
-bool BusManager::removeBus(const string &busId)
+bool BusManager::updateBus(Handle handle, const Bus &updatedBus)
 {
-    auto it = find_if(buses.begin(), buses.end(),
-                      [&busId](const Bus &b)
-                      { return b.getId() == busId; });
+    const Bus *bus = slots.get(handle);
+    if (!bus)
+    {
+        cout << "Error: Bus no longer exists." << endl;
+        return false;
+    }
+    // Copied: the update overwrites the stored ID.
+    EntityId busId = bus->getId();
+    return updateBus(busId, updatedBus);
+}
 
-    if (it == buses.end())
+bool BusManager::removeBus(const EntityId &busId)
+{
+    FlushScheduler::Guard guard(flusher);
+
+    if (!checkRemove(busId))
     {
-        cout << "Error: Bus with ID " << busId << " not found." << endl;
         return false;
     }
 
-    buses.erase(it);
+    applyRemove(busId);
     cout << "Bus " << busId << " removed successfully." << endl;
 
-    return saveToFile();
+    return persist('R', busId);
 }
 
 bool BusManager::saveToFile()
@@ -121,6 +211,97 @@ bool BusManager::saveToFile()
     return DataSaver::saveBuses(dataFile, buses);
 }
 
+bool BusManager::persist(char operation, const EntityId &busId, const Bus *bus)
+{
+    if (!log.append(operation, busId.view(), bus ? DataSaver::formatBus(*bus) : ""))
+    {
+        return false;
+    }
+
+    if (flusher)
+    {
+        flusher->markDirty(flushHandle);
+        return true;
+    }
+
+    if (log.size() >= compactionThreshold)
+    {
+        return compact();
+    }
+    return true;
+}
+
+bool BusManager::persistBatch(const vector<LogEntry> &entries)
+{
+    if (!log.appendAll(entries))
+    {
+        return false;
+    }
+
+    if (flusher)
+    {
+        flusher->markDirty(flushHandle);
+        return true;
+    }
+
+    if (log.size() >= compactionThreshold)
+    {
+        return compact();
+    }
+    return true;
+}
+
+bool BusManager::compact()
+{
+    lock_guard<mutex> compacting(compactMutex);
+
+    string contents;
+    size_t count;
+    {
+        FlushScheduler::Guard guard(flusher);
+        contents = DataSaver::formatBuses(buses);
+        count = buses.size();
+        if (!log.checkpoint(contents))
+        {
+            return false;
+        }
+    }
+
+    if (!log.sync() || !DataSaver::saveFormatted(dataFile, contents, count, "buses"))
+    {
+        return false;
+    }
+
+    FlushScheduler::Guard guard(flusher);
+    return log.trimToCheckpoint();
+}
+
+bool BusManager::commitLog()
+{
+    bool due;
+    {
+        FlushScheduler::Guard guard(flusher);
+        due = log.size() >= compactionThreshold;
+    }
+    return log.sync() && (!due || compact());
+}
+
+void BusManager::setCompactionThreshold(size_t entries)
+{
+    compactionThreshold = max<size_t>(1, entries);
+}
+
+void BusManager::attachFlusher(FlushScheduler &scheduler)
+{
+    flusher = &scheduler;
+    flushHandle = scheduler.registerFile(dataFile, [this]()
+                                         { return commitLog(); });
+    if (log.size() > 0)
+    {
+        scheduler.markDirty(flushHandle);
+    }
+}
+
 void BusManager::displayAllBuses() const
 {
     DisplayManager::displayBuses(buses);
@@ -1,10 +1,71 @@
 ﻿#include "../include/DataLoader.h"
+#include "../include/MappedFile.h"
+#include "../include/SnapshotFormat.h"
+#include <algorithm>
+#include <charconv>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <iterator>
+#include <thread>
 
 using namespace std;
 
+LoadMode DataLoader::loadMode = LoadMode::STREAM;
+unsigned DataLoader::threadCount = 0;
+
+static thread_local ostream *redirectedMessages = nullptr;
+static thread_local ostream *redirectedErrors = nullptr;
+
+void DataLoader::redirectOutput(ostream *messages, ostream *errors)
+{
+    redirectedMessages = messages;
+    redirectedErrors = errors;
+}
+
+ostream &DataLoader::messageStream()
+{
+    return redirectedMessages ? *redirectedMessages : cout;
+}
+
+ostream &DataLoader::errorStream()
+{
+    return redirectedErrors ? *redirectedErrors : cerr;
+}
+
+void DataLoader::setLoadMode(LoadMode mode)
+{
+    loadMode = mode;
+}
+
+LoadMode DataLoader::getLoadMode()
+{
+    return loadMode;
+}
+
+void DataLoader::setThreadCount(unsigned count)
+{
+    threadCount = count;
+}
+
+unsigned DataLoader::getThreadCount()
+{
+    if (threadCount > 0)
+    {
+        return threadCount;
+    }
+    return max(1u, thread::hardware_concurrency());
+}
+
+// Drops the '\r' of a CRLF line, which text-mode streams keep off Windows.
+static void dropCarriageReturn(string &line)
+{
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.pop_back();
+    }
+}
+
 vector<string> DataLoader::splitCSV(const string &line, char delimiter)
 {
     vector<string> tokens;
@@ -24,19 +85,262 @@ vector<string> DataLoader::parseKeyStops(const string &stopsStr)
     return splitCSV(stopsStr, '|');
 }
 
+size_t DataLoader::splitFields(string_view line, string_view *fields, size_t maxFields, char delimiter)
+{
+    size_t count = 0;
+    size_t start = 0;
+
+    // Like getline-based splitCSV, a trailing delimiter does not start a new field.
+    while (start < line.size())
+    {
+        size_t end = line.find(delimiter, start);
+        if (end == string_view::npos)
+        {
+            end = line.size();
+        }
+        if (count < maxFields)
+        {
+            fields[count] = line.substr(start, end - start);
+        }
+        count++;
+        start = end + 1;
+    }
+
+    return count;
+}
+
+static bool parseIntField(string_view field, int &value)
+{
+    size_t first = field.find_first_not_of(" \t");
+    if (first == string_view::npos)
+    {
+        return false;
+    }
+    const char *begin = field.data() + first;
+    const char *end = field.data() + field.size();
+    if (*begin == '+')
+    {
+        ++begin;
+    }
+    return from_chars(begin, end, value).ec == errc();
+}
+
+bool DataLoader::parseBusRecord(string_view record, Bus &bus, string &error)
+{
+    string_view fields[4];
+    size_t fieldCount = splitFields(record, fields, 4);
+
+    if (fieldCount != 4)
+    {
+        error = "Expected 4 fields, got " + to_string(fieldCount);
+        return false;
+    }
+
+    if (!EntityId::fits(fields[0]))
+    {
+        error = "ID '" + string(fields[0]) + "' is longer than " + to_string(EntityId::CAPACITY) + " characters";
+        return false;
+    }
+
+    int capacity;
+    if (!parseIntField(fields[1], capacity))
+    {
+        error = "Parsing error: invalid capacity '" + string(fields[1]) + "'";
+        return false;
+    }
+
+    bus = Bus(string(fields[0]), capacity, fields[2], fields[3]);
+    return true;
+}
+
+bool DataLoader::parseDriverRecord(string_view record, Driver &driver, string &error)
+{
+    string_view fields[4];
+    size_t fieldCount = splitFields(record, fields, 4);
+
+    if (fieldCount != 4)
+    {
+        error = "Expected 4 fields, got " + to_string(fieldCount);
+        return false;
+    }
+
+    if (!EntityId::fits(fields[0]))
+    {
+        error = "ID '" + string(fields[0]) + "' is longer than " + to_string(EntityId::CAPACITY) + " characters";
+        return false;
+    }
+
+    driver = Driver(string(fields[0]), fields[1], fields[2], fields[3]);
+    return true;
+}
+
+bool DataLoader::parseRouteRecord(string_view record, Route &route, string &error)
+{
+    string_view fields[5];
+    size_t fieldCount = splitFields(record, fields, 5);
+
+    if (fieldCount != 5)
+    {
+        error = "Expected 5 fields, got " + to_string(fieldCount);
+        return false;
+    }
+
+    if (!EntityId::fits(fields[0]))
+    {
+        error = "ID '" + string(fields[0]) + "' is longer than " + to_string(EntityId::CAPACITY) + " characters";
+        return false;
+    }
+
+    int estimatedTravelTime;
+    if (!parseIntField(fields[4], estimatedTravelTime))
+    {
+        error = "Parsing error: invalid travel time '" + string(fields[4]) + "'";
+        return false;
+    }
+
+    vector<string> keyStops;
+    size_t start = 0;
+    while (start < fields[3].size())
+    {
+        size_t end = fields[3].find('|', start);
+        if (end == string_view::npos)
+        {
+            end = fields[3].size();
+        }
+        keyStops.emplace_back(fields[3].substr(start, end - start));
+        start = end + 1;
+    }
+
+    route = Route(string(fields[0]), fields[1], fields[2], keyStops, estimatedTravelTime);
+    return true;
+}
+
+bool DataLoader::parseScheduleRecord(string_view record, Schedule &schedule, string &error)
+{
+    string_view fields[7];
+    size_t fieldCount = splitFields(record, fields, 7);
+    error.clear();
+
+    if (fieldCount != 7)
+    {
+        error = "Expected 7 fields, got " + to_string(fieldCount);
+        return false;
+    }
+
+    if (!EntityId::fits(fields[0]))
+    {
+        error = "ID '" + string(fields[0]) + "' is longer than " + to_string(EntityId::CAPACITY) + " characters";
+        return false;
+    }
+
+    int32_t day = Schedule::parseDate(fields[4]);
+    int16_t departure = Schedule::parseTime(fields[5]);
+    int16_t arrival = Schedule::parseTime(fields[6]);
+
+    if (day == Schedule::INVALID_DAY)
+    {
+        error = "Invalid date '" + string(fields[4]) + "' (expected YYYY-MM-DD)";
+    }
+    else if (departure == Schedule::INVALID_TIME || arrival == Schedule::INVALID_TIME)
+    {
+        error = "Invalid time '" + string(departure == Schedule::INVALID_TIME ? fields[5] : fields[6]) +
+                "' (expected HH:MM)";
+    }
+
+    schedule = Schedule(string(fields[0]), string(fields[1]), string(fields[2]), string(fields[3]),
+                        day, departure, arrival);
+    return true;
+}
+
+bool DataLoader::parseUserRecord(string_view record, User &user, string &error)
+{
+    string_view fields[3];
+    size_t fieldCount = splitFields(record, fields, 3);
+
+    if (fieldCount != 3)
+    {
+        error = "Expected 3 fields, got " + to_string(fieldCount);
+        return false;
+    }
+
+    user = User(string(fields[0]), string(fields[1]), User::stringToRole(string(fields[2])));
+    return true;
+}
+
+static size_t countLines(string_view text)
+{
+    return static_cast<size_t>(count(text.begin(), text.end(), '\n')) + 1;
+}
+
+// Calls handle(line, lineNumber) for every line of text, newline excluded,
+// and returns the number of lines seen. A '\r' before the newline is dropped
+// too, as text-mode streams do on Windows, so CRLF files load the same.
+template <typename Handler>
+static int forEachLine(string_view text, Handler handle)
+{
+    int lineNumber = 0;
+    size_t start = 0;
+
+    while (start < text.size())
+    {
+        size_t end = text.find('\n', start);
+        if (end == string_view::npos)
+        {
+            end = text.size();
+        }
+        lineNumber++;
+        string_view line = text.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        handle(line, lineNumber);
+        start = end + 1;
+    }
+
+    return lineNumber;
+}
+
+// Splits text into up to chunkCount pieces that each end on a line boundary.
+static vector<string_view> splitAtLines(string_view text, size_t chunkCount)
+{
+    vector<string_view> chunks;
+    size_t start = 0;
+
+    for (size_t k = 1; k <= chunkCount && start < text.size(); ++k)
+    {
+        size_t end = text.size();
+        if (k < chunkCount)
+        {
+            end = max(start, text.size() * k / chunkCount);
+            end = text.find('\n', end);
+            end = (end == string_view::npos) ? text.size() : end + 1;
+        }
+        chunks.push_back(text.substr(start, end - start));
+        start = end;
+    }
+
+    return chunks;
+}
+
 void DataLoader::logError(const string &filename, int lineNumber, const string &error)
 {
-    cerr << "Error in " << filename << " at line " << lineNumber << ": " << error << endl;
+    errorStream() << "Error in " << filename << " at line " << lineNumber << ": " << error << endl;
 }
 
 vector<Bus> DataLoader::loadBuses(const string &filename)
 {
+    if (loadMode != LoadMode::STREAM)
+    {
+        return loadBusesMapped(filename);
+    }
+
     vector<Bus> buses;
     ifstream file(filename);
 
     if (!file.is_open())
     {
-        cerr << "Error: Could not open file " << filename << endl;
+        errorStream() << "Error: Could not open file " << filename << endl;
         return buses;
     }
 
@@ -46,6 +350,7 @@ vector<Bus> DataLoader::loadBuses(const string &filename)
     while (getline(file, line))
     {
         lineNumber++;
+        dropCarriageReturn(line);
 
         if (line.empty())
         {
@@ -60,6 +365,13 @@ vector<Bus> DataLoader::loadBuses(const string &filename)
             continue;
         }
 
+        if (!EntityId::fits(tokens[0]))
+        {
+            logError(filename, lineNumber, "ID '" + tokens[0] + "' is longer than " +
+                                               to_string(EntityId::CAPACITY) + " characters");
+            continue;
+        }
+
         try
         {
             string id = tokens[0];
@@ -76,18 +388,23 @@ vector<Bus> DataLoader::loadBuses(const string &filename)
     }
 
     file.close();
-    cout << "Loaded " << buses.size() << " buses from " << filename << endl;
+    messageStream() << "Loaded " << buses.size() << " buses from " << filename << endl;
     return buses;
 }
 
 vector<Driver> DataLoader::loadDrivers(const string &filename)
 {
+    if (loadMode != LoadMode::STREAM)
+    {
+        return loadDriversMapped(filename);
+    }
+
     vector<Driver> drivers;
     ifstream file(filename);
 
     if (!file.is_open())
     {
-        cerr << "Error: Could not open file " << filename << endl;
+        errorStream() << "Error: Could not open file " << filename << endl;
         return drivers;
     }
 
@@ -97,6 +414,7 @@ vector<Driver> DataLoader::loadDrivers(const string &filename)
     while (getline(file, line))
     {
         lineNumber++;
+        dropCarriageReturn(line);
 
         if (line.empty())
         {
@@ -111,6 +429,13 @@ vector<Driver> DataLoader::loadDrivers(const string &filename)
             continue;
         }
 
+        if (!EntityId::fits(tokens[0]))
+        {
+            logError(filename, lineNumber, "ID '" + tokens[0] + "' is longer than " +
+                                               to_string(EntityId::CAPACITY) + " characters");
+            continue;
+        }
+
         string id = tokens[0];
         string name = tokens[1];
         string contactInfo = tokens[2];
@@ -120,18 +445,23 @@ vector<Driver> DataLoader::loadDrivers(const string &filename)
     }
 
     file.close();
-    cout << "Loaded " << drivers.size() << " drivers from " << filename << endl;
+    messageStream() << "Loaded " << drivers.size() << " drivers from " << filename << endl;
     return drivers;
 }
 
 vector<Route> DataLoader::loadRoutes(const string &filename)
 {
+    if (loadMode != LoadMode::STREAM)
+    {
+        return loadRoutesMapped(filename);
+    }
+
     vector<Route> routes;
     ifstream file(filename);
 
     if (!file.is_open())
     {
-        cerr << "Error: Could not open file " << filename << endl;
+        errorStream() << "Error: Could not open file " << filename << endl;
         return routes;
     }
 
@@ -141,6 +471,7 @@ vector<Route> DataLoader::loadRoutes(const string &filename)
     while (getline(file, line))
     {
         lineNumber++;
+        dropCarriageReturn(line);
 
         if (line.empty())
         {
@@ -155,6 +486,13 @@ vector<Route> DataLoader::loadRoutes(const string &filename)
             continue;
         }
 
+        if (!EntityId::fits(tokens[0]))
+        {
+            logError(filename, lineNumber, "ID '" + tokens[0] + "' is longer than " +
+                                               to_string(EntityId::CAPACITY) + " characters");
+            continue;
+        }
+
         try
         {
             string id = tokens[0];
@@ -172,18 +510,27 @@ vector<Route> DataLoader::loadRoutes(const string &filename)
     }
 
     file.close();
-    cout << "Loaded " << routes.size() << " routes from " << filename << endl;
+    messageStream() << "Loaded " << routes.size() << " routes from " << filename << endl;
     return routes;
 }
 
 vector<Schedule> DataLoader::loadSchedules(const string &filename)
 {
+    if (loadMode == LoadMode::PARALLEL)
+    {
+        return loadSchedulesParallel(filename);
+    }
+    if (loadMode == LoadMode::MAPPED)
+    {
+        return loadSchedulesMapped(filename);
+    }
+
     vector<Schedule> schedules;
     ifstream file(filename);
 
     if (!file.is_open())
     {
-        cerr << "Error: Could not open file " << filename << endl;
+        errorStream() << "Error: Could not open file " << filename << endl;
         return schedules;
     }
 
@@ -193,44 +540,93 @@ vector<Schedule> DataLoader::loadSchedules(const string &filename)
     while (getline(file, line))
     {
         lineNumber++;
+        dropCarriageReturn(line);
 
         if (line.empty())
         {
             continue;
         }
 
-        vector<string> tokens = splitCSV(line);
+        Schedule schedule;
+        string error;
+        if (!parseScheduleRecord(line, schedule, error))
+        {
+            logError(filename, lineNumber, error);
+            continue;
+        }
+        if (!error.empty())
+        {
+            logError(filename, lineNumber, error + "; row kept");
+        }
 
-        if (tokens.size() != 7)
+        schedules.push_back(move(schedule));
+    }
+
+    file.close();
+    messageStream() << "Loaded " << schedules.size() << " schedules from " << filename << endl;
+    return schedules;
+}
+
+vector<Schedule> DataLoader::loadTrips(const string &filename)
+{
+    vector<Schedule> trips;
+    ifstream file(filename);
+
+    if (!file.is_open())
+    {
+        errorStream() << "Error: Could not open file " << filename << endl;
+        return trips;
+    }
+
+    string line;
+    int lineNumber = 0;
+
+    while (getline(file, line))
+    {
+        lineNumber++;
+        dropCarriageReturn(line);
+
+        if (line.empty())
         {
-            logError(filename, lineNumber, "Expected 7 fields, got " + to_string(tokens.size()));
             continue;
         }
 
-        string id = tokens[0];
-        string routeId = tokens[1];
-        string busId = tokens[2];
-        string driverId = tokens[3];
-        string date = tokens[4];
-        string departureTime = tokens[5];
-        string arrivalTime = tokens[6];
+        string_view fields[5];
+        size_t fieldCount = splitFields(line, fields, 5);
+        if (fieldCount != 5)
+        {
+            logError(filename, lineNumber, "Expected 5 fields, got " + to_string(fieldCount));
+            continue;
+        }
+        if (!EntityId::fits(fields[0]))
+        {
+            logError(filename, lineNumber, "ID '" + string(fields[0]) + "' is longer than " +
+                                               to_string(EntityId::CAPACITY) + " characters");
+            continue;
+        }
 
-        schedules.push_back(Schedule(id, routeId, busId, driverId, date, departureTime, arrivalTime));
+        trips.push_back(Schedule(string(fields[0]), string(fields[1]), "", "", string(fields[2]),
+                                 string(fields[3]), string(fields[4])));
     }
 
     file.close();
-    cout << "Loaded " << schedules.size() << " schedules from " << filename << endl;
-    return schedules;
+    messageStream() << "Loaded " << trips.size() << " trips from " << filename << endl;
+    return trips;
 }
 
 vector<User> DataLoader::loadCredentials(const string &filename)
 {
+    if (loadMode != LoadMode::STREAM)
+    {
+        return loadCredentialsMapped(filename);
+    }
+
     vector<User> users;
     ifstream file(filename);
 
     if (!file.is_open())
     {
-        cerr << "Error: Could not open file " << filename << endl;
+        errorStream() << "Error: Could not open file " << filename << endl;
         return users;
     }
 
@@ -240,6 +636,7 @@ vector<User> DataLoader::loadCredentials(const string &filename)
     while (getline(file, line))
     {
         lineNumber++;
+        dropCarriageReturn(line);
 
         if (line.empty())
         {
@@ -262,6 +659,504 @@ vector<User> DataLoader::loadCredentials(const string &filename)
     }
 
     file.close();
-    cout << "Loaded " << users.size() << " user credentials from " << filename << endl;
+    messageStream() << "Loaded " << users.size() << " user credentials from " << filename << endl;
+    return users;
+}
+
+vector<Bus> DataLoader::loadBusesMapped(const string &filename)
+{
+    vector<Bus> buses;
+    MappedFile file(filename);
+
+    if (!file.isOpen())
+    {
+        errorStream() << "Error: Could not open file " << filename << endl;
+        return buses;
+    }
+
+    buses.reserve(countLines(file.view()));
+    Bus entity;
+    string error;
+    forEachLine(file.view(), [&](string_view line, int lineNumber)
+                {
+        if (line.empty())
+        {
+            return;
+        }
+        if (parseBusRecord(line, entity, error))
+        {
+            buses.push_back(move(entity));
+        }
+        else
+        {
+            logError(filename, lineNumber, error);
+        } });
+
+    messageStream() << "Loaded " << buses.size() << " buses from " << filename << endl;
+    return buses;
+}
+
+vector<Driver> DataLoader::loadDriversMapped(const string &filename)
+{
+    vector<Driver> drivers;
+    MappedFile file(filename);
+
+    if (!file.isOpen())
+    {
+        errorStream() << "Error: Could not open file " << filename << endl;
+        return drivers;
+    }
+
+    drivers.reserve(countLines(file.view()));
+    Driver entity;
+    string error;
+    forEachLine(file.view(), [&](string_view line, int lineNumber)
+                {
+        if (line.empty())
+        {
+            return;
+        }
+        if (parseDriverRecord(line, entity, error))
+        {
+            drivers.push_back(move(entity));
+        }
+        else
+        {
+            logError(filename, lineNumber, error);
+        } });
+
+    messageStream() << "Loaded " << drivers.size() << " drivers from " << filename << endl;
+    return drivers;
+}
+
+vector<Route> DataLoader::loadRoutesMapped(const string &filename)
+{
+    vector<Route> routes;
+    MappedFile file(filename);
+
+    if (!file.isOpen())
+    {
+        errorStream() << "Error: Could not open file " << filename << endl;
+        return routes;
+    }
+
+    routes.reserve(countLines(file.view()));
+    Route entity;
+    string error;
+    forEachLine(file.view(), [&](string_view line, int lineNumber)
+                {
+        if (line.empty())
+        {
+            return;
+        }
+        if (parseRouteRecord(line, entity, error))
+        {
+            routes.push_back(move(entity));
+        }
+        else
+        {
+            logError(filename, lineNumber, error);
+        } });
+
+    messageStream() << "Loaded " << routes.size() << " routes from " << filename << endl;
+    return routes;
+}
+
+vector<Schedule> DataLoader::loadSchedulesMapped(const string &filename)
+{
+    vector<Schedule> schedules;
+    MappedFile file(filename);
+
+    if (!file.isOpen())
+    {
+        errorStream() << "Error: Could not open file " << filename << endl;
+        return schedules;
+    }
+
+    schedules.reserve(countLines(file.view()));
+    Schedule entity;
+    string error;
+    forEachLine(file.view(), [&](string_view line, int lineNumber)
+                {
+        if (line.empty())
+        {
+            return;
+        }
+        if (parseScheduleRecord(line, entity, error))
+        {
+            if (!error.empty())
+            {
+                logError(filename, lineNumber, error + "; row kept");
+            }
+            schedules.push_back(move(entity));
+        }
+        else
+        {
+            logError(filename, lineNumber, error);
+        } });
+
+    messageStream() << "Loaded " << schedules.size() << " schedules from " << filename << endl;
+    return schedules;
+}
+
+vector<Schedule> DataLoader::loadSchedulesParallel(const string &filename)
+{
+    struct ChunkResult
+    {
+        vector<Schedule> schedules;
+        vector<pair<int, string>> errors;
+        int lineCount = 0;
+    };
+
+    vector<Schedule> schedules;
+    MappedFile file(filename);
+
+    if (!file.isOpen())
+    {
+        errorStream() << "Error: Could not open file " << filename << endl;
+        return schedules;
+    }
+
+    vector<string_view> chunks = splitAtLines(file.view(), getThreadCount());
+    vector<ChunkResult> results(chunks.size());
+    vector<thread> workers;
+
+    for (size_t c = 0; c < chunks.size(); ++c)
+    {
+        workers.emplace_back([&chunks, &results, c]()
+                             {
+            ChunkResult &result = results[c];
+            result.schedules.reserve(countLines(chunks[c]));
+            Schedule schedule;
+            string error;
+            result.lineCount = forEachLine(chunks[c], [&](string_view line, int lineNumber)
+                                           {
+                if (line.empty())
+                {
+                    return;
+                }
+                if (parseScheduleRecord(line, schedule, error))
+                {
+                    if (!error.empty())
+                    {
+                        result.errors.emplace_back(lineNumber, error + "; row kept");
+                    }
+                    result.schedules.push_back(move(schedule));
+                }
+                else
+                {
+                    result.errors.emplace_back(lineNumber, error);
+                } }); });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    // Merge in file order; each chunk's line numbers are offset by the lines before it.
+    size_t total = 0;
+    for (const auto &result : results)
+    {
+        total += result.schedules.size();
+    }
+    schedules.reserve(total);
+
+    int lineBase = 0;
+    for (auto &result : results)
+    {
+        for (const auto &error : result.errors)
+        {
+            logError(filename, lineBase + error.first, error.second);
+        }
+        move(result.schedules.begin(), result.schedules.end(), back_inserter(schedules));
+        lineBase += result.lineCount;
+    }
+
+    messageStream() << "Loaded " << schedules.size() << " schedules from " << filename << endl;
+    return schedules;
+}
+
+vector<User> DataLoader::loadCredentialsMapped(const string &filename)
+{
+    vector<User> users;
+    MappedFile file(filename);
+
+    if (!file.isOpen())
+    {
+        errorStream() << "Error: Could not open file " << filename << endl;
+        return users;
+    }
+
+    users.reserve(countLines(file.view()));
+    User entity;
+    string error;
+    forEachLine(file.view(), [&](string_view line, int lineNumber)
+                {
+        if (line.empty())
+        {
+            return;
+        }
+        if (parseUserRecord(line, entity, error))
+        {
+            users.push_back(move(entity));
+        }
+        else
+        {
+            logError(filename, lineNumber, error);
+        } });
+
+    messageStream() << "Loaded " << users.size() << " user credentials from " << filename << endl;
     return users;
 }
+
+// Bounds-checked cursor over a snapshot payload.
+class SnapshotReader
+{
+private:
+    const char *position;
+    const char *end;
+
+public:
+    SnapshotReader(string_view bytes) : position(bytes.data()), end(bytes.data() + bytes.size()) {}
+
+    bool readU32(uint32_t &value)
+    {
+        if (end - position < 4)
+        {
+            return false;
+        }
+        value = SnapshotFormat::getU32(position);
+        position += 4;
+        return true;
+    }
+
+    bool readBytes(size_t length, string_view &value)
+    {
+        if (static_cast<size_t>(end - position) < length)
+        {
+            return false;
+        }
+        value = string_view(position, length);
+        position += length;
+        return true;
+    }
+
+    // Reads a column of count 32-bit values.
+    bool readColumn(uint32_t count, vector<uint32_t> &column)
+    {
+        if (static_cast<size_t>(end - position) / 4 < count)
+        {
+            return false;
+        }
+        column.resize(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            column[i] = SnapshotFormat::getU32(position);
+            position += 4;
+        }
+        return true;
+    }
+
+    // Reads a column of string-table indexes, rejecting any out of range.
+    bool readStringColumn(uint32_t count, const vector<string_view> &strings, vector<uint32_t> &column)
+    {
+        if (!readColumn(count, column))
+        {
+            return false;
+        }
+        for (uint32_t index : column)
+        {
+            if (index >= strings.size())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+bool DataLoader::loadSnapshot(const string &filename, const vector<string> &sourceFiles, SystemData &data)
+{
+    MappedFile file(filename);
+    if (!file.isOpen())
+    {
+        return false;
+    }
+
+    string_view bytes = file.view();
+    size_t headerSize = 28 + 16 * sourceFiles.size();
+    if (bytes.size() < headerSize || bytes.compare(0, 4, string_view(SnapshotFormat::MAGIC, 4)) != 0)
+    {
+        errorStream() << "Snapshot " << filename << " is not a valid snapshot file" << endl;
+        return false;
+    }
+
+    const char *header = bytes.data();
+    if (SnapshotFormat::getU32(header + 4) != SnapshotFormat::VERSION)
+    {
+        messageStream() << "Snapshot " << filename << " has an old format version; ignoring it" << endl;
+        return false;
+    }
+
+    uint64_t payloadSize = SnapshotFormat::getU64(header + 8);
+    uint64_t expectedChecksum = SnapshotFormat::getU64(header + 16);
+    if (SnapshotFormat::getU32(header + 24) != sourceFiles.size() || bytes.size() - headerSize != payloadSize)
+    {
+        errorStream() << "Snapshot " << filename << " has an unexpected layout" << endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < sourceFiles.size(); ++i)
+    {
+        SnapshotFormat::SourceStamp stamp;
+        const char *recorded = header + 28 + 16 * i;
+        if (!SnapshotFormat::stampFile(sourceFiles[i], stamp) ||
+            stamp.size != SnapshotFormat::getU64(recorded) ||
+            stamp.modified != static_cast<int64_t>(SnapshotFormat::getU64(recorded + 8)))
+        {
+            messageStream() << "Snapshot " << filename << " is stale (" << sourceFiles[i] << " changed)" << endl;
+            return false;
+        }
+    }
+
+    string_view payload = bytes.substr(headerSize);
+    if (SnapshotFormat::checksum(payload) != expectedChecksum)
+    {
+        errorStream() << "Snapshot " << filename << " failed its checksum" << endl;
+        return false;
+    }
+
+    SnapshotReader reader(payload);
+    SystemData loaded;
+
+    uint32_t stringCount;
+    if (!reader.readU32(stringCount))
+    {
+        return false;
+    }
+    vector<string_view> strings(stringCount);
+    for (uint32_t i = 0; i < stringCount; ++i)
+    {
+        uint32_t length;
+        if (!reader.readU32(length) || !reader.readBytes(length, strings[i]))
+        {
+            errorStream() << "Snapshot " << filename << " has a truncated string table" << endl;
+            return false;
+        }
+    }
+
+    auto text = [&strings](uint32_t index)
+    {
+        return string(strings[index]);
+    };
+
+    // The string table is already deduplicated, so each entry is interned at
+    // most once instead of once per row that refers to it.
+    vector<Symbol> symbols(stringCount, SymbolTable::EMPTY);
+    vector<bool> interned(stringCount, false);
+    auto symbol = [&strings, &symbols, &interned](uint32_t index)
+    {
+        if (!interned[index])
+        {
+            symbols[index] = SymbolTable::intern(strings[index]);
+            interned[index] = true;
+        }
+        return symbols[index];
+    };
+
+    uint32_t count;
+    vector<uint32_t> c0, c1, c2, c3, c4, c5;
+
+    if (!reader.readU32(count) || !reader.readStringColumn(count, strings, c0) ||
+        !reader.readColumn(count, c1) || !reader.readStringColumn(count, strings, c2) ||
+        !reader.readStringColumn(count, strings, c3))
+    {
+        errorStream() << "Snapshot " << filename << " has a corrupt bus table" << endl;
+        return false;
+    }
+    loaded.buses.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        loaded.buses.emplace_back(text(c0[i]), static_cast<int>(c1[i]), strings[c2[i]], strings[c3[i]]);
+    }
+
+    if (!reader.readU32(count) || !reader.readStringColumn(count, strings, c0) ||
+        !reader.readStringColumn(count, strings, c1) || !reader.readStringColumn(count, strings, c2) ||
+        !reader.readStringColumn(count, strings, c3))
+    {
+        errorStream() << "Snapshot " << filename << " has a corrupt driver table" << endl;
+        return false;
+    }
+    loaded.drivers.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        loaded.drivers.emplace_back(text(c0[i]), strings[c1[i]], strings[c2[i]], strings[c3[i]]);
+    }
+
+    if (!reader.readU32(count) || !reader.readStringColumn(count, strings, c0) ||
+        !reader.readStringColumn(count, strings, c1) || !reader.readStringColumn(count, strings, c2) ||
+        !reader.readColumn(count, c3) || !reader.readColumn(count, c4))
+    {
+        errorStream() << "Snapshot " << filename << " has a corrupt route table" << endl;
+        return false;
+    }
+    uint64_t stopTotal = 0;
+    for (uint32_t stops : c4)
+    {
+        stopTotal += stops;
+    }
+    if (stopTotal > UINT32_MAX || !reader.readStringColumn(static_cast<uint32_t>(stopTotal), strings, c5))
+    {
+        errorStream() << "Snapshot " << filename << " has a corrupt route table" << endl;
+        return false;
+    }
+    loaded.routes.reserve(count);
+    size_t stopPosition = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        vector<string> keyStops;
+        keyStops.reserve(c4[i]);
+        for (uint32_t k = 0; k < c4[i]; ++k)
+        {
+            keyStops.push_back(text(c5[stopPosition++]));
+        }
+        loaded.routes.emplace_back(text(c0[i]), strings[c1[i]], strings[c2[i]], keyStops, static_cast<int>(c3[i]));
+    }
+
+    // Dates are stored as day numbers and times packed as departure << 16 | arrival.
+    if (!reader.readU32(count) || !reader.readStringColumn(count, strings, c0) ||
+        !reader.readStringColumn(count, strings, c1) || !reader.readStringColumn(count, strings, c2) ||
+        !reader.readStringColumn(count, strings, c3) || !reader.readColumn(count, c4) ||
+        !reader.readColumn(count, c5))
+    {
+        errorStream() << "Snapshot " << filename << " has a corrupt schedule table" << endl;
+        return false;
+    }
+    loaded.schedules.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        loaded.schedules.emplace_back(text(c0[i]), symbol(c1[i]), symbol(c2[i]), symbol(c3[i]),
+                                      static_cast<int32_t>(c4[i]), static_cast<int16_t>(c5[i] >> 16),
+                                      static_cast<int16_t>(c5[i] & 0xFFFF));
+    }
+
+    if (!reader.readU32(count) || !reader.readStringColumn(count, strings, c0) ||
+        !reader.readStringColumn(count, strings, c1) || !reader.readColumn(count, c2) ||
+        any_of(c2.begin(), c2.end(), [](uint32_t role)
+               { return role > static_cast<uint32_t>(UserRole::PASSENGER); }))
+    {
+        errorStream() << "Snapshot " << filename << " has a corrupt user table" << endl;
+        return false;
+    }
+    loaded.users.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        loaded.users.emplace_back(text(c0[i]), text(c1[i]), static_cast<UserRole>(c2[i]));
+    }
+
+    data = move(loaded);
+    messageStream() << "Loaded " << data.buses.size() << " buses, " << data.drivers.size() << " drivers, "
+                    << data.routes.size() << " routes, " << data.schedules.size() << " schedules and "
+                    << data.users.size() << " user credentials from snapshot " << filename << endl;
+    return true;
+}
@@ -1,123 +1,439 @@
 ﻿#include "../include/DataSaver.h"
-#include <fstream>
+#include "../include/SnapshotFormat.h"
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
-bool DataSaver::saveBuses(const string &filename, const vector<Bus> &buses)
+static thread_local ostream *redirectedMessages = nullptr;
+static thread_local ostream *redirectedErrors = nullptr;
+
+void DataSaver::redirectOutput(ostream *messages, ostream *errors)
 {
-    ofstream file(filename);
+    redirectedMessages = messages;
+    redirectedErrors = errors;
+}
 
-    if (!file.is_open())
+ostream &DataSaver::messageStream()
+{
+    return redirectedMessages ? *redirectedMessages : cout;
+}
+
+ostream &DataSaver::errorStream()
+{
+    return redirectedErrors ? *redirectedErrors : cerr;
+}
+
+#ifdef _WIN32
+static bool writeDurably(const string &path, const string &contents)
+{
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
     {
-        cerr << "Error: Could not open file " << filename << " for writing." << endl;
         return false;
     }
 
-    for (const auto &bus : buses)
+    size_t written = 0;
+    bool ok = true;
+    while (ok && written < contents.size())
+    {
+        DWORD chunk = static_cast<DWORD>(min<size_t>(contents.size() - written, 1u << 30));
+        DWORD done = 0;
+        ok = WriteFile(file, contents.data() + written, chunk, &done, nullptr) && done > 0;
+        written += done;
+    }
+    ok = ok && FlushFileBuffers(file);
+    CloseHandle(file);
+    return ok;
+}
+
+static bool replaceFile(const string &from, const string &to)
+{
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+}
+#else
+static bool writeDurably(const string &path, const string &contents)
+{
+    int file = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file < 0)
     {
-        file << bus.getId() << ","
-             << bus.getCapacity() << ","
-             << bus.getModel() << ","
-             << bus.getStatus() << endl;
+        return false;
     }
 
-    file.close();
-    cout << "Successfully saved " << buses.size() << " buses to " << filename << endl;
+    size_t written = 0;
+    bool ok = true;
+    while (ok && written < contents.size())
+    {
+        ssize_t done = ::write(file, contents.data() + written, contents.size() - written);
+        ok = done > 0;
+        if (ok)
+        {
+            written += static_cast<size_t>(done);
+        }
+    }
+    ok = (fsync(file) == 0) && ok;
+    ::close(file);
+    return ok;
+}
+
+static bool replaceFile(const string &from, const string &to)
+{
+    if (rename(from.c_str(), to.c_str()) != 0)
+    {
+        return false;
+    }
+
+    // Persist the directory entry so the rename itself survives a crash.
+    size_t slash = to.find_last_of('/');
+    string directory = (slash == string::npos) ? "." : to.substr(0, slash + 1);
+    int dir = ::open(directory.c_str(), O_RDONLY);
+    if (dir >= 0)
+    {
+        fsync(dir);
+        ::close(dir);
+    }
     return true;
 }
+#endif
 
-bool DataSaver::saveDrivers(const string &filename, const vector<Driver> &drivers)
+bool DataSaver::writeFileAtomically(const string &filename, const string &contents)
 {
-    ofstream file(filename);
+    string tempFile = filename + ".tmp";
 
-    if (!file.is_open())
+    if (!writeDurably(tempFile, contents))
     {
-        cerr << "Error: Could not open file " << filename << " for writing." << endl;
+        remove(tempFile.c_str());
+        errorStream() << "Error: Could not open file " << filename << " for writing." << endl;
         return false;
     }
 
-    for (const auto &driver : drivers)
+    if (!replaceFile(tempFile, filename))
     {
-        file << driver.getId() << ","
-             << driver.getName() << ","
-             << driver.getContactInfo() << ","
-             << driver.getLicenseDetails() << endl;
+        remove(tempFile.c_str());
+        errorStream() << "Error: Could not replace " << filename << endl;
+        return false;
     }
-
-    file.close();
-    cout << "Successfully saved " << drivers.size() << " drivers to " << filename << endl;
     return true;
 }
 
-bool DataSaver::saveRoutes(const string &filename, const vector<Route> &routes)
+string DataSaver::formatBus(const Bus &bus)
 {
-    ofstream file(filename);
+    string line = bus.getId().str() + "," + to_string(bus.getCapacity()) + ",";
+    line.append(bus.getModel());
+    return line + "," + bus.getStatus();
+}
 
-    if (!file.is_open())
+string DataSaver::formatDriver(const Driver &driver)
+{
+    string line = driver.getId().str();
+    for (string_view field : {driver.getName(), driver.getContactInfo(), driver.getLicenseDetails()})
     {
-        cerr << "Error: Could not open file " << filename << " for writing." << endl;
-        return false;
+        line.append(",").append(field);
     }
+    return line;
+}
 
-    for (const auto &route : routes)
+string DataSaver::formatRoute(const Route &route)
+{
+    string line = route.getId().str();
+    line.append(",").append(route.getOrigin()).append(",").append(route.getDestination());
+    return line + "," + route.getStopsAsString() + "," + to_string(route.getEstimatedTravelTime());
+}
+
+string DataSaver::formatSchedule(const Schedule &schedule)
+{
+    string line;
+    formatSchedule(schedule, line);
+    return line;
+}
+
+void DataSaver::formatSchedule(const Schedule &schedule, string &line)
+{
+    line.assign(schedule.getId().view());
+    line.append(",").append(schedule.getRouteId()).append(",").append(schedule.getBusId());
+    line.append(",").append(schedule.getDriverId()).append(",").append(schedule.getDate());
+    line.append(",").append(schedule.getDepartureTime()).append(",").append(schedule.getArrivalTime());
+}
+
+string DataSaver::formatUser(const User &user)
+{
+    return user.getUsername() + "," + user.getPassword() + "," + user.getRoleString();
+}
+
+bool DataSaver::saveFormatted(const string &filename, const string &contents, size_t count, const string &what)
+{
+    if (!writeFileAtomically(filename, contents))
     {
-        file << route.getId() << ","
-             << route.getOrigin() << ","
-             << route.getDestination() << ","
-             << route.getStopsAsString() << ","
-             << route.getEstimatedTravelTime() << endl;
+        return false;
     }
 
-    file.close();
-    cout << "Successfully saved " << routes.size() << " routes to " << filename << endl;
+    messageStream() << "Successfully saved " << count << " " << what << " to " << filename << endl;
     return true;
 }
 
-bool DataSaver::saveSchedules(const string &filename, const vector<Schedule> &schedules)
+string DataSaver::formatBuses(const vector<Bus> &buses)
+{
+    string contents;
+    for (const auto &bus : buses)
+    {
+        contents += formatBus(bus);
+        contents += '\n';
+    }
+    return contents;
+}
+
+bool DataSaver::saveBuses(const string &filename, const vector<Bus> &buses)
 {
-    ofstream file(filename);
+    return saveFormatted(filename, formatBuses(buses), buses.size(), "buses");
+}
 
-    if (!file.is_open())
+string DataSaver::formatDrivers(const vector<Driver> &drivers)
+{
+    string contents;
+    for (const auto &driver : drivers)
     {
-        cerr << "Error: Could not open file " << filename << " for writing." << endl;
-        return false;
+        contents += formatDriver(driver);
+        contents += '\n';
+    }
+    return contents;
+}
+
+bool DataSaver::saveDrivers(const string &filename, const vector<Driver> &drivers)
+{
+    return saveFormatted(filename, formatDrivers(drivers), drivers.size(), "drivers");
+}
+
+string DataSaver::formatRoutes(const vector<Route> &routes)
+{
+    string contents;
+    for (const auto &route : routes)
+    {
+        contents += formatRoute(route);
+        contents += '\n';
     }
+    return contents;
+}
 
+bool DataSaver::saveRoutes(const string &filename, const vector<Route> &routes)
+{
+    return saveFormatted(filename, formatRoutes(routes), routes.size(), "routes");
+}
+
+string DataSaver::formatSchedules(const vector<Schedule> &schedules)
+{
+    string contents;
     for (const auto &schedule : schedules)
     {
-        file << schedule.getId() << ","
-             << schedule.getRouteId() << ","
-             << schedule.getBusId() << ","
-             << schedule.getDriverId() << ","
-             << schedule.getDate() << ","
-             << schedule.getDepartureTime() << ","
-             << schedule.getArrivalTime() << endl;
+        contents += formatSchedule(schedule);
+        contents += '\n';
     }
+    return contents;
+}
 
-    file.close();
-    cout << "Successfully saved " << schedules.size() << " schedules to " << filename << endl;
-    return true;
+bool DataSaver::saveSchedules(const string &filename, const vector<Schedule> &schedules)
+{
+    return saveFormatted(filename, formatSchedules(schedules), schedules.size(), "schedules");
 }
 
 bool DataSaver::saveCredentials(const string &filename, const vector<User> &users)
 {
-    ofstream file(filename);
+    string contents;
+    for (const auto &user : users)
+    {
+        contents += formatUser(user);
+        contents += '\n';
+    }
 
-    if (!file.is_open())
+    if (!writeFileAtomically(filename, contents))
     {
-        cerr << "Error: Could not open file " << filename << " for writing." << endl;
         return false;
     }
 
-    for (const auto &user : users)
+    messageStream() << "Successfully saved " << users.size() << " users to " << filename << endl;
+    return true;
+}
+
+// Deduplicating string table for the snapshot payload.
+class SnapshotStrings
+{
+private:
+    unordered_map<string, uint32_t> indexes;
+    vector<const string *> ordered;
+
+public:
+    uint32_t add(string_view value)
+    {
+        auto inserted = indexes.emplace(string(value), static_cast<uint32_t>(ordered.size()));
+        if (inserted.second)
+        {
+            ordered.push_back(&inserted.first->first);
+        }
+        return inserted.first->second;
+    }
+
+    void write(string &out) const
+    {
+        SnapshotFormat::putU32(out, static_cast<uint32_t>(ordered.size()));
+        for (const string *value : ordered)
+        {
+            SnapshotFormat::putU32(out, static_cast<uint32_t>(value->size()));
+            out.append(*value);
+        }
+    }
+};
+
+bool DataSaver::saveSnapshot(const string &filename, const SystemData &data,
+                             const vector<string> &sourceFiles)
+{
+    using SnapshotFormat::putU32;
+
+    SnapshotStrings strings;
+    string columns;
+
+    putU32(columns, static_cast<uint32_t>(data.buses.size()));
+    for (const auto &bus : data.buses)
+    {
+        putU32(columns, strings.add(bus.getId().view()));
+    }
+    for (const auto &bus : data.buses)
+    {
+        putU32(columns, static_cast<uint32_t>(bus.getCapacity()));
+    }
+    for (const auto &bus : data.buses)
+    {
+        putU32(columns, strings.add(bus.getModel()));
+    }
+    for (const auto &bus : data.buses)
+    {
+        putU32(columns, strings.add(bus.getStatus()));
+    }
+
+    putU32(columns, static_cast<uint32_t>(data.drivers.size()));
+    for (const auto &driver : data.drivers)
+    {
+        putU32(columns, strings.add(driver.getId().view()));
+    }
+    for (const auto &driver : data.drivers)
+    {
+        putU32(columns, strings.add(driver.getName()));
+    }
+    for (const auto &driver : data.drivers)
+    {
+        putU32(columns, strings.add(driver.getContactInfo()));
+    }
+    for (const auto &driver : data.drivers)
+    {
+        putU32(columns, strings.add(driver.getLicenseDetails()));
+    }
+
+    putU32(columns, static_cast<uint32_t>(data.routes.size()));
+    for (const auto &route : data.routes)
+    {
+        putU32(columns, strings.add(route.getId().view()));
+    }
+    for (const auto &route : data.routes)
+    {
+        putU32(columns, strings.add(route.getOrigin()));
+    }
+    for (const auto &route : data.routes)
+    {
+        putU32(columns, strings.add(route.getDestination()));
+    }
+    for (const auto &route : data.routes)
+    {
+        putU32(columns, static_cast<uint32_t>(route.getEstimatedTravelTime()));
+    }
+    for (const auto &route : data.routes)
+    {
+        putU32(columns, static_cast<uint32_t>(route.getKeyStopSymbols().size()));
+    }
+    for (const auto &route : data.routes)
+    {
+        for (Symbol stop : route.getKeyStopSymbols())
+        {
+            putU32(columns, strings.add(SymbolTable::name(stop)));
+        }
+    }
+
+    putU32(columns, static_cast<uint32_t>(data.schedules.size()));
+    for (const auto &schedule : data.schedules)
+    {
+        putU32(columns, strings.add(schedule.getId().view()));
+    }
+    for (const auto &schedule : data.schedules)
+    {
+        putU32(columns, strings.add(schedule.getRouteId()));
+    }
+    for (const auto &schedule : data.schedules)
+    {
+        putU32(columns, strings.add(schedule.getBusId()));
+    }
+    for (const auto &schedule : data.schedules)
+    {
+        putU32(columns, strings.add(schedule.getDriverId()));
+    }
+    for (const auto &schedule : data.schedules)
+    {
+        putU32(columns, static_cast<uint32_t>(schedule.getDay()));
+    }
+    for (const auto &schedule : data.schedules)
+    {
+        putU32(columns, (static_cast<uint32_t>(static_cast<uint16_t>(schedule.getDepartureMinutes())) << 16) |
+                            static_cast<uint16_t>(schedule.getArrivalMinutes()));
+    }
+
+    putU32(columns, static_cast<uint32_t>(data.users.size()));
+    for (const auto &user : data.users)
+    {
+        putU32(columns, strings.add(user.getUsername()));
+    }
+    for (const auto &user : data.users)
     {
-        file << user.getUsername() << ","
-             << user.getPassword() << ","
-             << user.getRoleString() << endl;
+        putU32(columns, strings.add(user.getPassword()));
+    }
+    for (const auto &user : data.users)
+    {
+        putU32(columns, static_cast<uint32_t>(user.getRole()));
+    }
+
+    string payload;
+    strings.write(payload);
+    payload += columns;
+
+    string header(SnapshotFormat::MAGIC, 4);
+    putU32(header, SnapshotFormat::VERSION);
+    SnapshotFormat::putU64(header, payload.size());
+    SnapshotFormat::putU64(header, SnapshotFormat::checksum(payload));
+    putU32(header, static_cast<uint32_t>(sourceFiles.size()));
+    for (const auto &source : sourceFiles)
+    {
+        SnapshotFormat::SourceStamp stamp;
+        if (!SnapshotFormat::stampFile(source, stamp))
+        {
+            errorStream() << "Error: Could not stamp snapshot source " << source << endl;
+            return false;
+        }
+        SnapshotFormat::putU64(header, stamp.size);
+        SnapshotFormat::putU64(header, static_cast<uint64_t>(stamp.modified));
+    }
+
+    if (!writeFileAtomically(filename, header + payload))
+    {
+        errorStream() << "Error: Could not write snapshot " << filename << endl;
+        return false;
     }
 
-    file.close();
-    cout << "Successfully saved " << users.size() << " users to " << filename << endl;
+    messageStream() << "Successfully saved snapshot to " << filename << endl;
     return true;
 }
@@ -0,0 +1,124 @@
+﻿#include "../include/DepartureBoard.h"
+#include <algorithm>
+#include <tuple>
+
+using namespace std;
+
+static bool departsBefore(const DepartureBoard::Departure &a, const DepartureBoard::Departure &b)
+{
+    return tie(a.time, a.schedule.slot) < tie(b.time, b.schedule.slot);
+}
+
+template <typename Visit>
+void DepartureBoard::forEachStop(const Schedule &schedule, Visit visit) const
+{
+    auto route = routeStops.find(schedule.getRouteSymbol());
+    if (route == routeStops.end() || schedule.getDay() == Schedule::INVALID_DAY)
+    {
+        return;
+    }
+    const RouteStops &stops = route->second;
+    int64_t start = static_cast<int64_t>(schedule.getDay()) * MINUTES_PER_DAY + schedule.getDepartureMinutes();
+    for (uint32_t k = 0; k < stops.stops.size(); ++k)
+    {
+        visit(stops.stops[k], start + stops.travelTime * static_cast<int32_t>(k) / static_cast<int32_t>(stops.hops));
+    }
+}
+
+void DepartureBoard::build(const vector<Route> &routes, const vector<Schedule> &schedules,
+                           const SlotMap<Schedule> &slots)
+{
+    clear();
+    for (const auto &route : routes)
+    {
+        RouteStops stops;
+        stops.stops.push_back(SymbolTable::intern(route.getOrigin()));
+        stops.stops.insert(stops.stops.end(), route.getKeyStopSymbols().begin(), route.getKeyStopSymbols().end());
+        stops.travelTime = route.getEstimatedTravelTime();
+        stops.hops = static_cast<uint32_t>(stops.stops.size());
+        routeStops[SymbolTable::intern(route.getId().view())] = move(stops);
+    }
+
+    for (size_t row = 0; row < schedules.size(); ++row)
+    {
+        Handle handle = slots.handleAt(row);
+        forEachStop(schedules[row], [this, handle](Symbol stop, int64_t time)
+                    { boards[stop].push_back({time, handle}); });
+    }
+    for (auto &board : boards)
+    {
+        sort(board.second.begin(), board.second.end(), departsBefore);
+        departures += board.second.size();
+    }
+    built = true;
+}
+
+void DepartureBoard::clear()
+{
+    routeStops.clear();
+    boards.clear();
+    departures = 0;
+    built = false;
+}
+
+void DepartureBoard::insert(const Schedule &schedule, Handle handle)
+{
+    forEachStop(schedule, [this, handle](Symbol stop, int64_t time)
+                {
+        vector<Departure> &board = boards[stop];
+        Departure departure = {time, handle};
+        board.insert(upper_bound(board.begin(), board.end(), departure, departsBefore), departure);
+        departures++; });
+}
+
+void DepartureBoard::erase(const Schedule &schedule, Handle handle)
+{
+    forEachStop(schedule, [this, handle](Symbol stop, int64_t time)
+                {
+        auto found = boards.find(stop);
+        if (found == boards.end())
+        {
+            return;
+        }
+        vector<Departure> &board = found->second;
+        auto entry = lower_bound(board.begin(), board.end(), Departure{time, handle}, departsBefore);
+        if (entry != board.end() && entry->time == time && entry->schedule == handle)
+        {
+            board.erase(entry);
+            departures--;
+        } });
+}
+
+vector<DepartureBoard::Departure> DepartureBoard::next(string_view stop, int32_t day, int16_t minute,
+                                                       size_t count) const
+{
+    vector<Departure> upcoming;
+    Symbol name;
+    if (!SymbolTable::find(stop, name))
+    {
+        return upcoming;
+    }
+    auto found = boards.find(name);
+    if (found == boards.end())
+    {
+        return upcoming;
+    }
+
+    const vector<Departure> &board = found->second;
+    int64_t after = static_cast<int64_t>(day) * MINUTES_PER_DAY + minute;
+    auto first = lower_bound(board.begin(), board.end(), after, [](const Departure &departure, int64_t time)
+                             { return departure.time < time; });
+    size_t available = static_cast<size_t>(board.end() - first);
+    upcoming.assign(first, first + min(count, available));
+    return upcoming;
+}
+
+bool DepartureBoard::isBuilt() const
+{
+    return built;
+}
+
+size_t DepartureBoard::departureCount() const
+{
+    return departures;
+}
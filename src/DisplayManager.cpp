@@ -1,4 +1,6 @@
 ﻿#include "../include/DisplayManager.h"
+#include "../include/DepartureBoard.h"
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 
@@ -75,6 +77,17 @@ void DisplayManager::displayDrivers(const vector<Driver> &drivers)
 }
 
 void DisplayManager::displayRoutes(const vector<Route> &routes)
+{
+    vector<const Route *> views;
+    views.reserve(routes.size());
+    for (const auto &route : routes)
+    {
+        views.push_back(&route);
+    }
+    displayRoutes(views);
+}
+
+void DisplayManager::displayRoutes(const vector<const Route *> &routes)
 {
     printHeader("ROUTE INFORMATION");
 
@@ -94,9 +107,9 @@ void DisplayManager::displayRoutes(const vector<Route> &routes)
          << endl;
     printSeparator();
 
-    for (const auto &route : routes)
+    for (const Route *route : routes)
     {
-        route.display();
+        route->display();
     }
 
     printSeparator();
@@ -105,6 +118,11 @@ void DisplayManager::displayRoutes(const vector<Route> &routes)
 }
 
 void DisplayManager::displaySchedules(const vector<Schedule> &schedules)
+{
+    displaySchedules(ScheduleView(schedules));
+}
+
+void DisplayManager::displaySchedules(const ScheduleView &schedules)
 {
     printHeader("SCHEDULE INFORMATION");
 
@@ -164,6 +182,147 @@ void DisplayManager::displayUsers(const vector<User> &users)
     printSeparator();
 }
 
+void DisplayManager::displayConflictReport(const TimetableAudit::Report &report)
+{
+    printHeader("TIMETABLE CONFLICT AUDIT");
+
+    cout << "Checked " << report.schedulesChecked << " schedules on " << report.datesChecked << " dates." << endl;
+    if (report.clean())
+    {
+        cout << "No bus or driver is double-booked." << endl;
+        printSeparator();
+        return;
+    }
+
+    cout << left
+         << setw(8) << "Type"
+         << setw(12) << "Resource"
+         << setw(12) << "Date"
+         << setw(22) << "Schedule"
+         << setw(22) << "Overlaps With"
+         << setw(14) << "Overlap"
+         << endl;
+    printSeparator();
+
+    for (const auto &conflict : report.conflicts)
+    {
+        cout << left
+             << setw(8) << (conflict.kind == TimetableAudit::Resource::Bus ? "Bus" : "Driver")
+             << setw(12) << SymbolTable::name(conflict.resource)
+             << setw(12) << Schedule::formatDate(conflict.day)
+             << setw(22) << conflict.first
+             << setw(22) << conflict.second
+             << setw(14) << Schedule::formatTime(conflict.overlapStart) + "-" + Schedule::formatTime(conflict.overlapEnd)
+             << endl;
+    }
+
+    printSeparator();
+    cout << "Bus conflicts: " << report.count(TimetableAudit::Resource::Bus)
+         << ", driver conflicts: " << report.count(TimetableAudit::Resource::Driver) << endl;
+    printSeparator();
+}
+
+void DisplayManager::displayItineraries(const vector<JourneyPlanner::Itinerary> &itineraries)
+{
+    printHeader("JOURNEY OPTIONS");
+
+    auto formatMinutes = [](int64_t minutes)
+    {
+        int32_t day = static_cast<int32_t>(minutes / JourneyPlanner::MINUTES_PER_DAY);
+        int16_t minute = static_cast<int16_t>(minutes % JourneyPlanner::MINUTES_PER_DAY);
+        return Schedule::formatDate(day) + " " + Schedule::formatTime(minute);
+    };
+
+    for (size_t i = 0; i < itineraries.size(); ++i)
+    {
+        const JourneyPlanner::Itinerary &itinerary = itineraries[i];
+        cout << "Option " << i + 1 << ": arrive " << formatMinutes(itinerary.arrival()) << ", "
+             << itinerary.transfers() << (itinerary.transfers() == 1 ? " transfer" : " transfers") << endl;
+
+        cout << left
+             << setw(12) << "Route ID"
+             << setw(12) << "Schedule ID"
+             << setw(20) << "From"
+             << setw(18) << "Departs"
+             << setw(20) << "To"
+             << setw(18) << "Arrives"
+             << endl;
+        printSeparator();
+        for (const auto &leg : itinerary.legs)
+        {
+            cout << left
+                 << setw(12) << leg.routeId
+                 << setw(12) << leg.scheduleId
+                 << setw(20) << SymbolTable::name(leg.from)
+                 << setw(18) << formatMinutes(leg.departure)
+                 << setw(20) << SymbolTable::name(leg.to)
+                 << setw(18) << formatMinutes(leg.arrival)
+                 << endl;
+        }
+        printSeparator();
+    }
+    cout << "Times at key stops are estimated between each trip's departure and arrival." << endl;
+    printSeparator();
+}
+
+void DisplayManager::displayDepartures(const string &stop, const vector<pair<int64_t, const Schedule *>> &departures)
+{
+    printHeader("DEPARTURES FROM " + stop);
+
+    cout << left
+         << setw(14) << "Date"
+         << setw(10) << "Departs"
+         << setw(12) << "Route ID"
+         << setw(14) << "Schedule ID"
+         << setw(12) << "Bus ID"
+         << endl;
+    printSeparator();
+
+    for (const auto &departure : departures)
+    {
+        int32_t day = static_cast<int32_t>(departure.first / DepartureBoard::MINUTES_PER_DAY);
+        int16_t minute = static_cast<int16_t>(departure.first % DepartureBoard::MINUTES_PER_DAY);
+        cout << left
+             << setw(14) << Schedule::formatDate(day)
+             << setw(10) << Schedule::formatTime(minute)
+             << setw(12) << departure.second->getRouteId()
+             << setw(14) << departure.second->getId()
+             << setw(12) << departure.second->getBusId()
+             << endl;
+    }
+
+    printSeparator();
+    cout << "Times at key stops are estimated from each route's travel time." << endl;
+    printSeparator();
+}
+
+void DisplayManager::displayFreeResources(const vector<Symbol> &freeBuses, const vector<Symbol> &freeDrivers,
+                                          size_t limit)
+{
+    printHeader("AVAILABLE BUSES AND DRIVERS");
+
+    auto list = [limit](const string &title, const vector<Symbol> &resources)
+    {
+        cout << title << " (" << resources.size() << "):" << endl;
+        size_t shown = min(limit, resources.size());
+        for (size_t i = 0; i < shown; ++i)
+        {
+            cout << (i % 8 == 0 ? "  " : ", ") << SymbolTable::name(resources[i]);
+            if (i % 8 == 7 || i + 1 == shown)
+            {
+                cout << endl;
+            }
+        }
+        if (shown < resources.size())
+        {
+            cout << "  ... and " << resources.size() - shown << " more" << endl;
+        }
+    };
+    list("Active buses", freeBuses);
+    list("Drivers", freeDrivers);
+    printSeparator();
+}
+
 void DisplayManager::displayBus(const Bus &bus)
 {
     cout << left
@@ -215,3 +374,42 @@ void DisplayManager::displaySchedule(const Schedule &schedule)
     printSeparator();
     schedule.display();
 }
+
+void DisplayManager::displayAssignmentReport(const AssignmentPlanner::Report &report)
+{
+    printHeader("AUTOMATIC ASSIGNMENT PLAN");
+
+    cout << "Planned " << report.assigned.size() + report.unassigned.size() << " trips on "
+         << report.datesPlanned << " dates." << endl;
+    if (!report.assigned.empty())
+    {
+        cout << left
+             << setw(12) << "Schedule ID"
+             << setw(12) << "Route ID"
+             << setw(10) << "Bus ID"
+             << setw(12) << "Driver ID"
+             << setw(12) << "Date"
+             << setw(10) << "Departure"
+             << setw(10) << "Arrival"
+             << endl;
+        printSeparator();
+        for (const auto &schedule : report.assigned)
+        {
+            schedule.display();
+        }
+        printSeparator();
+    }
+
+    cout << "Assigned trips: " << report.assigned.size() << " using " << report.busesUsed << " buses and "
+         << report.driversUsed << " drivers" << endl;
+    if (!report.unassigned.empty())
+    {
+        cout << "Not assigned (invalid times or no free bus or driver): ";
+        for (size_t i = 0; i < report.unassigned.size(); ++i)
+        {
+            cout << (i > 0 ? ", " : "") << report.unassigned[i];
+        }
+        cout << endl;
+    }
+    printSeparator();
+}
@@ -3,34 +3,37 @@
 
 using namespace std;
 
-Driver::Driver() : id(""), name(""), contactInfo(""), licenseDetails("") {}
-Driver::Driver(const string &id, const string &name,
-               const string &contactInfo, const string &licenseDetails)
-    : id(id), name(name), contactInfo(contactInfo), licenseDetails(licenseDetails) {}
+Driver::Driver()
+    : id(), name(LoadArena::current()), contactInfo(LoadArena::current()),
+      licenseDetails(LoadArena::current()) {}
+Driver::Driver(const string &id, string_view name,
+               string_view contactInfo, string_view licenseDetails)
+    : id(id), name(name, LoadArena::current()), contactInfo(contactInfo, LoadArena::current()),
+      licenseDetails(licenseDetails, LoadArena::current()) {}
 
-string Driver::getId() const
+const EntityId &Driver::getId() const
 {
     return id;
 }
 
-string Driver::getName() const
+string_view Driver::getName() const
 {
     return name;
 }
 
-string Driver::getContactInfo() const
+string_view Driver::getContactInfo() const
 {
     return contactInfo;
 }
 
-string Driver::getLicenseDetails() const
+string_view Driver::getLicenseDetails() const
 {
     return licenseDetails;
 }
 
 void Driver::setId(const string &id)
 {
-    this->id = id;
+    this->id = EntityId(id);
 }
 
 void Driver::setName(const string &name)
@@ -170,30 +170,25 @@ void DriverDashboard::viewAssignedSchedule()
         return;
     }
 
-    vector<Schedule> driverSchedules = scheduleManager.getSchedulesByDriver(driverId);
-
-    if (driverSchedules.empty())
-    {
-        cout << "No schedules assigned to you." << endl;
-        return;
-    }
-
+    // Driver and date are matched together in one pass over the schedule columns.
+    ScheduleQuery query;
+    query.driver(driverId);
     if (!date.empty())
     {
-        vector<Schedule> filteredSchedules;
-        for (const auto &schedule : driverSchedules)
-        {
-            if (schedule.getDate() == date)
-            {
-                filteredSchedules.push_back(schedule);
-            }
-        }
-        driverSchedules = filteredSchedules;
+        query.date(date);
     }
+    ScheduleView driverSchedules = scheduleManager.findSchedules(query);
 
     if (driverSchedules.empty())
     {
-        cout << "No schedules found for the specified date." << endl;
+        if (date.empty() || scheduleManager.getSchedulesByDriver(driverId).empty())
+        {
+            cout << "No schedules assigned to you." << endl;
+        }
+        else
+        {
+            cout << "No schedules found for the specified date." << endl;
+        }
         return;
     }
 
@@ -244,8 +239,9 @@ void DriverDashboard::updateContactInfo()
         }
     } while (!validateContact(newContact));
 
-    driverProfile->setContactInfo(newContact);
-    if (driverManager.updateDriver(driverId, *driverProfile))
+    Driver updated = *driverProfile;
+    updated.setContactInfo(newContact);
+    if (driverManager.updateDriver(driverId, updated))
     {
         cout << "Contact information updated successfully." << endl;
     }
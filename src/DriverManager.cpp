@@ -1,4 +1,5 @@
 ﻿#include "../include/DriverManager.h"
+#include "../include/DataLoader.h"
 #include "../include/DataSaver.h"
 #include "../include/DisplayManager.h"
 #include <iostream>
@@ -7,7 +8,19 @@
 using namespace std;
 
 DriverManager::DriverManager(vector<Driver> &driverList, const string &filename)
-    : drivers(driverList), dataFile(filename) {}
+    : drivers(driverList), dataFile(filename),
+      log(filename + ".log"), compactionThreshold(OperationLog::DEFAULT_COMPACTION_THRESHOLD),
+      flusher(nullptr), flushHandle(0), slots(drivers), revision(0)
+{
+    size_t replayed = log.replay(drivers, DataLoader::parseDriverRecord, dataFile);
+    if (replayed > 0)
+    {
+        cout << "Replayed " << replayed << " logged driver changes from " << log.getFilename() << endl;
+        slots.rebuild();
+    }
+
+    index.rebuild(drivers, slots);
+}
 
 bool DriverManager::validateDriver(const Driver &driver) const
 {
@@ -17,6 +30,12 @@ bool DriverManager::validateDriver(const Driver &driver) const
         return false;
     }
 
+    if (!driver.getId().isValid())
+    {
+        cout << "Error: Driver ID must be at most " << EntityId::CAPACITY << " characters." << endl;
+        return false;
+    }
+
     if (driver.getName().empty())
     {
         cout << "Error: Driver name must be provided." << endl;
@@ -38,27 +57,32 @@ bool DriverManager::validateDriver(const Driver &driver) const
     return true;
 }
 
-bool DriverManager::driverExists(const string &driverId) const
+bool DriverManager::driverExists(const EntityId &driverId) const
 {
-    return any_of(drivers.begin(), drivers.end(),
-                  [&driverId](const Driver &d)
-                  { return d.getId() == driverId; });
+    return index.contains(driverId);
 }
 
-Driver *DriverManager::findDriver(const string &driverId)
+size_t DriverManager::getRevision() const
 {
-    auto it = find_if(drivers.begin(), drivers.end(),
-                      [&driverId](const Driver &d)
-                      { return d.getId() == driverId; });
+    return revision;
+}
 
-    if (it != drivers.end())
-    {
-        return &(*it);
-    }
-    return nullptr;
+Driver *DriverManager::findDriver(const EntityId &driverId)
+{
+    return slots.get(index.find(driverId));
 }
 
-bool DriverManager::addDriver(const Driver &newDriver)
+DriverManager::Handle DriverManager::findDriverHandle(const EntityId &driverId) const
+{
+    return index.find(driverId);
+}
+
+Driver *DriverManager::getDriver(Handle handle)
+{
+    return slots.get(handle);
+}
+
+bool DriverManager::checkAdd(const Driver &newDriver) const
 {
     if (!validateDriver(newDriver))
     {
@@ -70,49 +94,115 @@ bool DriverManager::addDriver(const Driver &newDriver)
         cout << "Error: Driver with ID " << newDriver.getId() << " already exists." << endl;
         return false;
     }
+    return true;
+}
 
-    drivers.push_back(newDriver);
-    cout << "Driver " << newDriver.getId() << " added successfully." << endl;
+bool DriverManager::checkUpdate(const EntityId &driverId, const Driver &updatedDriver) const
+{
+    if (!driverExists(driverId))
+    {
+        cout << "Error: Driver with ID " << driverId << " not found." << endl;
+        return false;
+    }
 
-    return saveToFile();
+    if (!validateDriver(updatedDriver))
+    {
+        return false;
+    }
+
+    if (updatedDriver.getId() != driverId && driverExists(updatedDriver.getId()))
+    {
+        cout << "Error: Driver with ID " << updatedDriver.getId() << " already exists." << endl;
+        return false;
+    }
+    return true;
 }
 
-bool DriverManager::updateDriver(const string &driverId, const Driver &updatedDriver)
+bool DriverManager::checkRemove(const EntityId &driverId) const
 {
-    Driver *driver = findDriver(driverId);
-    if (!driver)
+    if (!driverExists(driverId))
     {
         cout << "Error: Driver with ID " << driverId << " not found." << endl;
         return false;
     }
+    return true;
+}
 
-    if (!validateDriver(updatedDriver))
+void DriverManager::applyAdd(const Driver &newDriver)
+{
+    revision++;
+    index.insert(newDriver.getId(), slots.insert(newDriver));
+}
+
+void DriverManager::applyUpdate(const EntityId &driverId, const Driver &updatedDriver)
+{
+    revision++;
+    LoadArena::replace(*findDriver(driverId), updatedDriver);
+    index.rename(driverId, updatedDriver.getId());
+}
+
+void DriverManager::applyRemove(const EntityId &driverId)
+{
+    revision++;
+    index.erase(driverId, drivers, slots);
+}
+
+bool DriverManager::addDriver(const Driver &newDriver)
+{
+    FlushScheduler::Guard guard(flusher);
+
+    if (!checkAdd(newDriver))
     {
         return false;
     }
 
-    *driver = updatedDriver;
+    applyAdd(newDriver);
+    cout << "Driver " << newDriver.getId() << " added successfully." << endl;
+
+    return persist('A', newDriver.getId(), &newDriver);
+}
+
+bool DriverManager::updateDriver(const EntityId &driverId, const Driver &updatedDriver)
+{
+    FlushScheduler::Guard guard(flusher);
+
+    if (!checkUpdate(driverId, updatedDriver))
+    {
+        return false;
+    }
+
+    applyUpdate(driverId, updatedDriver);
     cout << "Driver " << driverId << " updated successfully." << endl;
 
-    return saveToFile();
+    return persist('U', driverId, &updatedDriver);
 }
 
-bool DriverManager::removeDriver(const string &driverId)
+bool DriverManager::updateDriver(Handle handle, const Driver &updatedDriver)
 {
-    auto it = find_if(drivers.begin(), drivers.end(),
-                      [&driverId](const Driver &d)
-                      { return d.getId() == driverId; });
+    const Driver *driver = slots.get(handle);
+    if (!driver)
+    {
+        cout << "Error: Driver no longer exists." << endl;
+        return false;
+    }
+    // Copied: the update overwrites the stored ID.
+    EntityId driverId = driver->getId();
+    return updateDriver(driverId, updatedDriver);
+}
 
-    if (it == drivers.end())
+bool DriverManager::removeDriver(const EntityId &driverId)
+{
+    FlushScheduler::Guard guard(flusher);
+
+    if (!checkRemove(driverId))
     {
-        cout << "Error: Driver with ID " << driverId << " not found." << endl;
         return false;
     }
 
-    drivers.erase(it);
+    applyRemove(driverId);
     cout << "Driver " << driverId << " removed successfully." << endl;
 
-    return saveToFile();
+    return persist('R', driverId);
 }
 
 bool DriverManager::saveToFile()
@@ -120,6 +210,97 @@ bool DriverManager::saveToFile()
     return DataSaver::saveDrivers(dataFile, drivers);
 }
 
+bool DriverManager::persist(char operation, const EntityId &driverId, const Driver *driver)
+{
+    if (!log.append(operation, driverId.view(), driver ? DataSaver::formatDriver(*driver) : ""))
+    {
+        return false;
+    }
+
+    if (flusher)
+    {
+        flusher->markDirty(flushHandle);
+        return true;
+    }
+
+    if (log.size() >= compactionThreshold)
+    {
+        return compact();
+    }
+    return true;
+}
+
+bool DriverManager::persistBatch(const vector<LogEntry> &entries)
+{
+    if (!log.appendAll(entries))
+    {
+        return false;
+    }
+
+    if (flusher)
+    {
+        flusher->markDirty(flushHandle);
+        return true;
+    }
+
+    if (log.size() >= compactionThreshold)
+    {
+        return compact();
+    }
+    return true;
+}
+
+bool DriverManager::compact()
+{
+    lock_guard<mutex> compacting(compactMutex);
+
+    string contents;
+    size_t count;
+    {
+        FlushScheduler::Guard guard(flusher);
+        contents = DataSaver::formatDrivers(drivers);
+        count = drivers.size();
+        if (!log.checkpoint(contents))
+        {
+            return false;
+        }
+    }
+
+    if (!log.sync() || !DataSaver::saveFormatted(dataFile, contents, count, "drivers"))
+    {
+        return false;
+    }
+
+    FlushScheduler::Guard guard(flusher);
+    return log.trimToCheckpoint();
+}
+
+bool DriverManager::commitLog()
+{
+    bool due;
+    {
+        FlushScheduler::Guard guard(flusher);
+        due = log.size() >= compactionThreshold;
+    }
+    return log.sync() && (!due || compact());
+}
+
+void DriverManager::setCompactionThreshold(size_t entries)
+{
+    compactionThreshold = max<size_t>(1, entries);
+}
+
+void DriverManager::attachFlusher(FlushScheduler &scheduler)
+{
+    flusher = &scheduler;
+    flushHandle = scheduler.registerFile(dataFile, [this]()
+                                         { return commitLog(); });
+    if (log.size() > 0)
+    {
+        scheduler.markDirty(flushHandle);
+    }
+}
+
 void DriverManager::displayAllDrivers() const
 {
     DisplayManager::displayDrivers(drivers);
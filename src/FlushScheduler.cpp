@@ -0,0 +1,200 @@
+﻿#include "../include/FlushScheduler.h"
+#include "../include/DataSaver.h"
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+FlushScheduler::Guard::Guard(FlushScheduler *scheduler)
+{
+    if (scheduler)
+    {
+        lock = unique_lock<mutex>(scheduler->dataLock());
+    }
+}
+
+FlushScheduler::FlushScheduler(unsigned windowMs)
+    : window(windowMs), stopping(false), writeCount(0)
+{
+    worker = thread(&FlushScheduler::run, this);
+}
+
+FlushScheduler::~FlushScheduler()
+{
+    {
+        lock_guard<mutex> state(stateMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    worker.join();
+
+    flush();
+}
+
+size_t FlushScheduler::registerFile(const string &name, FlushFn flushFn)
+{
+    lock_guard<mutex> state(stateMutex);
+    entries.push_back({name, flushFn, false});
+    return entries.size() - 1;
+}
+
+void FlushScheduler::markDirty(size_t handle)
+{
+    {
+        lock_guard<mutex> state(stateMutex);
+        if (handle >= entries.size() || entries[handle].dirty)
+        {
+            return;
+        }
+        entries[handle].dirty = true;
+    }
+    wakeUp.notify_all();
+}
+
+bool FlushScheduler::flush()
+{
+    bool success = writeDirty(false);
+    wakeUp.notify_all();
+    return success;
+}
+
+void FlushScheduler::setWindow(unsigned windowMs)
+{
+    {
+        lock_guard<mutex> state(stateMutex);
+        window = windowMs;
+    }
+    wakeUp.notify_all();
+}
+
+unsigned FlushScheduler::getWindow() const
+{
+    lock_guard<mutex> state(stateMutex);
+    return window;
+}
+
+mutex &FlushScheduler::dataLock()
+{
+    return dataMutex;
+}
+
+size_t FlushScheduler::pendingCount() const
+{
+    lock_guard<mutex> state(stateMutex);
+    size_t pending = 0;
+    for (const auto &entry : entries)
+    {
+        if (entry.dirty)
+        {
+            pending++;
+        }
+    }
+    return pending;
+}
+
+size_t FlushScheduler::getWriteCount() const
+{
+    lock_guard<mutex> state(stateMutex);
+    return writeCount;
+}
+
+void FlushScheduler::run()
+{
+    unique_lock<mutex> state(stateMutex);
+
+    auto anyDirty = [this]()
+    {
+        for (const auto &entry : entries)
+        {
+            if (entry.dirty)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    while (!stopping)
+    {
+        wakeUp.wait(state, [&]()
+                    { return stopping || anyDirty(); });
+
+        // Let further mutations join this commit before writing. The
+        // deadline is recomputed on every wake so setWindow applies to an
+        // open window, and a barrier that already wrote everything ends it.
+        auto opened = chrono::steady_clock::now();
+        while (!stopping && anyDirty())
+        {
+            auto deadline = opened + chrono::milliseconds(window);
+            if (chrono::steady_clock::now() >= deadline)
+            {
+                break;
+            }
+            wakeUp.wait_until(state, deadline);
+        }
+
+        if (stopping || !anyDirty())
+        {
+            continue;
+        }
+
+        state.unlock();
+        writeDirty(true);
+        state.lock();
+    }
+}
+
+bool FlushScheduler::writeDirty(bool quiet)
+{
+    // Writers run one at a time; the flush functions take the data lock
+    // only while they read the managers' state.
+    lock_guard<mutex> writing(writeMutex);
+
+    vector<size_t> dirty;
+    vector<FlushFn> flushFns;
+    {
+        lock_guard<mutex> state(stateMutex);
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            if (entries[i].dirty)
+            {
+                entries[i].dirty = false;
+                dirty.push_back(i);
+                flushFns.push_back(entries[i].flushFn);
+            }
+        }
+    }
+
+    // Background commits should not print into the menus.
+    ostream discard(nullptr);
+    if (quiet)
+    {
+        DataSaver::redirectOutput(&discard, nullptr);
+    }
+
+    bool success = true;
+    for (size_t i = 0; i < dirty.size(); ++i)
+    {
+        size_t handle = dirty[i];
+        bool written = flushFns[i]();
+
+        lock_guard<mutex> state(stateMutex);
+        if (written)
+        {
+            writeCount++;
+        }
+        else
+        {
+            // Keep the file dirty so the next commit retries it.
+            entries[handle].dirty = true;
+            cerr << "Error: Could not flush " << entries[handle].name << endl;
+            success = false;
+        }
+    }
+
+    if (quiet)
+    {
+        DataSaver::redirectOutput(nullptr, nullptr);
+    }
+    return success;
+}
@@ -0,0 +1,123 @@
+﻿#include "../include/IntervalIndex.h"
+#include <algorithm>
+
+using namespace std;
+
+uint64_t IntervalIndex::groupKey(Symbol resource, int32_t day)
+{
+    return (static_cast<uint64_t>(resource) << 32) | static_cast<uint32_t>(day);
+}
+
+const IntervalIndex::Group *IntervalIndex::findGroup(Symbol resource, int32_t day) const
+{
+    auto found = groups.find(groupKey(resource, day));
+    return found == groups.end() ? nullptr : &found->second;
+}
+
+void IntervalIndex::refreshMaxEnd(Group &group, size_t from)
+{
+    for (size_t i = from; i < group.size(); ++i)
+    {
+        int16_t end = group[i].end;
+        group[i].maxEnd = (i == 0 || end > group[i - 1].maxEnd) ? end : group[i - 1].maxEnd;
+    }
+}
+
+void IntervalIndex::clear()
+{
+    groups.clear();
+    count = 0;
+}
+
+void IntervalIndex::insert(Symbol resource, int32_t day, const Interval &interval)
+{
+    Group &group = groups[groupKey(resource, day)];
+
+    auto position = upper_bound(group.begin(), group.end(), interval.start,
+                                [](int16_t start, const Interval &existing)
+                                { return start < existing.start; });
+    size_t slot = position - group.begin();
+
+    group.insert(position, interval);
+    refreshMaxEnd(group, slot);
+    count++;
+}
+
+bool IntervalIndex::erase(Symbol resource, int32_t day, const Interval &interval)
+{
+    auto found = groups.find(groupKey(resource, day));
+    if (found == groups.end())
+    {
+        return false;
+    }
+
+    Group &group = found->second;
+    auto it = find_if(group.begin(), group.end(),
+                      [&interval](const Interval &existing)
+                      {
+                          return existing.scheduleId == interval.scheduleId &&
+                                 existing.start == interval.start && existing.end == interval.end;
+                      });
+    if (it == group.end())
+    {
+        return false;
+    }
+
+    size_t slot = it - group.begin();
+    group.erase(it);
+    count--;
+
+    if (group.empty())
+    {
+        groups.erase(found);
+    }
+    else
+    {
+        refreshMaxEnd(group, slot);
+    }
+    return true;
+}
+
+const IntervalIndex::Interval *IntervalIndex::findOverlap(Symbol resource, int32_t day,
+                                                          int16_t start, int16_t end,
+                                                          const EntityId &excludeId) const
+{
+    const Group *found = findGroup(resource, day);
+    if (!found)
+    {
+        return nullptr;
+    }
+
+    const Group &group = *found;
+
+    // Only intervals departing before the query arrives can overlap it.
+    auto limit = lower_bound(group.begin(), group.end(), end,
+                             [](const Interval &existing, int16_t value)
+                             { return existing.start < value; });
+
+    for (size_t i = limit - group.begin(); i-- > 0;)
+    {
+        const Interval &candidate = group[i];
+        if (candidate.maxEnd <= start)
+        {
+            // Nothing at or before i arrives after the query departs.
+            break;
+        }
+
+        if (candidate.end > start && candidate.scheduleId != excludeId)
+        {
+            return &candidate;
+        }
+    }
+    return nullptr;
+}
+
+const IntervalIndex::Group *IntervalIndex::intervalsOf(Symbol resource, int32_t day) const
+{
+    return findGroup(resource, day);
+}
+
+size_t IntervalIndex::size() const
+{
+    return count;
+}
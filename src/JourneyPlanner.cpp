@@ -0,0 +1,318 @@
+﻿#include "../include/JourneyPlanner.h"
+#include "../include/RouteManager.h"
+#include "../include/ScheduleManager.h"
+#include <algorithm>
+#include <climits>
+#include <tuple>
+
+using namespace std;
+
+static const int64_t UNREACHED = INT64_MAX;
+static const uint32_t NONE = UINT32_MAX;
+
+int64_t JourneyPlanner::Itinerary::arrival() const
+{
+    return legs.empty() ? UNREACHED : legs.back().arrival;
+}
+
+size_t JourneyPlanner::Itinerary::transfers() const
+{
+    return legs.empty() ? 0 : legs.size() - 1;
+}
+
+uint32_t JourneyPlanner::addStop(Symbol name)
+{
+    auto found = stopIndex.find(name);
+    if (found != stopIndex.end())
+    {
+        return found->second;
+    }
+    uint32_t stop = static_cast<uint32_t>(stopNames.size());
+    stopNames.push_back(name);
+    stopIndex.emplace(name, stop);
+    return stop;
+}
+
+int32_t JourneyPlanner::offset(const Pattern &pattern, uint32_t position) const
+{
+    return pattern.duration * static_cast<int32_t>(position) / static_cast<int32_t>(pattern.stopCount - 1);
+}
+
+void JourneyPlanner::build(const vector<Route> &routes, const vector<Schedule> &schedules)
+{
+    stopNames.clear();
+    stopIndex.clear();
+    routeIds.clear();
+    patterns.clear();
+    patternStops.clear();
+    tripDepartures.clear();
+    tripIds.clear();
+
+    // Stop sequence of each route, found through the schedules' interned route IDs.
+    unordered_map<Symbol, uint32_t> routeBySymbol;
+    vector<vector<uint32_t>> routeStops;
+    for (const auto &route : routes)
+    {
+        uint32_t position = static_cast<uint32_t>(routeIds.size());
+        routeBySymbol.emplace(SymbolTable::intern(route.getId().view()), position);
+        routeIds.push_back(route.getId());
+
+        vector<uint32_t> stops;
+        stops.push_back(addStop(SymbolTable::intern(route.getOrigin())));
+        for (Symbol stop : route.getKeyStopSymbols())
+        {
+            stops.push_back(addStop(stop));
+        }
+        stops.push_back(addStop(SymbolTable::intern(route.getDestination())));
+        routeStops.push_back(move(stops));
+    }
+
+    // Trips grouped into patterns by (route, duration), then by departure.
+    struct Trip
+    {
+        uint32_t route;
+        int32_t duration;
+        int64_t departure;
+        uint32_t row;
+    };
+    vector<Trip> trips;
+    trips.reserve(schedules.size());
+    for (uint32_t row = 0; row < schedules.size(); ++row)
+    {
+        const Schedule &schedule = schedules[row];
+        auto route = routeBySymbol.find(schedule.getRouteSymbol());
+        if (route == routeBySymbol.end() || schedule.getDay() == Schedule::INVALID_DAY ||
+            schedule.getArrivalMinutes() <= schedule.getDepartureMinutes())
+        {
+            continue;
+        }
+        trips.push_back({route->second, schedule.getArrivalMinutes() - schedule.getDepartureMinutes(),
+                         static_cast<int64_t>(schedule.getDay()) * MINUTES_PER_DAY + schedule.getDepartureMinutes(), row});
+    }
+    sort(trips.begin(), trips.end(), [](const Trip &a, const Trip &b)
+         { return tie(a.route, a.duration, a.departure, a.row) < tie(b.route, b.duration, b.departure, b.row); });
+
+    tripDepartures.reserve(trips.size());
+    tripIds.reserve(trips.size());
+    for (size_t i = 0; i < trips.size(); ++i)
+    {
+        const Trip &trip = trips[i];
+        if (i == 0 || trip.route != trips[i - 1].route || trip.duration != trips[i - 1].duration)
+        {
+            const vector<uint32_t> &stops = routeStops[trip.route];
+            patterns.push_back({trip.route, static_cast<uint32_t>(patternStops.size()),
+                                static_cast<uint32_t>(stops.size()), trip.duration,
+                                static_cast<uint32_t>(tripDepartures.size()), 0});
+            patternStops.insert(patternStops.end(), stops.begin(), stops.end());
+        }
+        patterns.back().tripCount++;
+        tripDepartures.push_back(trip.departure);
+        tripIds.push_back(schedules[trip.row].getId());
+    }
+
+    // Counting sort of (pattern, position) pairs by stop.
+    visitStart.assign(stopNames.size() + 1, 0);
+    for (uint32_t stop : patternStops)
+    {
+        visitStart[stop + 1]++;
+    }
+    for (size_t s = 0; s < stopNames.size(); ++s)
+    {
+        visitStart[s + 1] += visitStart[s];
+    }
+    visits.assign(patternStops.size(), {0, 0});
+    vector<uint32_t> next(visitStart.begin(), visitStart.end() - 1);
+    for (uint32_t p = 0; p < patterns.size(); ++p)
+    {
+        for (uint32_t i = 0; i < patterns[p].stopCount; ++i)
+        {
+            visits[next[patternStops[patterns[p].firstStop + i]]++] = {p, i};
+        }
+    }
+    built = true;
+}
+
+void JourneyPlanner::refresh(const RouteManager &routeManager, const ScheduleManager &scheduleManager)
+{
+    if (built && routeRevision == routeManager.getRevision() && scheduleRevision == scheduleManager.getRevision())
+    {
+        return;
+    }
+    build(routeManager.getRoutes(), scheduleManager.getSchedules());
+    routeRevision = routeManager.getRevision();
+    scheduleRevision = scheduleManager.getRevision();
+}
+
+vector<JourneyPlanner::Itinerary> JourneyPlanner::plan(string_view from, string_view to, int32_t day,
+                                                       int16_t minute) const
+{
+    return plan(from, to, day, minute, Options());
+}
+
+vector<JourneyPlanner::Itinerary> JourneyPlanner::plan(string_view from, string_view to, int32_t day,
+                                                       int16_t minute, const Options &options) const
+{
+    vector<Itinerary> itineraries;
+
+    Symbol fromName;
+    Symbol toName;
+    if (!SymbolTable::find(from, fromName) || !SymbolTable::find(to, toName))
+    {
+        return itineraries;
+    }
+    auto fromStop = stopIndex.find(fromName);
+    auto toStop = stopIndex.find(toName);
+    if (fromStop == stopIndex.end() || toStop == stopIndex.end() || fromStop == toStop)
+    {
+        return itineraries;
+    }
+    uint32_t source = fromStop->second;
+    uint32_t target = toStop->second;
+
+    // labels[k][s]: earliest arrival at s using at most k trips, and the
+    // trip that achieved it if it improved in round k.
+    struct Label
+    {
+        int64_t arrival;
+        uint32_t pattern;
+        uint32_t trip;
+        uint32_t boardPosition;
+    };
+    size_t rounds = options.maxTransfers + 1;
+    vector<vector<Label>> labels(rounds + 1);
+    labels[0].assign(stopNames.size(), {UNREACHED, NONE, NONE, 0});
+    labels[0][source].arrival = static_cast<int64_t>(day) * MINUTES_PER_DAY + minute;
+
+    vector<int64_t> best(stopNames.size(), UNREACHED);
+    best[source] = labels[0][source].arrival;
+
+    vector<uint32_t> marked = {source};
+    vector<uint8_t> isMarked(stopNames.size(), 0);
+    vector<uint32_t> queueFrom(patterns.size(), NONE);
+    vector<uint32_t> queued;
+
+    for (size_t k = 1; k <= rounds && !marked.empty(); ++k)
+    {
+        const vector<Label> &previous = labels[k - 1];
+        vector<Label> &current = labels[k];
+        current.resize(stopNames.size());
+        for (size_t s = 0; s < stopNames.size(); ++s)
+        {
+            current[s] = {previous[s].arrival, NONE, NONE, 0};
+        }
+
+        // Each pattern is scanned once, from its earliest marked stop.
+        queued.clear();
+        for (uint32_t stop : marked)
+        {
+            isMarked[stop] = 0;
+            for (uint32_t v = visitStart[stop]; v < visitStart[stop + 1]; ++v)
+            {
+                const StopVisit &visit = visits[v];
+                if (queueFrom[visit.pattern] == NONE)
+                {
+                    queued.push_back(visit.pattern);
+                    queueFrom[visit.pattern] = visit.position;
+                }
+                else
+                {
+                    queueFrom[visit.pattern] = min(queueFrom[visit.pattern], visit.position);
+                }
+            }
+        }
+        marked.clear();
+
+        for (uint32_t p : queued)
+        {
+            const Pattern &pattern = patterns[p];
+            const int64_t *departures = tripDepartures.data() + pattern.firstTrip;
+            uint32_t trip = NONE;
+            uint32_t boardPosition = 0;
+
+            for (uint32_t i = queueFrom[p]; i < pattern.stopCount; ++i)
+            {
+                uint32_t stop = patternStops[pattern.firstStop + i];
+                int32_t stopOffset = offset(pattern, i);
+
+                if (trip != NONE)
+                {
+                    int64_t arrival = departures[trip] + stopOffset;
+                    if (arrival < best[stop] && arrival < best[target])
+                    {
+                        current[stop] = {arrival, p, trip, boardPosition};
+                        best[stop] = arrival;
+                        if (!isMarked[stop])
+                        {
+                            isMarked[stop] = 1;
+                            marked.push_back(stop);
+                        }
+                    }
+                }
+
+                // Catch an earlier trip here if the previous round reached this stop in time.
+                int64_t reached = previous[stop].arrival;
+                if (reached == UNREACHED)
+                {
+                    continue;
+                }
+                int64_t ready = reached + (stop == source ? 0 : options.transferMinutes);
+                if (trip != NONE && departures[trip] + stopOffset <= ready)
+                {
+                    continue;
+                }
+                const int64_t *earliest = lower_bound(departures, departures + (trip == NONE ? pattern.tripCount : trip),
+                                                      ready - stopOffset);
+                uint32_t candidate = static_cast<uint32_t>(earliest - departures);
+                if (candidate < (trip == NONE ? pattern.tripCount : trip))
+                {
+                    trip = candidate;
+                    boardPosition = i;
+                }
+            }
+            queueFrom[p] = NONE;
+        }
+
+        if (current[target].pattern == NONE)
+        {
+            continue;
+        }
+
+        // Walk back through the rounds from the target.
+        Itinerary itinerary;
+        uint32_t stop = target;
+        for (size_t round = k; round > 0;)
+        {
+            const Label &label = labels[round][stop];
+            if (label.pattern == NONE)
+            {
+                round--;
+                continue;
+            }
+            const Pattern &pattern = patterns[label.pattern];
+            uint32_t boardStop = patternStops[pattern.firstStop + label.boardPosition];
+            uint32_t trip = pattern.firstTrip + label.trip;
+            itinerary.legs.push_back({tripIds[trip], routeIds[pattern.route], stopNames[boardStop], stopNames[stop],
+                                      tripDepartures[trip] + offset(pattern, label.boardPosition), label.arrival});
+            stop = boardStop;
+            round--;
+        }
+        reverse(itinerary.legs.begin(), itinerary.legs.end());
+        itineraries.push_back(move(itinerary));
+    }
+    return itineraries;
+}
+
+size_t JourneyPlanner::stopCount() const
+{
+    return stopNames.size();
+}
+
+size_t JourneyPlanner::patternCount() const
+{
+    return patterns.size();
+}
+
+size_t JourneyPlanner::tripCount() const
+{
+    return tripDepartures.size();
+}
@@ -0,0 +1,58 @@
+﻿#include "../include/LoadArena.h"
+
+using namespace std;
+
+thread_local pmr::memory_resource *LoadArena::active = nullptr;
+
+void *LoadArena::CountingResource::do_allocate(size_t size, size_t alignment)
+{
+    void *pointer = pmr::new_delete_resource()->allocate(size, alignment);
+    bytes += size;
+    return pointer;
+}
+
+void LoadArena::CountingResource::do_deallocate(void *pointer, size_t size, size_t alignment)
+{
+    pmr::new_delete_resource()->deallocate(pointer, size, alignment);
+    bytes -= size;
+}
+
+bool LoadArena::CountingResource::do_is_equal(const pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+size_t LoadArena::CountingResource::getBytes() const
+{
+    return bytes;
+}
+
+LoadArena::Scope::Scope(LoadArena *arena) : previous(active)
+{
+    if (arena)
+    {
+        active = arena->resource();
+    }
+}
+
+LoadArena::Scope::~Scope()
+{
+    active = previous;
+}
+
+LoadArena::LoadArena() : region(INITIAL_BLOCK_SIZE, &upstream) {}
+
+pmr::memory_resource *LoadArena::resource()
+{
+    return &region;
+}
+
+size_t LoadArena::reservedBytes() const
+{
+    return upstream.getBytes();
+}
+
+pmr::memory_resource *LoadArena::current()
+{
+    return active ? active : pmr::get_default_resource();
+}
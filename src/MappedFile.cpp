@@ -0,0 +1,167 @@
+﻿#include "../include/MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+MappedFile::MappedFile()
+    : data(nullptr), length(0), opened(false), fileHandle(nullptr), mappingHandle(nullptr) {}
+#else
+MappedFile::MappedFile() : data(nullptr), length(0), opened(false), fd(-1) {}
+#endif
+
+MappedFile::MappedFile(const string &filename) : MappedFile()
+{
+    open(filename);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const string &filename)
+{
+    close();
+
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    length = static_cast<size_t>(fileSize.QuadPart);
+    opened = true;
+
+    // Zero-length files cannot be mapped; they are simply empty views.
+    if (length == 0)
+    {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        close();
+        return false;
+    }
+    mappingHandle = mapping;
+
+    data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data)
+    {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle)
+    {
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+    }
+    if (fileHandle)
+    {
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+    }
+    data = nullptr;
+    length = 0;
+    opened = false;
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+}
+#else
+bool MappedFile::open(const string &filename)
+{
+    close();
+
+    int file = ::open(filename.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    fd = file;
+    length = static_cast<size_t>(info.st_size);
+    opened = true;
+
+    // Zero-length files cannot be mapped; they are simply empty views.
+    if (length == 0)
+    {
+        return true;
+    }
+
+    void *address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED)
+    {
+        close();
+        return false;
+    }
+    madvise(address, length, MADV_SEQUENTIAL);
+    data = static_cast<const char *>(address);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data)
+    {
+        munmap(const_cast<char *>(data), length);
+    }
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+    data = nullptr;
+    length = 0;
+    opened = false;
+    fd = -1;
+}
+#endif
+
+bool MappedFile::isOpen() const
+{
+    return opened;
+}
+
+size_t MappedFile::size() const
+{
+    return length;
+}
+
+string_view MappedFile::view() const
+{
+    return string_view(data, length);
+}
@@ -0,0 +1,247 @@
+﻿#include "../include/OperationLog.h"
+#include "../include/DataSaver.h"
+#include "../include/SnapshotFormat.h"
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+OperationLog::OperationLog(const string &filename) : logFile(filename), entryCount(0), checkpointEnd(0)
+{
+    vector<LogEntry> entries = readEntries();
+    entryCount = entries.size();
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        if (entries[i].operation == 'C')
+        {
+            checkpointEnd = i + 1;
+        }
+    }
+}
+
+bool OperationLog::append(char operation, string_view id, const string &record)
+{
+    if (!stream.is_open())
+    {
+        stream.clear();
+        stream.open(logFile, ios::app);
+    }
+
+    if (!stream.is_open())
+    {
+        cerr << "Error: Could not open log " << logFile << " for writing." << endl;
+        return false;
+    }
+
+    stream << operation << '\t' << id << '\t' << record << '\n';
+    stream.flush();
+
+    if (!stream)
+    {
+        stream.close();
+        cerr << "Error: Could not append to log " << logFile << endl;
+        return false;
+    }
+
+    entryCount++;
+    return true;
+}
+
+bool OperationLog::appendAll(const vector<LogEntry> &entries)
+{
+    if (entries.empty())
+    {
+        return true;
+    }
+
+    if (!stream.is_open())
+    {
+        stream.clear();
+        stream.open(logFile, ios::app);
+    }
+
+    if (!stream.is_open())
+    {
+        cerr << "Error: Could not open log " << logFile << " for writing." << endl;
+        return false;
+    }
+
+    for (const auto &entry : entries)
+    {
+        stream << entry.operation << '\t' << entry.id << '\t' << entry.record << '\n';
+    }
+    stream.flush();
+
+    if (!stream)
+    {
+        stream.close();
+        cerr << "Error: Could not append to log " << logFile << endl;
+        return false;
+    }
+
+    entryCount += entries.size();
+    return true;
+}
+
+vector<LogEntry> OperationLog::readEntries() const
+{
+    vector<LogEntry> entries;
+    ifstream file(logFile);
+
+    if (!file.is_open())
+    {
+        return entries;
+    }
+
+    string line;
+    while (getline(file, line))
+    {
+        if (file.eof())
+        {
+            // No trailing newline: the last append did not complete.
+            break;
+        }
+
+        size_t firstTab = line.find('\t');
+        size_t secondTab = (firstTab == string::npos) ? string::npos : line.find('\t', firstTab + 1);
+        if (firstTab != 1 || secondTab == string::npos ||
+            (line[0] != 'A' && line[0] != 'U' && line[0] != 'R' && line[0] != 'C'))
+        {
+            cerr << "Error in " << logFile << ": malformed entry skipped" << endl;
+            continue;
+        }
+
+        entries.push_back({line[0], line.substr(2, secondTab - 2), line.substr(secondTab + 1)});
+    }
+
+    return entries;
+}
+
+bool OperationLog::clear()
+{
+    stream.close();
+
+    if (remove(logFile.c_str()) != 0)
+    {
+        ifstream existing(logFile);
+        if (existing.is_open())
+        {
+            cerr << "Error: Could not clear log " << logFile << endl;
+            return false;
+        }
+    }
+
+    entryCount = 0;
+    checkpointEnd = 0;
+    return true;
+}
+
+bool OperationLog::sync()
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(logFile.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return GetLastError() == ERROR_FILE_NOT_FOUND;
+    }
+    bool ok = FlushFileBuffers(file);
+    CloseHandle(file);
+#else
+    int file = ::open(logFile.c_str(), O_WRONLY);
+    if (file < 0)
+    {
+        return errno == ENOENT;
+    }
+    bool ok = fsync(file) == 0;
+    ::close(file);
+#endif
+    if (!ok)
+    {
+        cerr << "Error: Could not sync log " << logFile << endl;
+    }
+    return ok;
+}
+
+bool OperationLog::checkpoint(const string &contents)
+{
+    if (!append('C', to_string(SnapshotFormat::checksum(contents))))
+    {
+        return false;
+    }
+    checkpointEnd = entryCount;
+    return true;
+}
+
+bool OperationLog::trimToCheckpoint()
+{
+    vector<LogEntry> entries = readEntries();
+    if (checkpointEnd >= entries.size())
+    {
+        return clear();
+    }
+
+    stream.close();
+    string kept;
+    for (size_t i = checkpointEnd; i < entries.size(); ++i)
+    {
+        kept += entries[i].operation;
+        kept += '\t' + entries[i].id + '\t' + entries[i].record + '\n';
+    }
+    if (!DataSaver::writeFileAtomically(logFile, kept))
+    {
+        return false;
+    }
+    entryCount = entries.size() - checkpointEnd;
+    checkpointEnd = 0;
+    return true;
+}
+
+size_t OperationLog::firstUnfolded(const vector<LogEntry> &entries, const string &baseFile) const
+{
+    size_t last = entries.size();
+    while (last > 0 && entries[last - 1].operation != 'C')
+    {
+        last--;
+    }
+    if (last == 0)
+    {
+        return 0;
+    }
+
+    ifstream file(baseFile, ios::binary);
+    stringstream contents;
+    contents << file.rdbuf();
+    string checksum = to_string(SnapshotFormat::checksum(contents.str()));
+
+    // The latest checkpoint the base file matches; any one that matches
+    // names the same data, so later ones only skip more.
+    for (size_t i = last; i > 0; --i)
+    {
+        if (entries[i - 1].operation == 'C' && entries[i - 1].id == checksum)
+        {
+            return i;
+        }
+    }
+    return 0;
+}
+
+size_t OperationLog::size() const
+{
+    return entryCount;
+}
+
+const string &OperationLog::getFilename() const
+{
+    return logFile;
+}
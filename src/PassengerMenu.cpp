@@ -27,7 +27,7 @@ static bool validateNotEmpty(const string &str, const string &fieldName)
     return true;
 }
 
-PassengerMenu::PassengerMenu(RouteManager &rm) : routeManager(rm) {}
+PassengerMenu::PassengerMenu(RouteManager &rm, ScheduleManager &sm) : routeManager(rm), scheduleManager(sm) {}
 
 void PassengerMenu::clearInputBuffer()
 {
@@ -72,7 +72,9 @@ void PassengerMenu::displayMenu() const
     cout << "3. Search Routes by Destination" << endl;
     cout << "4. Search Routes by Stop" << endl;
     cout << "5. View Estimated Travel Time" << endl;
-    cout << "6. Back to Main Menu" << endl;
+    cout << "6. Plan a Journey" << endl;
+    cout << "7. View Next Departures from a Stop" << endl;
+    cout << "8. Back to Main Menu" << endl;
     cout << "========================================" << endl;
 }
 
@@ -109,6 +111,12 @@ void PassengerMenu::show()
             viewTravelTime();
             break;
         case 6:
+            planJourney();
+            break;
+        case 7:
+            viewNextDepartures();
+            break;
+        case 8:
 
             cout << "\nReturning to main menu..." << endl;
             running = false;
@@ -139,7 +147,7 @@ void PassengerMenu::searchByOrigin()
     }
 
     cout << "\nSearching for routes starting from: " << origin << endl;
-    vector<Route> foundRoutes = routeManager.findRoutesByOrigin(origin);
+    vector<const Route *> foundRoutes = routeManager.findRoutesByOrigin(origin);
     if (foundRoutes.empty())
     {
         cout << "No routes found starting from " << origin << "." << endl;
@@ -163,7 +171,7 @@ void PassengerMenu::searchByDestination()
     }
 
     cout << "\nSearching for routes ending at: " << destination << endl;
-    vector<Route> foundRoutes = routeManager.findRoutesByDestination(destination);
+    vector<const Route *> foundRoutes = routeManager.findRoutesByDestination(destination);
     if (foundRoutes.empty())
     {
         cout << "No routes found ending at " << destination << "." << endl;
@@ -187,7 +195,7 @@ void PassengerMenu::searchByStop()
     }
 
     cout << "\nSearching for routes passing through: " << stop << endl;
-    vector<Route> foundRoutes = routeManager.findRoutesByStop(stop);
+    vector<const Route *> foundRoutes = routeManager.findRoutesByStop(stop);
     if (foundRoutes.empty())
     {
         cout << "No routes found passing through " << stop << "." << endl;
@@ -202,23 +210,110 @@ void PassengerMenu::viewTravelTime()
 
     cout << "\n--- View Estimated Travel Time ---" << endl;
 
-    clearInputBuffer();
-    string routeId = trim(getInput("Enter Route ID: "));
+    string from = trim(getInput("Enter origin stop: "));
+    if (!validateNotEmpty(from, "Origin stop"))
+    {
+        return;
+    }
 
-    if (!validateNotEmpty(routeId, "Route ID"))
+    string to = trim(getInput("Enter destination stop: "));
+    if (!validateNotEmpty(to, "Destination stop"))
     {
         return;
     }
 
-    Route *route = routeManager.findRoute(routeId);
-    if (route)
+    int minutes = routeManager.getTravelTime(from, to);
+    if (minutes == TravelTimeMatrix::UNREACHABLE)
     {
-        cout << "\n";
-        DisplayManager::displayRoute(*route);
-        cout << "\nEstimated Travel Time: " << route->getEstimatedTravelTime() << " minutes" << endl;
+        cout << "No route connects " << from << " to " << to << "." << endl;
+        return;
     }
-    else
+    cout << "\nEstimated Travel Time from " << from << " to " << to << ": " << minutes << " minutes" << endl;
+}
+
+void PassengerMenu::planJourney()
+{
+
+    cout << "\n--- Plan a Journey ---" << endl;
+
+    string from = trim(getInput("Enter starting stop: "));
+    if (!validateNotEmpty(from, "Starting stop"))
     {
-        cout << "Route not found." << endl;
+        return;
+    }
+
+    string to = trim(getInput("Enter destination stop: "));
+    if (!validateNotEmpty(to, "Destination stop"))
+    {
+        return;
+    }
+
+    string date = trim(getInput("Enter travel date (YYYY-MM-DD): "));
+    int32_t day = Schedule::parseDate(date);
+    if (day == Schedule::INVALID_DAY)
+    {
+        cout << "Error: Invalid date format. Use YYYY-MM-DD." << endl;
+        return;
+    }
+
+    string time = trim(getInput("Enter earliest departure time (HH:MM): "));
+    int16_t minute = Schedule::parseTime(time);
+    if (minute == Schedule::INVALID_TIME)
+    {
+        cout << "Error: Invalid time format. Use HH:MM." << endl;
+        return;
+    }
+
+    planner.refresh(routeManager, scheduleManager);
+    vector<JourneyPlanner::Itinerary> itineraries = planner.plan(from, to, day, minute);
+    if (itineraries.empty())
+    {
+        cout << "No journey found from " << from << " to " << to << " after " << date << " " << time << "." << endl;
+        return;
+    }
+    DisplayManager::displayItineraries(itineraries);
+}
+
+void PassengerMenu::viewNextDepartures()
+{
+
+    cout << "\n--- Next Departures ---" << endl;
+
+    string stop = trim(getInput("Enter stop: "));
+    if (!validateNotEmpty(stop, "Stop"))
+    {
+        return;
+    }
+
+    string date = trim(getInput("Enter date (YYYY-MM-DD): "));
+    int32_t day = Schedule::parseDate(date);
+    if (day == Schedule::INVALID_DAY)
+    {
+        cout << "Error: Invalid date format. Use YYYY-MM-DD." << endl;
+        return;
+    }
+
+    string time = trim(getInput("Enter time (HH:MM): "));
+    int16_t minute = Schedule::parseTime(time);
+    if (minute == Schedule::INVALID_TIME)
+    {
+        cout << "Error: Invalid time format. Use HH:MM." << endl;
+        return;
+    }
+
+    int count = getIntInput("Number of departures to show: ");
+    if (count <= 0)
+    {
+        cout << "Error: Number of departures must be positive." << endl;
+        return;
+    }
+
+    vector<DepartureBoard::Departure> upcoming =
+        scheduleManager.getNextDepartures(stop, day, minute, static_cast<size_t>(count));
+    if (upcoming.empty())
+    {
+        cout << "No departures from " << stop << " after " << date << " " << time << "." << endl;
+        return;
     }
+    scheduleManager.displayDepartures(stop, upcoming);
 }
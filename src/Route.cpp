@@ -4,29 +4,46 @@
 
 using namespace std;
 
-Route::Route() : id(""), origin(""), destination(""), estimatedTravelTime(0) {}
-Route::Route(const string &id, const string &origin,
-             const string &destination, const vector<string> &keyStops,
+Route::Route()
+    : id(), origin(LoadArena::current()), destination(LoadArena::current()),
+      keyStops(LoadArena::current()), estimatedTravelTime(0) {}
+Route::Route(const string &id, string_view origin,
+             string_view destination, const vector<string> &keyStops,
              int estimatedTravelTime)
-    : id(id), origin(origin), destination(destination),
-      keyStops(keyStops), estimatedTravelTime(estimatedTravelTime) {}
+    : id(id), origin(origin, LoadArena::current()), destination(destination, LoadArena::current()),
+      keyStops(LoadArena::current()),
+      estimatedTravelTime(estimatedTravelTime)
+{
+    setKeyStops(keyStops);
+}
 
-string Route::getId() const
+const EntityId &Route::getId() const
 {
     return id;
 }
 
-string Route::getOrigin() const
+string_view Route::getOrigin() const
 {
     return origin;
 }
 
-string Route::getDestination() const
+string_view Route::getDestination() const
 {
     return destination;
 }
 
 vector<string> Route::getKeyStops() const
+{
+    vector<string> names;
+    names.reserve(keyStops.size());
+    for (Symbol stop : keyStops)
+    {
+        names.push_back(SymbolTable::name(stop));
+    }
+    return names;
+}
+
+const pmr::vector<Symbol> &Route::getKeyStopSymbols() const
 {
     return keyStops;
 }
@@ -38,7 +55,7 @@ int Route::getEstimatedTravelTime() const
 
 void Route::setId(const string &id)
 {
-    this->id = id;
+    this->id = EntityId(id);
 }
 
 void Route::setOrigin(const string &origin)
@@ -53,7 +70,12 @@ void Route::setDestination(const string &destination)
 
 void Route::setKeyStops(const vector<string> &keyStops)
 {
-    this->keyStops = keyStops;
+    this->keyStops.clear();
+    this->keyStops.reserve(keyStops.size());
+    for (const auto &stop : keyStops)
+    {
+        this->keyStops.push_back(SymbolTable::intern(stop));
+    }
 }
 
 void Route::setEstimatedTravelTime(int estimatedTravelTime)
@@ -63,7 +85,7 @@ void Route::setEstimatedTravelTime(int estimatedTravelTime)
 
 void Route::addStop(const string &stop)
 {
-    keyStops.push_back(stop);
+    keyStops.push_back(SymbolTable::intern(stop));
 }
 
 void Route::display() const
@@ -82,7 +104,7 @@ string Route::getStopsAsString() const
     stringstream ss;
     for (size_t i = 0; i < keyStops.size(); ++i)
     {
-        ss << keyStops[i];
+        ss << SymbolTable::name(keyStops[i]);
         if (i < keyStops.size() - 1)
         {
             ss << "|";
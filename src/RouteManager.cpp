@@ -1,4 +1,5 @@
 ﻿#include "../include/RouteManager.h"
+#include "../include/DataLoader.h"
 #include "../include/DataSaver.h"
 #include "../include/DisplayManager.h"
 #include <iostream>
@@ -7,7 +8,69 @@
 using namespace std;
 
 RouteManager::RouteManager(vector<Route> &routeList, const string &filename)
-    : routes(routeList), dataFile(filename) {}
+    : routes(routeList), dataFile(filename),
+      log(filename + ".log"), compactionThreshold(OperationLog::DEFAULT_COMPACTION_THRESHOLD),
+      flusher(nullptr), flushHandle(0), slots(routes), revision(0)
+{
+    size_t replayed = log.replay(routes, DataLoader::parseRouteRecord, dataFile);
+    if (replayed > 0)
+    {
+        cout << "Replayed " << replayed << " logged route changes from " << log.getFilename() << endl;
+        slots.rebuild();
+    }
+
+    index.rebuild(routes, slots);
+    for (const auto &route : routes)
+    {
+        indexRoute(route);
+    }
+}
+
+static void addToIndex(unordered_map<string, vector<EntityId>> &lookup, string_view key, const EntityId &routeId)
+{
+    vector<EntityId> &ids = lookup[string(key)];
+    if (find(ids.begin(), ids.end(), routeId) == ids.end())
+    {
+        ids.push_back(routeId);
+    }
+}
+
+static void removeFromIndex(unordered_map<string, vector<EntityId>> &lookup, string_view key,
+                            const EntityId &routeId)
+{
+    auto found = lookup.find(string(key));
+    if (found == lookup.end())
+    {
+        return;
+    }
+
+    vector<EntityId> &ids = found->second;
+    ids.erase(remove(ids.begin(), ids.end(), routeId), ids.end());
+    if (ids.empty())
+    {
+        lookup.erase(found);
+    }
+}
+
+void RouteManager::indexRoute(const Route &route)
+{
+    addToIndex(routesByOrigin, route.getOrigin(), route.getId());
+    addToIndex(routesByDestination, route.getDestination(), route.getId());
+    for (Symbol stop : route.getKeyStopSymbols())
+    {
+        addToIndex(routesByStop, SymbolTable::name(stop), route.getId());
+    }
+}
+
+void RouteManager::unindexRoute(const Route &route)
+{
+    removeFromIndex(routesByOrigin, route.getOrigin(), route.getId());
+    removeFromIndex(routesByDestination, route.getDestination(), route.getId());
+    for (Symbol stop : route.getKeyStopSymbols())
+    {
+        removeFromIndex(routesByStop, SymbolTable::name(stop), route.getId());
+    }
+}
 
 bool RouteManager::validateRoute(const Route &route) const
 {
@@ -17,6 +80,12 @@ bool RouteManager::validateRoute(const Route &route) const
         return false;
     }
 
+    if (!route.getId().isValid())
+    {
+        cout << "Error: Route ID must be at most " << EntityId::CAPACITY << " characters." << endl;
+        return false;
+    }
+
     if (route.getOrigin().empty() || route.getDestination().empty())
     {
         cout << "Error: Origin and destination must be provided." << endl;
@@ -38,27 +107,37 @@ bool RouteManager::validateRoute(const Route &route) const
     return true;
 }
 
-bool RouteManager::routeExists(const string &routeId) const
+const vector<Route> &RouteManager::getRoutes() const
 {
-    return any_of(routes.begin(), routes.end(),
-                  [&routeId](const Route &r)
-                  { return r.getId() == routeId; });
+    return routes;
 }
 
-Route *RouteManager::findRoute(const string &routeId)
+size_t RouteManager::getRevision() const
 {
-    auto it = find_if(routes.begin(), routes.end(),
-                      [&routeId](const Route &r)
-                      { return r.getId() == routeId; });
+    return revision;
+}
 
-    if (it != routes.end())
-    {
-        return &(*it);
-    }
-    return nullptr;
+bool RouteManager::routeExists(const EntityId &routeId) const
+{
+    return index.contains(routeId);
 }
 
-bool RouteManager::addRoute(const Route &newRoute)
+Route *RouteManager::findRoute(const EntityId &routeId)
+{
+    return slots.get(index.find(routeId));
+}
+
+RouteManager::Handle RouteManager::findRouteHandle(const EntityId &routeId) const
+{
+    return index.find(routeId);
+}
+
+Route *RouteManager::getRoute(Handle handle)
+{
+    return slots.get(handle);
+}
+
+bool RouteManager::checkAdd(const Route &newRoute) const
 {
     if (!validateRoute(newRoute))
     {
@@ -70,49 +149,138 @@ bool RouteManager::addRoute(const Route &newRoute)
         cout << "Error: Route with ID " << newRoute.getId() << " already exists." << endl;
         return false;
     }
+    return true;
+}
 
-    routes.push_back(newRoute);
-    cout << "Route " << newRoute.getId() << " added successfully." << endl;
+bool RouteManager::checkUpdate(const EntityId &routeId, const Route &updatedRoute) const
+{
+    if (!routeExists(routeId))
+    {
+        cout << "Error: Route with ID " << routeId << " not found." << endl;
+        return false;
+    }
+
+    if (!validateRoute(updatedRoute))
+    {
+        return false;
+    }
 
-    return saveToFile();
+    if (updatedRoute.getId() != routeId && routeExists(updatedRoute.getId()))
+    {
+        cout << "Error: Route with ID " << updatedRoute.getId() << " already exists." << endl;
+        return false;
+    }
+    return true;
 }
 
-bool RouteManager::updateRoute(const string &routeId, const Route &updatedRoute)
+bool RouteManager::checkRemove(const EntityId &routeId) const
 {
-    Route *route = findRoute(routeId);
-    if (!route)
+    if (!routeExists(routeId))
     {
         cout << "Error: Route with ID " << routeId << " not found." << endl;
         return false;
     }
+    return true;
+}
 
-    if (!validateRoute(updatedRoute))
+void RouteManager::applyAdd(const Route &newRoute)
+{
+    revision++;
+    index.insert(newRoute.getId(), slots.insert(newRoute));
+    indexRoute(newRoute);
+    travelTimes.recordChange(nullptr, &newRoute);
+}
+
+void RouteManager::applyUpdate(const EntityId &routeId, const Route &updatedRoute)
+{
+    revision++;
+    Route *route = findRoute(routeId);
+    unindexRoute(*route);
+    travelTimes.recordChange(route, &updatedRoute);
+    LoadArena::replace(*route, updatedRoute);
+    index.rename(routeId, updatedRoute.getId());
+    indexRoute(updatedRoute);
+}
+
+void RouteManager::applyRemove(const EntityId &routeId)
+{
+    revision++;
+    const Route *route = findRoute(routeId);
+    unindexRoute(*route);
+    travelTimes.recordChange(route, nullptr);
+    index.erase(routeId, routes, slots);
+}
+
+bool RouteManager::addRoute(const Route &newRoute)
+{
+    FlushScheduler::Guard guard(flusher);
+
+    if (!checkAdd(newRoute))
+    {
+        return false;
+    }
+
+    applyAdd(newRoute);
+    cout << "Route " << newRoute.getId() << " added successfully." << endl;
+
+    return persist('A', newRoute.getId(), &newRoute);
+}
+
+bool RouteManager::updateRoute(const EntityId &routeId, const Route &updatedRoute)
+{
+    FlushScheduler::Guard guard(flusher);
+
+    if (!checkUpdate(routeId, updatedRoute))
     {
         return false;
     }
 
-    *route = updatedRoute;
+    applyUpdate(routeId, updatedRoute);
     cout << "Route " << routeId << " updated successfully." << endl;
 
-    return saveToFile();
+    return persist('U', routeId, &updatedRoute);
+}
+
+bool RouteManager::updateRoute(Handle handle, const Route &updatedRoute)
+{
+    const Route *route = slots.get(handle);
+    if (!route)
+    {
+        cout << "Error: Route no longer exists." << endl;
+        return false;
+    }
+    // Copied: the update overwrites the stored ID.
+    EntityId routeId = route->getId();
+    return updateRoute(routeId, updatedRoute);
 }
 
-bool RouteManager::removeRoute(const string &routeId)
+bool RouteManager::removeRoute(const EntityId &routeId)
 {
-    auto it = find_if(routes.begin(), routes.end(),
-                      [&routeId](const Route &r)
-                      { return r.getId() == routeId; });
+    FlushScheduler::Guard guard(flusher);
 
-    if (it == routes.end())
+    if (!checkRemove(routeId))
     {
-        cout << "Error: Route with ID " << routeId << " not found." << endl;
         return false;
     }
 
-    routes.erase(it);
+    applyRemove(routeId);
     cout << "Route " << routeId << " removed successfully." << endl;
 
-    return saveToFile();
+    return persist('R', routeId);
+}
+
+int RouteManager::getTravelTime(const string &fromStop, const string &toStop)
+{
+    FlushScheduler::Guard guard(flusher);
+
+    if (!travelTimes.isBuilt() && !travelTimes.load(dataFile + ".times", routes))
+    {
+        travelTimes.build(routes);
+        travelTimes.save(dataFile + ".times", routes);
+    }
+    // Route changes since the last query are applied together, here.
+    travelTimes.refresh(routes);
+    return travelTimes.travelTime(fromStop, toStop);
 }
 
 bool RouteManager::saveToFile()
@@ -120,47 +288,153 @@ bool RouteManager::saveToFile()
     return DataSaver::saveRoutes(dataFile, routes);
 }
 
-void RouteManager::displayAllRoutes() const
+bool RouteManager::persist(char operation, const EntityId &routeId, const Route *route)
 {
-    DisplayManager::displayRoutes(routes);
+    if (!log.append(operation, routeId.view(), route ? DataSaver::formatRoute(*route) : ""))
+    {
+        return false;
+    }
+
+    if (flusher)
+    {
+        flusher->markDirty(flushHandle);
+        return true;
+    }
+
+    if (log.size() >= compactionThreshold)
+    {
+        return compact();
+    }
+    return true;
 }
 
-vector<Route> RouteManager::findRoutesByOrigin(const string &origin) const
+bool RouteManager::persistBatch(const vector<LogEntry> &entries)
 {
-    vector<Route> foundRoutes;
-    for (const auto &route : routes)
+    if (!log.appendAll(entries))
     {
-        if (route.getOrigin() == origin)
-        {
-            foundRoutes.push_back(route);
-        }
+        return false;
     }
-    return foundRoutes;
+
+    if (flusher)
+    {
+        flusher->markDirty(flushHandle);
+        return true;
+    }
+
+    if (log.size() >= compactionThreshold)
+    {
+        return compact();
+    }
+    return true;
 }
 
-vector<Route> RouteManager::findRoutesByDestination(const string &destination) const
+bool RouteManager::compact()
 {
-    vector<Route> foundRoutes;
-    for (const auto &route : routes)
+    lock_guard<mutex> compacting(compactMutex);
+
+    string contents;
+    string timesContents;
+    size_t count;
     {
-        if (route.getDestination() == destination)
+        FlushScheduler::Guard guard(flusher);
+        contents = DataSaver::formatRoutes(routes);
+        count = routes.size();
+        if (travelTimes.isBuilt() && !travelTimes.isStale())
         {
-            foundRoutes.push_back(route);
+            timesContents = travelTimes.encode(routes);
+        }
+        if (!log.checkpoint(contents))
+        {
+            return false;
         }
     }
-    return foundRoutes;
+
+    if (!log.sync() || !DataSaver::saveFormatted(dataFile, contents, count, "routes"))
+    {
+        return false;
+    }
+    // Only a cache: a missing or outdated file is rebuilt on the next query.
+    if (!timesContents.empty())
+    {
+        DataSaver::writeFileAtomically(dataFile + ".times", timesContents);
+    }
+
+    FlushScheduler::Guard guard(flusher);
+    return log.trimToCheckpoint();
 }
 
-vector<Route> RouteManager::findRoutesByStop(const string &stop) const
+bool RouteManager::commitLog()
 {
-    vector<Route> foundRoutes;
-    for (const auto &route : routes)
+    bool due;
+    {
+        FlushScheduler::Guard guard(flusher);
+        due = log.size() >= compactionThreshold;
+    }
+    return log.sync() && (!due || compact());
+}
+
+void RouteManager::setCompactionThreshold(size_t entries)
+{
+    compactionThreshold = max<size_t>(1, entries);
+}
+
+void RouteManager::attachFlusher(FlushScheduler &scheduler)
+{
+    flusher = &scheduler;
+    flushHandle = scheduler.registerFile(dataFile, [this]()
+                                         { return commitLog(); });
+    if (log.size() > 0)
+    {
+        scheduler.markDirty(flushHandle);
+    }
+}
+
+void RouteManager::displayAllRoutes() const
+{
+    DisplayManager::displayRoutes(routes);
+}
+
+vector<const Route *> RouteManager::resolveRoutes(const unordered_map<string, vector<EntityId>> &lookup,
+                                                 const string &key) const
+{
+    vector<const Route *> foundRoutes;
+    auto found = lookup.find(key);
+    if (found == lookup.end())
     {
-        const auto &stops = route.getKeyStops();
-        if (find(stops.begin(), stops.end(), stop) != stops.end())
+        return foundRoutes;
+    }
+
+    vector<uint32_t> positions;
+    positions.reserve(found->second.size());
+    for (const auto &routeId : found->second)
+    {
+        uint32_t position = slots.indexOf(index.find(routeId));
+        if (position != SlotMap<Route>::npos)
         {
-            foundRoutes.push_back(route);
+            positions.push_back(position);
         }
     }
+    sort(positions.begin(), positions.end());
+
+    foundRoutes.reserve(positions.size());
+    for (uint32_t position : positions)
+    {
+        foundRoutes.push_back(&routes[position]);
+    }
     return foundRoutes;
 }
+
+vector<const Route *> RouteManager::findRoutesByOrigin(const string &origin) const
+{
+    return resolveRoutes(routesByOrigin, origin);
+}
+
+vector<const Route *> RouteManager::findRoutesByDestination(const string &destination) const
+{
+    return resolveRoutes(routesByDestination, destination);
+}
+
+vector<const Route *> RouteManager::findRoutesByStop(const string &stop) const
+{
+    return resolveRoutes(routesByStop, stop);
+}
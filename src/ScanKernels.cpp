@@ -0,0 +1,325 @@
+﻿#include "../include/ScanKernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCAN_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// With intersect set, the equality test is ANDed into bits and zero words
+// are skipped; otherwise bits is overwritten.
+static void matchEqualScalar(const uint32_t *values, size_t count, uint32_t value, uint64_t *bits,
+                             bool intersect)
+{
+    for (size_t base = 0; base < count; base += 64)
+    {
+        uint64_t &bitsWord = bits[base / 64];
+        if (intersect && bitsWord == 0)
+        {
+            continue;
+        }
+        size_t end = base + 64 < count ? base + 64 : count;
+        uint64_t word = 0;
+        for (size_t i = base; i < end; ++i)
+        {
+            word |= static_cast<uint64_t>(values[i] == value) << (i - base);
+        }
+        bitsWord = intersect ? bitsWord & word : word;
+    }
+}
+
+static void keepRangeScalar(const int16_t *values, size_t count, int16_t low, int16_t high, uint64_t *bits)
+{
+    for (size_t base = 0; base < count; base += 64)
+    {
+        uint64_t &word = bits[base / 64];
+        if (word == 0)
+        {
+            continue;
+        }
+        size_t end = base + 64 < count ? base + 64 : count;
+        uint64_t keep = 0;
+        for (size_t i = base; i < end; ++i)
+        {
+            keep |= static_cast<uint64_t>(values[i] >= low && values[i] <= high) << (i - base);
+        }
+        word &= keep;
+    }
+}
+
+#ifdef SCAN_KERNELS_X86
+// Full 64-row words go through the vector loop; the tail is left to the
+// scalar kernel, which starts on a word boundary.
+__attribute__((target("sse2"))) static void matchEqualSse2(const uint32_t *values, size_t count,
+                                                           uint32_t value, uint64_t *bits, bool intersect)
+{
+    const __m128i needle = _mm_set1_epi32(static_cast<int>(value));
+    size_t base = 0;
+    for (; base + 64 <= count; base += 64)
+    {
+        uint64_t &bitsWord = bits[base / 64];
+        if (intersect && bitsWord == 0)
+        {
+            continue;
+        }
+        uint64_t word = 0;
+        for (int k = 0; k < 16; ++k)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + base + k * 4));
+            __m128i equal = _mm_cmpeq_epi32(block, needle);
+            word |= static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(equal))) << (k * 4);
+        }
+        bitsWord = intersect ? bitsWord & word : word;
+    }
+    matchEqualScalar(values + base, count - base, value, bits + base / 64, intersect);
+}
+
+__attribute__((target("sse2"))) static void keepRangeSse2(const int16_t *values, size_t count,
+                                                          int16_t low, int16_t high, uint64_t *bits)
+{
+    const __m128i lower = _mm_set1_epi16(low);
+    const __m128i upper = _mm_set1_epi16(high);
+    size_t base = 0;
+    for (; base + 64 <= count; base += 64)
+    {
+        uint64_t &word = bits[base / 64];
+        if (word == 0)
+        {
+            continue;
+        }
+        uint64_t outside = 0;
+        for (int k = 0; k < 4; ++k)
+        {
+            const int16_t *block = values + base + k * 16;
+            __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+            __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 8));
+            __m128i firstOut = _mm_or_si128(_mm_cmplt_epi16(first, lower), _mm_cmpgt_epi16(first, upper));
+            __m128i secondOut = _mm_or_si128(_mm_cmplt_epi16(second, lower), _mm_cmpgt_epi16(second, upper));
+            // Saturating pack keeps 0 and -1, one byte per row.
+            __m128i packed = _mm_packs_epi16(firstOut, secondOut);
+            outside |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(packed))) << (k * 16);
+        }
+        word &= ~outside;
+    }
+    keepRangeScalar(values + base, count - base, low, high, bits + base / 64);
+}
+
+__attribute__((target("avx2"))) static void matchEqualAvx2(const uint32_t *values, size_t count,
+                                                           uint32_t value, uint64_t *bits, bool intersect)
+{
+    const __m256i needle = _mm256_set1_epi32(static_cast<int>(value));
+    size_t base = 0;
+    for (; base + 64 <= count; base += 64)
+    {
+        uint64_t &bitsWord = bits[base / 64];
+        if (intersect && bitsWord == 0)
+        {
+            continue;
+        }
+        uint64_t word = 0;
+        for (int k = 0; k < 8; ++k)
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + base + k * 8));
+            __m256i equal = _mm256_cmpeq_epi32(block, needle);
+            word |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(equal))) << (k * 8);
+        }
+        bitsWord = intersect ? bitsWord & word : word;
+    }
+    matchEqualScalar(values + base, count - base, value, bits + base / 64, intersect);
+}
+
+__attribute__((target("avx2"))) static void keepRangeAvx2(const int16_t *values, size_t count,
+                                                          int16_t low, int16_t high, uint64_t *bits)
+{
+    const __m256i lower = _mm256_set1_epi16(low);
+    const __m256i upper = _mm256_set1_epi16(high);
+    size_t base = 0;
+    for (; base + 64 <= count; base += 64)
+    {
+        uint64_t &word = bits[base / 64];
+        if (word == 0)
+        {
+            continue;
+        }
+        uint64_t outside = 0;
+        for (int k = 0; k < 2; ++k)
+        {
+            const int16_t *block = values + base + k * 32;
+            __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+            __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 16));
+            __m256i firstOut = _mm256_or_si256(_mm256_cmpgt_epi16(lower, first), _mm256_cmpgt_epi16(first, upper));
+            __m256i secondOut = _mm256_or_si256(_mm256_cmpgt_epi16(lower, second), _mm256_cmpgt_epi16(second, upper));
+            // The pack works per 128-bit lane; the permute restores row order.
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(firstOut, secondOut), 0xD8);
+            outside |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(packed))) << (k * 32);
+        }
+        word &= ~outside;
+    }
+    keepRangeScalar(values + base, count - base, low, high, bits + base / 64);
+}
+#endif
+
+static ScanKernels::Level detectLevel()
+{
+#ifdef SCAN_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return ScanKernels::Level::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return ScanKernels::Level::SSE2;
+    }
+#endif
+    return ScanKernels::Level::SCALAR;
+}
+
+static ScanKernels::Level &currentLevel()
+{
+    static ScanKernels::Level level = ScanKernels::supportedLevel();
+    return level;
+}
+
+ScanKernels::Level ScanKernels::supportedLevel()
+{
+    static const Level supported = detectLevel();
+    return supported;
+}
+
+ScanKernels::Level ScanKernels::getLevel()
+{
+    return currentLevel();
+}
+
+void ScanKernels::setLevel(Level level)
+{
+    currentLevel() = level < supportedLevel() ? level : supportedLevel();
+}
+
+const char *ScanKernels::levelName(Level level)
+{
+    switch (level)
+    {
+    case Level::AVX2:
+        return "AVX2";
+    case Level::SSE2:
+        return "SSE2";
+    default:
+        return "scalar";
+    }
+}
+
+size_t ScanKernels::wordCount(size_t rows)
+{
+    return (rows + 63) / 64;
+}
+
+static void matchEqual(const uint32_t *values, size_t count, uint32_t value, uint64_t *bits, bool intersect)
+{
+#ifdef SCAN_KERNELS_X86
+    switch (ScanKernels::getLevel())
+    {
+    case ScanKernels::Level::AVX2:
+        matchEqualAvx2(values, count, value, bits, intersect);
+        return;
+    case ScanKernels::Level::SSE2:
+        matchEqualSse2(values, count, value, bits, intersect);
+        return;
+    default:
+        break;
+    }
+#endif
+    matchEqualScalar(values, count, value, bits, intersect);
+}
+
+void ScanKernels::selectEqual(const uint32_t *values, size_t count, uint32_t value, uint64_t *bits)
+{
+    matchEqual(values, count, value, bits, false);
+}
+
+void ScanKernels::keepEqual(const uint32_t *values, size_t count, uint32_t value, uint64_t *bits)
+{
+    matchEqual(values, count, value, bits, true);
+}
+
+void ScanKernels::keepRange(const int16_t *values, size_t count, int16_t low, int16_t high, uint64_t *bits)
+{
+#ifdef SCAN_KERNELS_X86
+    switch (getLevel())
+    {
+    case Level::AVX2:
+        keepRangeAvx2(values, count, low, high, bits);
+        return;
+    case Level::SSE2:
+        keepRangeSse2(values, count, low, high, bits);
+        return;
+    default:
+        break;
+    }
+#endif
+    keepRangeScalar(values, count, low, high, bits);
+}
+
+static int lowestBit(uint64_t word)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while (!(word & 1))
+    {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+static size_t bitCount(uint64_t word)
+{
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_popcountll(word));
+#else
+    size_t count = 0;
+    for (; word; word &= word - 1)
+    {
+        count++;
+    }
+    return count;
+#endif
+}
+
+void ScanKernels::selectAll(size_t count, uint64_t *bits)
+{
+    for (size_t w = 0; w < wordCount(count); ++w)
+    {
+        size_t remaining = count - w * 64;
+        bits[w] = remaining >= 64 ? ~0ULL : (1ULL << remaining) - 1;
+    }
+}
+
+size_t ScanKernels::countSelected(const vector<uint64_t> &bits)
+{
+    size_t count = 0;
+    for (uint64_t word : bits)
+    {
+        count += bitCount(word);
+    }
+    return count;
+}
+
+vector<uint32_t> ScanKernels::selectedRows(const vector<uint64_t> &bits)
+{
+    vector<uint32_t> rows;
+    rows.reserve(countSelected(bits));
+    for (size_t w = 0; w < bits.size(); ++w)
+    {
+        for (uint64_t word = bits[w]; word; word &= word - 1)
+        {
+            rows.push_back(static_cast<uint32_t>(w * 64 + lowestBit(word)));
+        }
+    }
+    return rows;
+}
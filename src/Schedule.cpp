@@ -1,109 +1,260 @@
 ﻿#include "../include/Schedule.h"
+#include <cstdio>
 #include <iomanip>
 
 using namespace std;
 
+// Days since 1970-01-01 for a proleptic Gregorian date.
+static int32_t daysFromCivil(int year, unsigned month, unsigned dayOfMonth)
+{
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + dayOfMonth - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int32_t>(dayOfEra) - 719468;
+}
+
+static void civilFromDays(int32_t days, int &year, unsigned &month, unsigned &dayOfMonth)
+{
+    days += 719468;
+    const int era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);
+    const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const unsigned shiftedMonth = (5 * dayOfYear + 2) / 153;
+
+    dayOfMonth = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    year = static_cast<int>(yearOfEra) + era * 400 + (month <= 2);
+}
+
+static bool parseDigits(string_view text, int &value)
+{
+    if (text.empty())
+    {
+        return false;
+    }
+
+    value = 0;
+    for (char c : text)
+    {
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+int32_t Schedule::parseDate(string_view text)
+{
+    static const unsigned daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    int year, month, dayOfMonth;
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-' ||
+        !parseDigits(text.substr(0, 4), year) || !parseDigits(text.substr(5, 2), month) ||
+        !parseDigits(text.substr(8, 2), dayOfMonth) || month < 1 || month > 12)
+    {
+        return INVALID_DAY;
+    }
+
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    int monthLength = daysInMonth[month - 1] + (month == 2 && leap ? 1 : 0);
+    if (dayOfMonth < 1 || dayOfMonth > monthLength)
+    {
+        return INVALID_DAY;
+    }
+
+    return daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(dayOfMonth));
+}
+
+int16_t Schedule::parseTime(string_view text)
+{
+    size_t colon = text.find(':');
+    int hours, minutes;
+    if (colon == string_view::npos || colon == 0 || colon > 2 || text.size() != colon + 3 ||
+        !parseDigits(text.substr(0, colon), hours) || !parseDigits(text.substr(colon + 1), minutes) ||
+        hours > 23 || minutes > 59)
+    {
+        return INVALID_TIME;
+    }
+    return static_cast<int16_t>(hours * 60 + minutes);
+}
+
+string Schedule::formatDate(int32_t day)
+{
+    if (day == INVALID_DAY)
+    {
+        return "";
+    }
+
+    int year;
+    unsigned month, dayOfMonth;
+    civilFromDays(day, year, month, dayOfMonth);
+
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%04d-%02u-%02u", year, month, dayOfMonth);
+    return buffer;
+}
+
+string Schedule::formatTime(int16_t minutes)
+{
+    if (minutes == INVALID_TIME)
+    {
+        return "";
+    }
+
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%02d:%02d", minutes / 60, minutes % 60);
+    return buffer;
+}
+
 Schedule::Schedule()
-    : id(""), routeId(""), busId(""), driverId(""),
-      date(""), departureTime(""), arrivalTime("") {}
+    : id(), routeId(SymbolTable::EMPTY), busId(SymbolTable::EMPTY), driverId(SymbolTable::EMPTY),
+      day(INVALID_DAY), departure(INVALID_TIME), arrival(INVALID_TIME) {}
 
 Schedule::Schedule(const string &id, const string &routeId,
                    const string &busId, const string &driverId,
                    const string &date, const string &departureTime,
                    const string &arrivalTime)
+    : id(id), routeId(SymbolTable::intern(routeId)), busId(SymbolTable::intern(busId)),
+      driverId(SymbolTable::intern(driverId)),
+      day(parseDate(date)), departure(parseTime(departureTime)), arrival(parseTime(arrivalTime)) {}
+
+Schedule::Schedule(const string &id, const string &routeId,
+                   const string &busId, const string &driverId,
+                   int32_t day, int16_t departureMinutes, int16_t arrivalMinutes)
+    : id(id), routeId(SymbolTable::intern(routeId)), busId(SymbolTable::intern(busId)),
+      driverId(SymbolTable::intern(driverId)),
+      day(day), departure(departureMinutes), arrival(arrivalMinutes) {}
+
+Schedule::Schedule(const string &id, Symbol routeId, Symbol busId, Symbol driverId,
+                   int32_t day, int16_t departureMinutes, int16_t arrivalMinutes)
     : id(id), routeId(routeId), busId(busId), driverId(driverId),
-      date(date), departureTime(departureTime), arrivalTime(arrivalTime) {}
+      day(day), departure(departureMinutes), arrival(arrivalMinutes) {}
 
-string Schedule::getId() const
+const EntityId &Schedule::getId() const
 {
     return id;
 }
 
-string Schedule::getRouteId() const
+const string &Schedule::getRouteId() const
 {
-    return routeId;
+    return SymbolTable::name(routeId);
 }
 
-string Schedule::getBusId() const
+const string &Schedule::getBusId() const
 {
-    return busId;
+    return SymbolTable::name(busId);
 }
 
-string Schedule::getDriverId() const
+const string &Schedule::getDriverId() const
 {
-    return driverId;
+    return SymbolTable::name(driverId);
 }
 
 string Schedule::getDate() const
 {
-    return date;
+    return formatDate(day);
 }
 
 string Schedule::getDepartureTime() const
 {
-    return departureTime;
+    return formatTime(departure);
 }
 
 string Schedule::getArrivalTime() const
 {
-    return arrivalTime;
+    return formatTime(arrival);
+}
+
+Symbol Schedule::getRouteSymbol() const
+{
+    return routeId;
+}
+
+Symbol Schedule::getBusSymbol() const
+{
+    return busId;
+}
+
+Symbol Schedule::getDriverSymbol() const
+{
+    return driverId;
+}
+
+int32_t Schedule::getDay() const
+{
+    return day;
+}
+
+int16_t Schedule::getDepartureMinutes() const
+{
+    return departure;
+}
+
+int16_t Schedule::getArrivalMinutes() const
+{
+    return arrival;
 }
 
 void Schedule::setId(const string &id)
 {
-    this->id = id;
+    this->id = EntityId(id);
 }
 
 void Schedule::setRouteId(const string &routeId)
 {
-    this->routeId = routeId;
+    this->routeId = SymbolTable::intern(routeId);
 }
 
 void Schedule::setBusId(const string &busId)
 {
-    this->busId = busId;
+    this->busId = SymbolTable::intern(busId);
 }
 
 void Schedule::setDriverId(const string &driverId)
 {
-    this->driverId = driverId;
+    this->driverId = SymbolTable::intern(driverId);
 }
 
 void Schedule::setDate(const string &date)
 {
-    this->date = date;
+    this->day = parseDate(date);
 }
 
 void Schedule::setDepartureTime(const string &departureTime)
 {
-    this->departureTime = departureTime;
+    this->departure = parseTime(departureTime);
 }
 
 void Schedule::setArrivalTime(const string &arrivalTime)
 {
-    this->arrivalTime = arrivalTime;
+    this->arrival = parseTime(arrivalTime);
 }
 
 void Schedule::display() const
 {
     cout << left
          << setw(12) << id
-         << setw(12) << routeId
-         << setw(10) << busId
-         << setw(12) << driverId
-         << setw(12) << date
-         << setw(10) << departureTime
-         << setw(10) << arrivalTime
+         << setw(12) << SymbolTable::name(routeId)
+         << setw(10) << SymbolTable::name(busId)
+         << setw(12) << SymbolTable::name(driverId)
+         << setw(12) << formatDate(day)
+         << setw(10) << formatTime(departure)
+         << setw(10) << formatTime(arrival)
          << endl;
 }
 
 bool Schedule::hasTimeOverlap(const Schedule &other) const
 {
-    if (this->date != other.date)
+    if (this->day != other.day)
     {
         return false;
     }
 
-    return !((this->arrivalTime <= other.departureTime) ||
-             (this->departureTime >= other.arrivalTime));
+    return !((this->arrival <= other.departure) ||
+             (this->departure >= other.arrival));
 }
@@ -1,4 +1,8 @@
 ﻿#include "../include/ScheduleManager.h"
+#include "../include/BusManager.h"
+#include "../include/DriverManager.h"
+#include "../include/RouteManager.h"
+#include "../include/DataLoader.h"
 #include "../include/DataSaver.h"
 #include "../include/DisplayManager.h"
 #include <iostream>
@@ -6,18 +10,85 @@
 
 using namespace std;
 
+// A row whose date or time did not parse on load.
+static bool isUnreadable(const Schedule &schedule)
+{
+    return schedule.getDay() == Schedule::INVALID_DAY || schedule.getDepartureMinutes() == Schedule::INVALID_TIME ||
+           schedule.getArrivalMinutes() == Schedule::INVALID_TIME;
+}
+
 ScheduleManager::ScheduleManager(vector<Schedule> &scheduleList,
                                  vector<Route> &routeList,
                                  vector<Bus> &busList,
                                  vector<Driver> &driverList,
                                  const string &filename)
-    : schedules(scheduleList), routes(routeList), buses(busList), drivers(driverList), dataFile(filename) {}
+    : schedules(scheduleList), routes(routeList), buses(busList), drivers(driverList), dataFile(filename),
+      log(filename + ".log"), compactionThreshold(OperationLog::DEFAULT_COMPACTION_THRESHOLD),
+      flusher(nullptr), flushHandle(0), slots(schedules), revision(0), departureRouteRevision(0),
+      availabilityBuilt(false), busRosterRevision(0), driverRosterRevision(0), unreadableCount(0), unreadableWarned(false),
+      routeLookup(nullptr), busLookup(nullptr), driverLookup(nullptr)
+{
+    size_t replayed = log.replay(schedules, DataLoader::parseScheduleRecord, dataFile);
+    if (replayed > 0)
+    {
+        cout << "Replayed " << replayed << " logged schedule changes from " << log.getFilename() << endl;
+        slots.rebuild();
+    }
+
+    index.rebuild(schedules, slots);
+    store.rebuild(schedules);
+    for (const auto &schedule : schedules)
+    {
+        indexIntervals(schedule);
+        unreadableCount += isUnreadable(schedule);
+    }
+}
+
+static IntervalIndex::Interval intervalOf(const Schedule &schedule)
+{
+    return {schedule.getDepartureMinutes(), schedule.getArrivalMinutes(), schedule.getId()};
+}
+
+void ScheduleManager::indexIntervals(const Schedule &schedule)
+{
+    IntervalIndex::Interval interval = intervalOf(schedule);
+    busIntervals.insert(schedule.getBusSymbol(), schedule.getDay(), interval);
+    driverIntervals.insert(schedule.getDriverSymbol(), schedule.getDay(), interval);
+    if (availabilityBuilt)
+    {
+        busAvailability.occupy(schedule.getBusSymbol(), schedule.getDay(), interval.start, interval.end);
+        driverAvailability.occupy(schedule.getDriverSymbol(), schedule.getDay(), interval.start, interval.end);
+    }
+}
+
+void ScheduleManager::unindexIntervals(const Schedule &schedule)
+{
+    IntervalIndex::Interval interval = intervalOf(schedule);
+    busIntervals.erase(schedule.getBusSymbol(), schedule.getDay(), interval);
+    driverIntervals.erase(schedule.getDriverSymbol(), schedule.getDay(), interval);
+    if (availabilityBuilt)
+    {
+        busAvailability.redraw(schedule.getBusSymbol(), schedule.getDay(),
+                               busIntervals.intervalsOf(schedule.getBusSymbol(), schedule.getDay()));
+        driverAvailability.redraw(schedule.getDriverSymbol(), schedule.getDay(),
+                                  driverIntervals.intervalsOf(schedule.getDriverSymbol(), schedule.getDay()));
+    }
+}
+
+void ScheduleManager::setReferenceLookups(const RouteManager &routeManager, const BusManager &busManager,
+                                          const DriverManager &driverManager)
+{
+    routeLookup = &routeManager;
+    busLookup = &busManager;
+    driverLookup = &driverManager;
+}
 
 bool ScheduleManager::hasValidReferences(const Schedule &schedule) const
 {
-    bool routeExists = any_of(routes.begin(), routes.end(),
-                              [&schedule](const Route &r)
-                              { return r.getId() == schedule.getRouteId(); });
+    bool routeExists = routeLookup ? routeLookup->routeExists(schedule.getRouteId())
+                                   : any_of(routes.begin(), routes.end(),
+                                            [&schedule](const Route &r)
+                                            { return r.getId() == schedule.getRouteId(); });
 
     if (!routeExists)
     {
@@ -25,9 +96,10 @@ bool ScheduleManager::hasValidReferences(const Schedule &schedule) const
         return false;
     }
 
-    bool busExists = any_of(buses.begin(), buses.end(),
-                            [&schedule](const Bus &b)
-                            { return b.getId() == schedule.getBusId(); });
+    bool busExists = busLookup ? busLookup->busExists(schedule.getBusId())
+                               : any_of(buses.begin(), buses.end(),
+                                        [&schedule](const Bus &b)
+                                        { return b.getId() == schedule.getBusId(); });
 
     if (!busExists)
     {
@@ -35,9 +107,10 @@ bool ScheduleManager::hasValidReferences(const Schedule &schedule) const
         return false;
     }
 
-    bool driverExists = any_of(drivers.begin(), drivers.end(),
-                               [&schedule](const Driver &d)
-                               { return d.getId() == schedule.getDriverId(); });
+    bool driverExists = driverLookup ? driverLookup->driverExists(schedule.getDriverId())
+                                     : any_of(drivers.begin(), drivers.end(),
+                                              [&schedule](const Driver &d)
+                                              { return d.getId() == schedule.getDriverId(); });
 
     if (!driverExists)
     {
@@ -48,54 +121,38 @@ bool ScheduleManager::hasValidReferences(const Schedule &schedule) const
     return true;
 }
 
-bool ScheduleManager::hasBusOverlap(const Schedule &newSchedule, const string &excludeScheduleId) const
+bool ScheduleManager::hasBusOverlap(const Schedule &newSchedule, const EntityId &excludeScheduleId) const
 {
-    for (const auto &existingSchedule : schedules)
-    {
-        if (existingSchedule.getId() == excludeScheduleId)
-        {
-            continue;
-        }
+    const IntervalIndex::Interval *existing =
+        busIntervals.findOverlap(newSchedule.getBusSymbol(), newSchedule.getDay(),
+                                 newSchedule.getDepartureMinutes(), newSchedule.getArrivalMinutes(),
+                                 excludeScheduleId);
 
-        if (existingSchedule.getBusId() == newSchedule.getBusId() &&
-            existingSchedule.getDate() == newSchedule.getDate())
-        {
-
-            if (existingSchedule.hasTimeOverlap(newSchedule))
-            {
-                cout << "Error: Bus " << newSchedule.getBusId()
-                     << " is already scheduled on " << newSchedule.getDate()
-                     << " from " << existingSchedule.getDepartureTime()
-                     << " to " << existingSchedule.getArrivalTime() << endl;
-                return true;
-            }
-        }
+    if (existing)
+    {
+        cout << "Error: Bus " << newSchedule.getBusId()
+             << " is already scheduled on " << newSchedule.getDate()
+             << " from " << Schedule::formatTime(existing->start)
+             << " to " << Schedule::formatTime(existing->end) << endl;
+        return true;
     }
     return false;
 }
 
-bool ScheduleManager::hasDriverOverlap(const Schedule &newSchedule, const string &excludeScheduleId) const
+bool ScheduleManager::hasDriverOverlap(const Schedule &newSchedule, const EntityId &excludeScheduleId) const
 {
-    for (const auto &existingSchedule : schedules)
-    {
-        if (existingSchedule.getId() == excludeScheduleId)
-        {
-            continue;
-        }
+    const IntervalIndex::Interval *existing =
+        driverIntervals.findOverlap(newSchedule.getDriverSymbol(), newSchedule.getDay(),
+                                    newSchedule.getDepartureMinutes(), newSchedule.getArrivalMinutes(),
+                                    excludeScheduleId);
 
-        if (existingSchedule.getDriverId() == newSchedule.getDriverId() &&
-            existingSchedule.getDate() == newSchedule.getDate())
-        {
-
-            if (existingSchedule.hasTimeOverlap(newSchedule))
-            {
-                cout << "Error: Driver " << newSchedule.getDriverId()
-                     << " is already assigned on " << newSchedule.getDate()
-                     << " from " << existingSchedule.getDepartureTime()
-                     << " to " << existingSchedule.getArrivalTime() << endl;
-                return true;
-            }
-        }
+    if (existing)
+    {
+        cout << "Error: Driver " << newSchedule.getDriverId()
+             << " is already assigned on " << newSchedule.getDate()
+             << " from " << Schedule::formatTime(existing->start)
+             << " to " << Schedule::formatTime(existing->end) << endl;
+        return true;
     }
     return false;
 }
@@ -108,6 +165,12 @@ bool ScheduleManager::validateSchedule(const Schedule &schedule) const
         return false;
     }
 
+    if (!schedule.getId().isValid())
+    {
+        cout << "Error: Schedule ID must be at most " << EntityId::CAPACITY << " characters." << endl;
+        return false;
+    }
+
     if (schedule.getRouteId().empty() || schedule.getBusId().empty() ||
         schedule.getDriverId().empty())
     {
@@ -115,19 +178,20 @@ bool ScheduleManager::validateSchedule(const Schedule &schedule) const
         return false;
     }
 
-    if (schedule.getDate().empty())
+    if (schedule.getDay() == Schedule::INVALID_DAY)
     {
-        cout << "Error: Date must be provided." << endl;
+        cout << "Error: Date must be provided in YYYY-MM-DD format." << endl;
         return false;
     }
 
-    if (schedule.getDepartureTime().empty() || schedule.getArrivalTime().empty())
+    if (schedule.getDepartureMinutes() == Schedule::INVALID_TIME ||
+        schedule.getArrivalMinutes() == Schedule::INVALID_TIME)
     {
-        cout << "Error: Departure and arrival times must be provided." << endl;
+        cout << "Error: Departure and arrival times must be provided in HH:MM format." << endl;
         return false;
     }
 
-    if (schedule.getDepartureTime() >= schedule.getArrivalTime())
+    if (schedule.getDepartureMinutes() >= schedule.getArrivalMinutes())
     {
         cout << "Error: Departure time must be before arrival time." << endl;
         return false;
@@ -136,66 +200,145 @@ bool ScheduleManager::validateSchedule(const Schedule &schedule) const
     return true;
 }
 
-bool ScheduleManager::scheduleExists(const string &scheduleId) const
+const vector<Schedule> &ScheduleManager::getSchedules() const
+{
+    return schedules;
+}
+
+size_t ScheduleManager::getRevision() const
 {
-    return any_of(schedules.begin(), schedules.end(),
-                  [&scheduleId](const Schedule &s)
-                  { return s.getId() == scheduleId; });
+    return revision;
 }
 
-Schedule *ScheduleManager::findSchedule(const string &scheduleId)
+bool ScheduleManager::scheduleExists(const EntityId &scheduleId) const
 {
-    auto it = find_if(schedules.begin(), schedules.end(),
-                      [&scheduleId](const Schedule &s)
-                      { return s.getId() == scheduleId; });
+    return index.contains(scheduleId);
+}
 
-    if (it != schedules.end())
+Schedule *ScheduleManager::findSchedule(const EntityId &scheduleId)
+{
+    return slots.get(index.find(scheduleId));
+}
+
+ScheduleManager::Handle ScheduleManager::findScheduleHandle(const EntityId &scheduleId) const
+{
+    return index.find(scheduleId);
+}
+
+Schedule *ScheduleManager::getSchedule(Handle handle)
+{
+    return slots.get(handle);
+}
+
+ScheduleView ScheduleManager::getSchedulesByDriver(const string &driverId) const
+{
+    return findSchedules(ScheduleQuery().driver(driverId));
+}
+
+ScheduleView ScheduleManager::getSchedulesByDate(const string &date) const
+{
+    return findSchedules(ScheduleQuery().date(date));
+}
+
+ScheduleView ScheduleManager::getSchedulesByBus(const string &busId) const
+{
+    return findSchedules(ScheduleQuery().bus(busId));
+}
+
+ScheduleView ScheduleManager::findSchedules(const ScheduleQuery &query) const
+{
+    return ScheduleView(schedules, query.select(store));
+}
+
+const ScheduleStore &ScheduleManager::getStore() const
+{
+    return store;
+}
+
+TimetableAudit::Report ScheduleManager::auditTimetable(unsigned threadCount) const
+{
+    return TimetableAudit::run(schedules, store, threadCount);
+}
+
+vector<DepartureBoard::Departure> ScheduleManager::getNextDepartures(const string &stop, int32_t day,
+                                                                     int16_t minute, size_t count)
+{
+    FlushScheduler::Guard guard(flusher);
+
+    size_t routeRevision = routeLookup ? routeLookup->getRevision() : 0;
+    if (!departures.isBuilt() || departureRouteRevision != routeRevision)
     {
-        return &(*it);
+        departures.build(routes, schedules, slots);
+        departureRouteRevision = routeRevision;
     }
-    return nullptr;
+    return departures.next(stop, day, minute, count);
 }
 
-vector<Schedule> ScheduleManager::getSchedulesByDriver(const string &driverId) const
+vector<Symbol> ScheduleManager::activeBusRoster() const
 {
-    vector<Schedule> result;
-    for (const auto &schedule : schedules)
+    Symbol active = SymbolTable::intern("Active");
+    vector<Symbol> roster;
+    for (const auto &bus : buses)
     {
-        if (schedule.getDriverId() == driverId)
+        if (bus.getStatusSymbol() == active)
         {
-            result.push_back(schedule);
+            roster.push_back(SymbolTable::intern(bus.getId().view()));
         }
     }
-    return result;
+    return roster;
 }
 
-vector<Schedule> ScheduleManager::getSchedulesByDate(const string &date) const
+vector<Symbol> ScheduleManager::driverRoster() const
 {
-    vector<Schedule> result;
-    for (const auto &schedule : schedules)
+    vector<Symbol> roster;
+    roster.reserve(drivers.size());
+    for (const auto &driver : drivers)
     {
-        if (schedule.getDate() == date)
-        {
-            result.push_back(schedule);
-        }
+        roster.push_back(SymbolTable::intern(driver.getId().view()));
     }
-    return result;
+    return roster;
 }
 
-vector<Schedule> ScheduleManager::getSchedulesByBus(const string &busId) const
+AssignmentPlanner::Report ScheduleManager::planAssignments(const vector<Schedule> &trips, unsigned threadCount) const
 {
-    vector<Schedule> result;
-    for (const auto &schedule : schedules)
+    return AssignmentPlanner::run(trips, schedules, activeBusRoster(), driverRoster(), threadCount);
+}
+
+void ScheduleManager::findFreeResources(int32_t day, int16_t start, int16_t end, vector<Symbol> &freeBuses,
+                                        vector<Symbol> &freeDrivers)
+{
+    FlushScheduler::Guard guard(flusher);
+
+    bool rebuildRosters = !availabilityBuilt;
+    if (!availabilityBuilt)
     {
-        if (schedule.getBusId() == busId)
+        for (const auto &schedule : schedules)
         {
-            result.push_back(schedule);
+            busAvailability.occupy(schedule.getBusSymbol(), schedule.getDay(), schedule.getDepartureMinutes(),
+                                   schedule.getArrivalMinutes());
+            driverAvailability.occupy(schedule.getDriverSymbol(), schedule.getDay(), schedule.getDepartureMinutes(),
+                                      schedule.getArrivalMinutes());
         }
+        availabilityBuilt = true;
     }
-    return result;
+
+    // Without the managers' revisions the lists may have changed at any time.
+    if (rebuildRosters || !busLookup || busLookup->getRevision() != busRosterRevision)
+    {
+        busAvailability.setRoster(activeBusRoster());
+        busRosterRevision = busLookup ? busLookup->getRevision() : 0;
+    }
+    if (rebuildRosters || !driverLookup || driverLookup->getRevision() != driverRosterRevision)
+    {
+        driverAvailability.setRoster(driverRoster());
+        driverRosterRevision = driverLookup ? driverLookup->getRevision() : 0;
+    }
+
+    freeBuses = busAvailability.findFree(day, start, end);
+    freeDrivers = driverAvailability.findFree(day, start, end);
 }
 
-bool ScheduleManager::addSchedule(const Schedule &newSchedule)
+bool ScheduleManager::checkAdd(const Schedule &newSchedule) const
 {
     if (!validateSchedule(newSchedule))
     {
@@ -222,17 +365,12 @@ bool ScheduleManager::addSchedule(const Schedule &newSchedule)
     {
         return false;
     }
-
-    schedules.push_back(newSchedule);
-    cout << "Schedule " << newSchedule.getId() << " added successfully." << endl;
-
-    return saveToFile();
+    return true;
 }
 
-bool ScheduleManager::updateSchedule(const string &scheduleId, const Schedule &updatedSchedule)
+bool ScheduleManager::checkUpdate(const EntityId &scheduleId, const Schedule &updatedSchedule) const
 {
-    Schedule *schedule = findSchedule(scheduleId);
-    if (!schedule)
+    if (!scheduleExists(scheduleId))
     {
         cout << "Error: Schedule with ID " << scheduleId << " not found." << endl;
         return false;
@@ -258,41 +396,299 @@ bool ScheduleManager::updateSchedule(const string &scheduleId, const Schedule &u
         return false;
     }
 
+    if (updatedSchedule.getId() != scheduleId && scheduleExists(updatedSchedule.getId()))
+    {
+        cout << "Error: Schedule with ID " << updatedSchedule.getId() << " already exists." << endl;
+        return false;
+    }
+    return true;
+}
+
+bool ScheduleManager::checkRemove(const EntityId &scheduleId) const
+{
+    if (!scheduleExists(scheduleId))
+    {
+        cout << "Error: Schedule with ID " << scheduleId << " not found." << endl;
+        return false;
+    }
+    return true;
+}
+
+void ScheduleManager::applyAdd(const Schedule &newSchedule)
+{
+    revision++;
+    unreadableCount += isUnreadable(newSchedule);
+    Handle handle = slots.insert(newSchedule);
+    index.insert(newSchedule.getId(), handle);
+    store.append(newSchedule);
+    indexIntervals(newSchedule);
+    if (departures.isBuilt())
+    {
+        departures.insert(newSchedule, handle);
+    }
+}
+
+void ScheduleManager::applyUpdate(const EntityId &scheduleId, const Schedule &updatedSchedule)
+{
+    revision++;
+    Handle handle = index.find(scheduleId);
+    Schedule *schedule = slots.get(handle);
+    unreadableCount += isUnreadable(updatedSchedule);
+    unreadableCount -= isUnreadable(*schedule);
+    unindexIntervals(*schedule);
+    if (departures.isBuilt())
+    {
+        departures.erase(*schedule, handle);
+        departures.insert(updatedSchedule, handle);
+    }
     *schedule = updatedSchedule;
+    store.assign(static_cast<size_t>(schedule - schedules.data()), updatedSchedule);
+    index.rename(scheduleId, updatedSchedule.getId());
+    indexIntervals(updatedSchedule);
+}
+
+void ScheduleManager::applyRemove(const EntityId &scheduleId)
+{
+    revision++;
+    Handle handle = index.find(scheduleId);
+    uint32_t position = slots.indexOf(handle);
+    unreadableCount -= isUnreadable(schedules[position]);
+    unindexIntervals(schedules[position]);
+    if (departures.isBuilt())
+    {
+        departures.erase(schedules[position], handle);
+    }
+    store.erase(position);
+    index.erase(scheduleId, schedules, slots);
+}
+
+bool ScheduleManager::addSchedule(const Schedule &newSchedule)
+{
+    FlushScheduler::Guard guard(flusher);
+
+    if (!checkAdd(newSchedule))
+    {
+        return false;
+    }
+
+    applyAdd(newSchedule);
+    cout << "Schedule " << newSchedule.getId() << " added successfully." << endl;
+
+    return persist('A', newSchedule.getId(), &newSchedule);
+}
+
+bool ScheduleManager::updateSchedule(const EntityId &scheduleId, const Schedule &updatedSchedule)
+{
+    FlushScheduler::Guard guard(flusher);
+
+    if (!checkUpdate(scheduleId, updatedSchedule))
+    {
+        return false;
+    }
+
+    applyUpdate(scheduleId, updatedSchedule);
     cout << "Schedule " << scheduleId << " updated successfully." << endl;
 
-    return saveToFile();
+    return persist('U', scheduleId, &updatedSchedule);
 }
 
-bool ScheduleManager::removeSchedule(const string &scheduleId)
+bool ScheduleManager::updateSchedule(Handle handle, const Schedule &updatedSchedule)
 {
-    auto it = find_if(schedules.begin(), schedules.end(),
-                      [&scheduleId](const Schedule &s)
-                      { return s.getId() == scheduleId; });
+    const Schedule *schedule = slots.get(handle);
+    if (!schedule)
+    {
+        cout << "Error: Schedule no longer exists." << endl;
+        return false;
+    }
+    // Copied: the update overwrites the stored ID.
+    EntityId scheduleId = schedule->getId();
+    return updateSchedule(scheduleId, updatedSchedule);
+}
+
+bool ScheduleManager::removeSchedule(const EntityId &scheduleId)
+{
+    FlushScheduler::Guard guard(flusher);
 
-    if (it == schedules.end())
+    if (!checkRemove(scheduleId))
     {
-        cout << "Error: Schedule with ID " << scheduleId << " not found." << endl;
         return false;
     }
 
-    schedules.erase(it);
+    applyRemove(scheduleId);
     cout << "Schedule " << scheduleId << " removed successfully." << endl;
 
-    return saveToFile();
+    return persist('R', scheduleId);
+}
+
+size_t ScheduleManager::unreadableRows() const
+{
+    return unreadableCount;
 }
 
 bool ScheduleManager::saveToFile()
 {
+    size_t unreadable = unreadableRows();
+    if (unreadable > 0)
+    {
+        cout << "Error: " << unreadable << " schedules have an unreadable date or time; " << dataFile
+             << " is not rewritten until they are fixed or removed." << endl;
+        return false;
+    }
     return DataSaver::saveSchedules(dataFile, schedules);
 }
 
+bool ScheduleManager::persist(char operation, const EntityId &scheduleId, const Schedule *schedule)
+{
+    recordBuffer.clear();
+    if (schedule)
+    {
+        DataSaver::formatSchedule(*schedule, recordBuffer);
+    }
+    if (!log.append(operation, scheduleId.view(), recordBuffer))
+    {
+        return false;
+    }
+
+    if (flusher)
+    {
+        flusher->markDirty(flushHandle);
+        return true;
+    }
+
+    if (log.size() >= compactionThreshold)
+    {
+        return compact();
+    }
+    return true;
+}
+
+bool ScheduleManager::persistBatch(const vector<LogEntry> &entries)
+{
+    if (!log.appendAll(entries))
+    {
+        return false;
+    }
+
+    if (flusher)
+    {
+        flusher->markDirty(flushHandle);
+        return true;
+    }
+
+    if (log.size() >= compactionThreshold)
+    {
+        return compact();
+    }
+    return true;
+}
+
+bool ScheduleManager::compact()
+{
+    lock_guard<mutex> compacting(compactMutex);
+
+    string contents;
+    size_t count;
+    {
+        FlushScheduler::Guard guard(flusher);
+
+        // Rewriting would blank the dates and times the load could not read,
+        // so until those rows are fixed every change stays in the log instead.
+        if (unreadableRows() > 0)
+        {
+            if (!unreadableWarned)
+            {
+                cout << "Warning: " << dataFile << " has schedules with an unreadable date or time; "
+                     << "changes are kept in " << log.getFilename() << " until they are fixed." << endl;
+                unreadableWarned = true;
+            }
+            return true;
+        }
+        unreadableWarned = false;
+
+        contents = DataSaver::formatSchedules(schedules);
+        count = schedules.size();
+        if (!log.checkpoint(contents))
+        {
+            return false;
+        }
+    }
+
+    if (!log.sync() || !DataSaver::saveFormatted(dataFile, contents, count, "schedules"))
+    {
+        return false;
+    }
+
+    FlushScheduler::Guard guard(flusher);
+    return log.trimToCheckpoint();
+}
+
+bool ScheduleManager::commitLog()
+{
+    bool due;
+    {
+        FlushScheduler::Guard guard(flusher);
+        due = log.size() >= compactionThreshold;
+    }
+    return log.sync() && (!due || compact());
+}
+
+void ScheduleManager::setCompactionThreshold(size_t entries)
+{
+    compactionThreshold = max<size_t>(1, entries);
+}
+
+void ScheduleManager::attachFlusher(FlushScheduler &scheduler)
+{
+    flusher = &scheduler;
+    flushHandle = scheduler.registerFile(dataFile, [this]()
+                                         { return commitLog(); });
+    if (log.size() > 0)
+    {
+        scheduler.markDirty(flushHandle);
+    }
+}
+
 void ScheduleManager::displayAllSchedules() const
 {
     DisplayManager::displaySchedules(schedules);
 }
 
+void ScheduleManager::displaySchedules(const ScheduleView &view) const
+{
+    DisplayManager::displaySchedules(view);
+}
+
 void ScheduleManager::displaySchedule(const Schedule &schedule) const
 {
     DisplayManager::displaySchedule(schedule);
 }
+
+void ScheduleManager::displayConflictReport(const TimetableAudit::Report &report) const
+{
+    DisplayManager::displayConflictReport(report);
+}
+
+void ScheduleManager::displayDepartures(const string &stop, const vector<DepartureBoard::Departure> &upcoming) const
+{
+    vector<pair<int64_t, const Schedule *>> rows;
+    for (const auto &departure : upcoming)
+    {
+        const Schedule *schedule = slots.get(departure.schedule);
+        if (schedule)
+        {
+            rows.emplace_back(departure.time, schedule);
+        }
+    }
+    DisplayManager::displayDepartures(stop, rows);
+}
+
+void ScheduleManager::displayFreeResources(const vector<Symbol> &freeBuses, const vector<Symbol> &freeDrivers,
+                                           size_t limit) const
+{
+    DisplayManager::displayFreeResources(freeBuses, freeDrivers, limit);
+}
+
+void ScheduleManager::displayAssignmentReport(const AssignmentPlanner::Report &report) const
+{
+    DisplayManager::displayAssignmentReport(report);
+}
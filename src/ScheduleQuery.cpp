@@ -0,0 +1,113 @@
+﻿#include "../include/ScheduleQuery.h"
+#include "../include/ScanKernels.h"
+#include <algorithm>
+
+using namespace std;
+
+const uint32_t *ScheduleQuery::columnData(const ScheduleStore &store, Column column)
+{
+    switch (column)
+    {
+    case Column::ROUTE:
+        return store.routeColumn().data();
+    case Column::BUS:
+        return store.busColumn().data();
+    case Column::DRIVER:
+        return store.driverColumn().data();
+    default:
+        // Day numbers are matched bit for bit, so the signed column is scanned as unsigned.
+        return reinterpret_cast<const uint32_t *>(store.dayColumn().data());
+    }
+}
+
+ScheduleQuery &ScheduleQuery::symbolEquals(Column column, const string &id)
+{
+    Symbol symbol;
+    if (!SymbolTable::find(id, symbol))
+    {
+        matchesNothing = true;
+        return *this;
+    }
+    equalities.push_back({column, symbol});
+    return *this;
+}
+
+ScheduleQuery &ScheduleQuery::route(const string &routeId)
+{
+    return symbolEquals(Column::ROUTE, routeId);
+}
+
+ScheduleQuery &ScheduleQuery::bus(const string &busId)
+{
+    return symbolEquals(Column::BUS, busId);
+}
+
+ScheduleQuery &ScheduleQuery::driver(const string &driverId)
+{
+    return symbolEquals(Column::DRIVER, driverId);
+}
+
+ScheduleQuery &ScheduleQuery::date(const string &date)
+{
+    int32_t day = Schedule::parseDate(date);
+    if (day == Schedule::INVALID_DAY)
+    {
+        matchesNothing = true;
+        return *this;
+    }
+    equalities.push_back({Column::DAY, static_cast<uint32_t>(day)});
+    return *this;
+}
+
+ScheduleQuery &ScheduleQuery::departingBetween(const string &fromTime, const string &toTime)
+{
+    int16_t from = Schedule::parseTime(fromTime);
+    int16_t to = Schedule::parseTime(toTime);
+    if (from == Schedule::INVALID_TIME || to == Schedule::INVALID_TIME)
+    {
+        matchesNothing = true;
+        return *this;
+    }
+    // A second window narrows the first.
+    windowFrom = hasWindow ? max(windowFrom, from) : from;
+    windowTo = hasWindow ? min(windowTo, to) : to;
+    hasWindow = true;
+    return *this;
+}
+
+ScheduleStore::Bitmap ScheduleQuery::match(const ScheduleStore &store) const
+{
+    const size_t rows = store.size();
+    ScheduleStore::Bitmap bits(ScanKernels::wordCount(rows));
+    if (matchesNothing)
+    {
+        return bits;
+    }
+
+    if (equalities.empty())
+    {
+        ScanKernels::selectAll(rows, bits.data());
+    }
+    for (size_t i = 0; i < equalities.size(); ++i)
+    {
+        const uint32_t *values = columnData(store, equalities[i].column);
+        if (i == 0)
+        {
+            ScanKernels::selectEqual(values, rows, equalities[i].value, bits.data());
+        }
+        else
+        {
+            ScanKernels::keepEqual(values, rows, equalities[i].value, bits.data());
+        }
+    }
+    if (hasWindow)
+    {
+        ScanKernels::keepRange(store.departureColumn().data(), rows, windowFrom, windowTo, bits.data());
+    }
+    return bits;
+}
+
+ScheduleStore::RowList ScheduleQuery::select(const ScheduleStore &store) const
+{
+    return ScanKernels::selectedRows(match(store));
+}
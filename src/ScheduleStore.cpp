@@ -0,0 +1,163 @@
+﻿#include "../include/ScheduleStore.h"
+#include "../include/ScanKernels.h"
+
+using namespace std;
+
+static ScheduleStore::Bitmap matchEqual(const uint32_t *values, size_t count, uint32_t value)
+{
+    ScheduleStore::Bitmap bits(ScanKernels::wordCount(count));
+    ScanKernels::selectEqual(values, count, value, bits.data());
+    return bits;
+}
+
+void ScheduleStore::rebuild(const vector<Schedule> &schedules)
+{
+    routes.clear();
+    buses.clear();
+    drivers.clear();
+    days.clear();
+    departures.clear();
+    arrivals.clear();
+    reserve(schedules.size());
+    for (const auto &schedule : schedules)
+    {
+        append(schedule);
+    }
+}
+
+void ScheduleStore::append(const Schedule &schedule)
+{
+    routes.push_back(schedule.getRouteSymbol());
+    buses.push_back(schedule.getBusSymbol());
+    drivers.push_back(schedule.getDriverSymbol());
+    days.push_back(schedule.getDay());
+    departures.push_back(schedule.getDepartureMinutes());
+    arrivals.push_back(schedule.getArrivalMinutes());
+}
+
+void ScheduleStore::assign(size_t row, const Schedule &schedule)
+{
+    routes[row] = schedule.getRouteSymbol();
+    buses[row] = schedule.getBusSymbol();
+    drivers[row] = schedule.getDriverSymbol();
+    days[row] = schedule.getDay();
+    departures[row] = schedule.getDepartureMinutes();
+    arrivals[row] = schedule.getArrivalMinutes();
+}
+
+void ScheduleStore::erase(size_t row)
+{
+    // Mirrors SlotMap::erase: the last row moves into the gap.
+    size_t last = size() - 1;
+    routes[row] = routes[last];
+    buses[row] = buses[last];
+    drivers[row] = drivers[last];
+    days[row] = days[last];
+    departures[row] = departures[last];
+    arrivals[row] = arrivals[last];
+
+    routes.pop_back();
+    buses.pop_back();
+    drivers.pop_back();
+    days.pop_back();
+    departures.pop_back();
+    arrivals.pop_back();
+}
+
+void ScheduleStore::reserve(size_t rows)
+{
+    routes.reserve(rows);
+    buses.reserve(rows);
+    drivers.reserve(rows);
+    days.reserve(rows);
+    departures.reserve(rows);
+    arrivals.reserve(rows);
+}
+
+size_t ScheduleStore::size() const
+{
+    return days.size();
+}
+
+const vector<Symbol> &ScheduleStore::routeColumn() const
+{
+    return routes;
+}
+
+const vector<Symbol> &ScheduleStore::busColumn() const
+{
+    return buses;
+}
+
+const vector<Symbol> &ScheduleStore::driverColumn() const
+{
+    return drivers;
+}
+
+const vector<int32_t> &ScheduleStore::dayColumn() const
+{
+    return days;
+}
+
+const vector<int16_t> &ScheduleStore::departureColumn() const
+{
+    return departures;
+}
+
+const vector<int16_t> &ScheduleStore::arrivalColumn() const
+{
+    return arrivals;
+}
+
+ScheduleStore::Bitmap ScheduleStore::matchRoute(Symbol route) const
+{
+    return matchEqual(routes.data(), routes.size(), route);
+}
+
+ScheduleStore::Bitmap ScheduleStore::matchBus(Symbol bus) const
+{
+    return matchEqual(buses.data(), buses.size(), bus);
+}
+
+ScheduleStore::Bitmap ScheduleStore::matchDriver(Symbol driver) const
+{
+    return matchEqual(drivers.data(), drivers.size(), driver);
+}
+
+ScheduleStore::Bitmap ScheduleStore::matchDay(int32_t day) const
+{
+    // Day numbers are matched bit for bit, so the signed column is scanned as unsigned.
+    return matchEqual(reinterpret_cast<const uint32_t *>(days.data()), days.size(), static_cast<uint32_t>(day));
+}
+
+ScheduleStore::Bitmap ScheduleStore::matchDepartingBetween(int32_t day, int16_t from, int16_t to) const
+{
+    Bitmap bits = matchDay(day);
+    ScanKernels::keepRange(departures.data(), departures.size(), from, to, bits.data());
+    return bits;
+}
+
+ScheduleStore::RowList ScheduleStore::selectByRoute(Symbol route) const
+{
+    return ScanKernels::selectedRows(matchRoute(route));
+}
+
+ScheduleStore::RowList ScheduleStore::selectByBus(Symbol bus) const
+{
+    return ScanKernels::selectedRows(matchBus(bus));
+}
+
+ScheduleStore::RowList ScheduleStore::selectByDriver(Symbol driver) const
+{
+    return ScanKernels::selectedRows(matchDriver(driver));
+}
+
+ScheduleStore::RowList ScheduleStore::selectByDay(int32_t day) const
+{
+    return ScanKernels::selectedRows(matchDay(day));
+}
+
+ScheduleStore::RowList ScheduleStore::selectDepartingBetween(int32_t day, int16_t from, int16_t to) const
+{
+    return ScanKernels::selectedRows(matchDepartingBetween(day, from, to));
+}
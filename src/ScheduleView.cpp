@@ -0,0 +1,77 @@
+﻿#include "../include/ScheduleView.h"
+#include <utility>
+
+using namespace std;
+
+ScheduleView::Iterator::Iterator(const ScheduleView *view, size_t position)
+    : view(view), position(position) {}
+
+ScheduleView::Iterator::reference ScheduleView::Iterator::operator*() const
+{
+    return (*view)[position];
+}
+
+ScheduleView::Iterator::pointer ScheduleView::Iterator::operator->() const
+{
+    return &(*view)[position];
+}
+
+ScheduleView::Iterator &ScheduleView::Iterator::operator++()
+{
+    ++position;
+    return *this;
+}
+
+ScheduleView::Iterator ScheduleView::Iterator::operator++(int)
+{
+    Iterator previous = *this;
+    ++position;
+    return previous;
+}
+
+bool ScheduleView::Iterator::operator==(const Iterator &other) const
+{
+    return view == other.view && position == other.position;
+}
+
+bool ScheduleView::Iterator::operator!=(const Iterator &other) const
+{
+    return !(*this == other);
+}
+
+ScheduleView::ScheduleView() : schedules(nullptr), allRows(false) {}
+
+ScheduleView::ScheduleView(const vector<Schedule> &schedules)
+    : schedules(&schedules), allRows(true) {}
+
+ScheduleView::ScheduleView(const vector<Schedule> &schedules, ScheduleStore::RowList rows)
+    : schedules(&schedules), rows(move(rows)), allRows(false) {}
+
+size_t ScheduleView::size() const
+{
+    if (!schedules)
+    {
+        return 0;
+    }
+    return allRows ? schedules->size() : rows.size();
+}
+
+bool ScheduleView::empty() const
+{
+    return size() == 0;
+}
+
+const Schedule &ScheduleView::operator[](size_t position) const
+{
+    return (*schedules)[allRows ? position : rows[position]];
+}
+
+ScheduleView::Iterator ScheduleView::begin() const
+{
+    return Iterator(this, 0);
+}
+
+ScheduleView::Iterator ScheduleView::end() const
+{
+    return Iterator(this, size());
+}
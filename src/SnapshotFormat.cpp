@@ -0,0 +1,43 @@
+﻿#include "../include/SnapshotFormat.h"
+#include <filesystem>
+
+using namespace std;
+
+bool SnapshotFormat::stampFile(const string &filename, SourceStamp &stamp)
+{
+    error_code error;
+    uintmax_t size = filesystem::file_size(filename, error);
+    if (error)
+    {
+        return false;
+    }
+    auto modified = filesystem::last_write_time(filename, error);
+    if (error)
+    {
+        return false;
+    }
+
+    stamp.size = static_cast<uint64_t>(size);
+    stamp.modified = static_cast<int64_t>(modified.time_since_epoch().count());
+    return true;
+}
+
+uint64_t SnapshotFormat::checksum(string_view bytes)
+{
+    const uint64_t prime = 1099511628211ULL;
+    uint64_t hash = 14695981039346656037ULL;
+    size_t i = 0;
+
+    for (; i + 8 <= bytes.size(); i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, bytes.data() + i, 8);
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < bytes.size(); ++i)
+    {
+        hash = (hash ^ static_cast<unsigned char>(bytes[i])) * prime;
+    }
+
+    return hash;
+}
@@ -0,0 +1,148 @@
+﻿#include "../include/StartupLoader.h"
+#include "../include/DataLoader.h"
+#include "../include/DataSaver.h"
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+using namespace std;
+
+struct LoadOutput
+{
+    string messages;
+    string errors;
+    double milliseconds;
+};
+
+// Runs load on its own thread with loader output captured, so the
+// caller can print it in a deterministic order after joining.
+template <typename T, typename LoadFn>
+static future<LoadOutput> startLoad(vector<T> &target, const string &filename, LoadFn load, LoadArena *arena)
+{
+    return async(launch::async, [&target, filename, load, arena]()
+                 {
+        ostringstream messages;
+        ostringstream errors;
+        DataLoader::redirectOutput(&messages, &errors);
+        LoadArena::Scope scope(arena);
+
+        auto start = chrono::steady_clock::now();
+        target = load(filename);
+        auto end = chrono::steady_clock::now();
+
+        DataLoader::redirectOutput(nullptr, nullptr);
+        return LoadOutput{messages.str(), errors.str(),
+                          chrono::duration<double, milli>(end - start).count()}; });
+}
+
+StartupLoader::StartupLoader(const string &buses, const string &drivers, const string &routes,
+                             const string &schedules, const string &credentials)
+    : busesFile(buses), driversFile(drivers), routesFile(routes),
+      schedulesFile(schedules), credentialsFile(credentials), arenaLoading(false), totalMilliseconds(0) {}
+
+void StartupLoader::setSnapshotFile(const string &filename)
+{
+    snapshotFile = filename;
+}
+
+void StartupLoader::setArenaLoading(bool enabled)
+{
+    arenaLoading = enabled;
+}
+
+vector<string> StartupLoader::getSourceFiles() const
+{
+    return {busesFile, driversFile, routesFile, schedulesFile, credentialsFile};
+}
+
+SystemData StartupLoader::loadAll()
+{
+    SystemData data;
+    auto start = chrono::steady_clock::now();
+    timings.clear();
+
+    // Handed to data only on success: a rejected snapshot's entities are
+    // destroyed inside loadSnapshot, while the arena is still alive.
+    unique_ptr<LoadArena> snapshotArena = arenaLoading ? make_unique<LoadArena>() : nullptr;
+    bool fromSnapshot = false;
+    if (!snapshotFile.empty())
+    {
+        LoadArena::Scope scope(snapshotArena.get());
+        fromSnapshot = DataLoader::loadSnapshot(snapshotFile, getSourceFiles(), data);
+    }
+
+    if (fromSnapshot)
+    {
+        if (snapshotArena)
+        {
+            data.arenas.push_back(move(snapshotArena));
+        }
+        auto end = chrono::steady_clock::now();
+        totalMilliseconds = chrono::duration<double, milli>(end - start).count();
+        timings.push_back({snapshotFile, totalMilliseconds});
+        return data;
+    }
+
+    // One region per file. Schedules and users have no arena-backed
+    // fields, so their arenas stay empty and never touch the heap.
+    LoadArena *arenas[5] = {};
+    if (arenaLoading)
+    {
+        for (LoadArena *&arena : arenas)
+        {
+            data.arenas.push_back(make_unique<LoadArena>());
+            arena = data.arenas.back().get();
+        }
+    }
+
+    future<LoadOutput> pending[] = {
+        startLoad(data.buses, busesFile, DataLoader::loadBuses, arenas[0]),
+        startLoad(data.drivers, driversFile, DataLoader::loadDrivers, arenas[1]),
+        startLoad(data.routes, routesFile, DataLoader::loadRoutes, arenas[2]),
+        startLoad(data.schedules, schedulesFile, DataLoader::loadSchedules, arenas[3]),
+        startLoad(data.users, credentialsFile, DataLoader::loadCredentials, arenas[4])};
+    const string filenames[] = {busesFile, driversFile, routesFile, schedulesFile, credentialsFile};
+
+    LoadOutput outputs[5];
+    for (int i = 0; i < 5; ++i)
+    {
+        outputs[i] = pending[i].get();
+    }
+
+    auto end = chrono::steady_clock::now();
+    totalMilliseconds = chrono::duration<double, milli>(end - start).count();
+
+    for (int i = 0; i < 5; ++i)
+    {
+        cerr << outputs[i].errors;
+        cout << outputs[i].messages;
+        timings.push_back({filenames[i], outputs[i].milliseconds});
+    }
+
+    if (!snapshotFile.empty())
+    {
+        DataSaver::saveSnapshot(snapshotFile, data, getSourceFiles());
+    }
+
+    return data;
+}
+
+void StartupLoader::displayTimings() const
+{
+    ios::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+
+    cout << "\nStartup load times:" << endl;
+    for (const auto &timing : timings)
+    {
+        cout << "  " << left << setw(30) << timing.filename
+             << right << fixed << setprecision(2) << setw(10) << timing.milliseconds << " ms" << endl;
+    }
+    cout << "  " << left << setw(30) << "Total (wall clock)"
+         << right << fixed << setprecision(2) << setw(10) << totalMilliseconds << " ms" << endl;
+    cout.flags(flags);
+    cout.precision(precision);
+}
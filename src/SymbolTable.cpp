@@ -0,0 +1,121 @@
+﻿#include "../include/SymbolTable.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+// Strings live in fixed-size blocks reached through a static directory, so a
+// handle resolves with two loads and no lock. Blocks are allocated on first
+// use and never freed.
+static constexpr size_t BLOCK_BITS = 14;
+static constexpr size_t BLOCK_SIZE = size_t(1) << BLOCK_BITS;
+static constexpr size_t MAX_BLOCKS = (size_t(1) << 32) / BLOCK_SIZE;
+
+static atomic<string *> blocks[MAX_BLOCKS];
+static atomic<uint32_t> nextSymbol(0);
+static atomic<size_t> outOfLineBytes(0);
+
+// Lookups are split across shards by hash so parallel loaders rarely
+// contend on the same mutex.
+static constexpr size_t SHARD_COUNT = 64;
+
+struct Shard
+{
+    mutex lock;
+    unordered_map<string_view, Symbol> symbols;
+};
+
+static Shard *shards()
+{
+    static Shard *table = []()
+    {
+        Shard *created = new Shard[SHARD_COUNT];
+        // Reserve handle 0 for the empty string before anything else.
+        string *first = new string[BLOCK_SIZE];
+        blocks[0].store(first, memory_order_release);
+        nextSymbol.store(1, memory_order_relaxed);
+        created[hash<string_view>()(string_view()) % SHARD_COUNT].symbols.emplace(string_view(first[0]), 0);
+        return created;
+    }();
+    return table;
+}
+
+static string &slotFor(Symbol symbol)
+{
+    atomic<string *> &entry = blocks[symbol >> BLOCK_BITS];
+    string *block = entry.load(memory_order_acquire);
+    if (!block)
+    {
+        string *created = new string[BLOCK_SIZE];
+        if (entry.compare_exchange_strong(block, created, memory_order_acq_rel))
+        {
+            block = created;
+        }
+        else
+        {
+            delete[] created;
+        }
+    }
+    return block[symbol & (BLOCK_SIZE - 1)];
+}
+
+Symbol SymbolTable::intern(string_view text)
+{
+    size_t hashValue = hash<string_view>()(text);
+    Shard &shard = shards()[hashValue % SHARD_COUNT];
+    lock_guard<mutex> guard(shard.lock);
+
+    auto found = shard.symbols.find(text);
+    if (found != shard.symbols.end())
+    {
+        return found->second;
+    }
+
+    Symbol symbol = nextSymbol.fetch_add(1, memory_order_relaxed);
+    string &slot = slotFor(symbol);
+    slot.assign(text.data(), text.size());
+    if (slot.capacity() > string().capacity())
+    {
+        outOfLineBytes.fetch_add(slot.capacity() + 1, memory_order_relaxed);
+    }
+    shard.symbols.emplace(string_view(slot), symbol);
+    return symbol;
+}
+
+bool SymbolTable::find(string_view text, Symbol &symbol)
+{
+    Shard &shard = shards()[hash<string_view>()(text) % SHARD_COUNT];
+    lock_guard<mutex> guard(shard.lock);
+
+    auto found = shard.symbols.find(text);
+    if (found == shard.symbols.end())
+    {
+        return false;
+    }
+    symbol = found->second;
+    return true;
+}
+
+const string &SymbolTable::name(Symbol symbol)
+{
+    shards();
+    return blocks[symbol >> BLOCK_BITS].load(memory_order_acquire)[symbol & (BLOCK_SIZE - 1)];
+}
+
+size_t SymbolTable::size()
+{
+    shards();
+    return nextSymbol.load(memory_order_relaxed);
+}
+
+size_t SymbolTable::memoryUsage()
+{
+    size_t count = size();
+    size_t blockCount = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    // Hash node (key, value, next pointer, cached hash) plus one bucket pointer.
+    size_t entryBytes = sizeof(string_view) + sizeof(Symbol) + 2 * sizeof(void *) + sizeof(size_t) + sizeof(void *);
+    return blockCount * BLOCK_SIZE * sizeof(string) + outOfLineBytes.load(memory_order_relaxed) +
+           count * entryBytes;
+}
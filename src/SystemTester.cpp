@@ -1,7 +1,30 @@
 ﻿#include "../include/SystemTester.h"
+#include "../include/AssignmentPlanner.h"
 #include "../include/DataLoader.h"
+#include "../include/DataSaver.h"
+#include "../include/AvailabilityIndex.h"
+#include "../include/DepartureBoard.h"
+#include "../include/StartupLoader.h"
+#include "../include/FixedId.h"
+#include "../include/FlushScheduler.h"
+#include "../include/IntervalIndex.h"
+#include "../include/JourneyPlanner.h"
+#include "../include/ScanKernels.h"
+#include "../include/SnapshotFormat.h"
+#include "../include/SymbolTable.h"
+#include "../include/TimetableAudit.h"
+#include "../include/Transaction.h"
+#include "../include/TravelTimeMatrix.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <random>
+#include <sstream>
+#include <thread>
 
 using namespace std;
 
@@ -56,6 +79,266 @@ bool SystemTester::testDataLoading()
     vector<Bus> emptyBuses = DataLoader::loadBuses("data/nonexistent.txt");
     logTest("Handle missing file gracefully", emptyBuses.size() == 0);
 
+    DataLoader::setLoadMode(LoadMode::MAPPED);
+    vector<Route> mappedRoutes = DataLoader::loadRoutes("data/routes.txt");
+    vector<Schedule> mappedSchedules = DataLoader::loadSchedules("data/schedules.txt");
+    vector<Bus> mappedMissing = DataLoader::loadBuses("data/nonexistent.txt");
+    DataLoader::setLoadMode(LoadMode::STREAM);
+
+    bool routesMatch = mappedRoutes.size() == routes.size();
+    for (size_t i = 0; routesMatch && i < routes.size(); ++i)
+    {
+        routesMatch = mappedRoutes[i].getId() == routes[i].getId() &&
+                      mappedRoutes[i].getStopsAsString() == routes[i].getStopsAsString() &&
+                      mappedRoutes[i].getEstimatedTravelTime() == routes[i].getEstimatedTravelTime();
+    }
+    logTest("Mapped loader matches stream loader (routes)", routesMatch);
+
+    bool schedulesMatch = mappedSchedules.size() == schedules.size();
+    for (size_t i = 0; schedulesMatch && i < schedules.size(); ++i)
+    {
+        schedulesMatch = mappedSchedules[i].getId() == schedules[i].getId() &&
+                         mappedSchedules[i].getArrivalTime() == schedules[i].getArrivalTime();
+    }
+    logTest("Mapped loader matches stream loader (schedules)", schedulesMatch);
+    logTest("Mapped loader handles missing file", mappedMissing.empty());
+
+    ofstream parallelFile("data/parallel_test.txt");
+    parallelFile << "P001,R001,B001,D101,2025-11-15,08:00,09:00\n"
+                 << "P002,R002,B002,D102,2025-11-15,10:00,12:00\n"
+                 << "\n"
+                 << "P003,R003,B003\n"
+                 << "P004,R004,B004,D104,2025-11-16,07:00,08:00\n"
+                 << "P005,R005\n"
+                 << "P006,R001,B005,D105,2025-11-16,09:00,10:00\n";
+    parallelFile.close();
+
+    stringstream parallelErrors;
+    streambuf *originalCerr = cerr.rdbuf(parallelErrors.rdbuf());
+    DataLoader::setLoadMode(LoadMode::PARALLEL);
+    DataLoader::setThreadCount(3);
+    vector<Schedule> parallelSchedules = DataLoader::loadSchedules("data/parallel_test.txt");
+    DataLoader::setThreadCount(0);
+    DataLoader::setLoadMode(LoadMode::STREAM);
+    cerr.rdbuf(originalCerr);
+    remove("data/parallel_test.txt");
+
+    bool parallelOrder = parallelSchedules.size() == 4 &&
+                         parallelSchedules[0].getId() == "P001" && parallelSchedules[1].getId() == "P002" &&
+                         parallelSchedules[2].getId() == "P004" && parallelSchedules[3].getId() == "P006";
+    logTest("Parallel loader keeps file order", parallelOrder);
+
+    string errorText = parallelErrors.str();
+    bool parallelLines = errorText.find("at line 4:") != string::npos &&
+                         errorText.find("at line 6:") != string::npos;
+    logTest("Parallel loader reports correct line numbers", parallelLines);
+
+    // Files saved on Windows end their lines with CRLF.
+    ofstream crlfSchedules("data/crlf_schedules.txt", ios::binary);
+    crlfSchedules << "C001,R001,B001,D101,2025-11-15,08:00,09:00\r\n"
+                  << "\r\n"
+                  << "C002,R002,B002,D102,2025-11-15,10:00,12:00\r\n";
+    crlfSchedules.close();
+    ofstream crlfCredentials("data/crlf_credentials.txt", ios::binary);
+    crlfCredentials << "admin,admin123,Admin\r\n";
+    crlfCredentials.close();
+
+    bool crlfLoads = true;
+    for (LoadMode mode : {LoadMode::STREAM, LoadMode::MAPPED, LoadMode::PARALLEL})
+    {
+        DataLoader::setLoadMode(mode);
+        vector<Schedule> crlfRows = DataLoader::loadSchedules("data/crlf_schedules.txt");
+        vector<User> crlfUsers = DataLoader::loadCredentials("data/crlf_credentials.txt");
+        crlfLoads = crlfLoads && crlfRows.size() == 2 && crlfRows[1].getArrivalTime() == "12:00" &&
+                    crlfUsers.size() == 1 && crlfUsers[0].getRole() == UserRole::ADMIN;
+    }
+    DataLoader::setLoadMode(LoadMode::STREAM);
+    remove("data/crlf_schedules.txt");
+    remove("data/crlf_credentials.txt");
+    logTest("Every load mode reads CRLF files", crlfLoads);
+
+    // A row with a bad date is kept by every mode, and its file is not
+    // rewritten (dropping the row) until the row is fixed or removed.
+    const string malformedFile = "data/malformed_schedules.txt";
+    const string malformedText = "M001,R001,B001,D101,2025-02-30,08:00,09:00\n"
+                                 "M002,R002,B002,D102,2025-11-15,10:00,12:00\n";
+    ofstream malformed(malformedFile);
+    malformed << malformedText;
+    malformed.close();
+
+    stringstream malformedErrors;
+    DataLoader::redirectOutput(nullptr, &malformedErrors);
+    bool sameRule = true;
+    for (LoadMode mode : {LoadMode::STREAM, LoadMode::MAPPED, LoadMode::PARALLEL})
+    {
+        DataLoader::setLoadMode(mode);
+        vector<Schedule> rows = DataLoader::loadSchedules(malformedFile);
+        sameRule = sameRule && rows.size() == 2 && rows[0].getId() == "M001" &&
+                   rows[0].getDay() == Schedule::INVALID_DAY && rows[1].getDate() == "2025-11-15";
+    }
+    DataLoader::setLoadMode(LoadMode::STREAM);
+    DataLoader::redirectOutput(nullptr, nullptr);
+    logTest("Every load mode keeps rows with a malformed date",
+            sameRule && malformedErrors.str().find("Invalid date '2025-02-30'") != string::npos);
+
+    auto fileText = [](const string &filename)
+    {
+        ifstream file(filename);
+        stringstream text;
+        text << file.rdbuf();
+        return text.str();
+    };
+    bool keptOnDisk = false;
+    bool rewrittenOnceFixed = false;
+    {
+        vector<Schedule> rows = DataLoader::loadSchedules(malformedFile);
+        vector<Route> noRoutes;
+        vector<Bus> noBuses;
+        vector<Driver> noDrivers;
+        ScheduleManager manager(rows, noRoutes, noBuses, noDrivers, malformedFile);
+        manager.setCompactionThreshold(1);
+        manager.removeSchedule("M002");
+        keptOnDisk = manager.unreadableRows() == 1 && fileText(malformedFile) == malformedText &&
+                     !manager.saveToFile() && fileText(malformedFile + ".log").find("M002") != string::npos;
+        manager.removeSchedule("M001");
+        rewrittenOnceFixed = manager.unreadableRows() == 0 && fileText(malformedFile).empty() &&
+                             fileText(malformedFile + ".log").empty();
+    }
+    remove(malformedFile.c_str());
+    remove((malformedFile + ".log").c_str());
+    logTest("Unreadable rows block rewriting the data file", keptOnDisk && rewrittenOnceFixed);
+
+    // IDs too long for EntityId are refused by every mode with the same message.
+    const string longId(EntityId::CAPACITY + 1, 'L');
+    ofstream longRoutes("data/long_id_routes.txt");
+    longRoutes << longId << ",A,B,,30\nLR1,A,B,,30\n";
+    longRoutes.close();
+    ofstream longSchedules("data/long_id_schedules.txt");
+    longSchedules << longId << ",R1,B1,D1,2025-11-15,08:00,09:00\nLS1,R1,B1,D1,2025-11-15,08:00,09:00\n";
+    longSchedules.close();
+
+    stringstream longErrors;
+    DataLoader::redirectOutput(nullptr, &longErrors);
+    bool longRefused = true;
+    for (LoadMode mode : {LoadMode::STREAM, LoadMode::MAPPED})
+    {
+        DataLoader::setLoadMode(mode);
+        vector<Route> routeRows = DataLoader::loadRoutes("data/long_id_routes.txt");
+        vector<Schedule> scheduleRows = DataLoader::loadSchedules("data/long_id_schedules.txt");
+        longRefused = longRefused && routeRows.size() == 1 && routeRows[0].getId() == "LR1" &&
+                      scheduleRows.size() == 1 && scheduleRows[0].getId() == "LS1";
+    }
+    DataLoader::setLoadMode(LoadMode::STREAM);
+    DataLoader::redirectOutput(nullptr, nullptr);
+    remove("data/long_id_routes.txt");
+    remove("data/long_id_schedules.txt");
+    string longMessage = "ID '" + longId + "' is longer than";
+    size_t mentions = 0;
+    for (size_t at = longErrors.str().find(longMessage); at != string::npos;
+         at = longErrors.str().find(longMessage, at + 1))
+    {
+        mentions++;
+    }
+    logTest("Every load mode refuses IDs that do not fit", longRefused && mentions == 4);
+
+    StartupLoader startupLoader("data/buses.txt", "data/drivers.txt", "data/routes.txt",
+                                "data/schedules.txt", "data/credentials.txt");
+    SystemData concurrent = startupLoader.loadAll();
+    logTest("Concurrent startup loads every file",
+            concurrent.buses.size() == buses.size() && concurrent.drivers.size() == drivers.size() &&
+                concurrent.routes.size() == routes.size() && concurrent.schedules.size() == schedules.size() &&
+                concurrent.users.size() == users.size());
+
+    // Assigning over arena-loaded data must not free its arenas before its entities.
+    startupLoader.setArenaLoading(true);
+    SystemData arenaLoaded = startupLoader.loadAll();
+    arenaLoaded = startupLoader.loadAll();
+    startupLoader.setArenaLoading(false);
+    bool arenaMatches = arenaLoaded.arenas.size() == 5 && arenaLoaded.drivers.size() == concurrent.drivers.size() &&
+                        arenaLoaded.routes.size() == concurrent.routes.size() &&
+                        (concurrent.routes.empty() || arenaLoaded.arenas[2]->reservedBytes() > 0);
+    for (size_t i = 0; arenaMatches && i < concurrent.drivers.size(); ++i)
+    {
+        arenaMatches = DataSaver::formatDriver(arenaLoaded.drivers[i]) == DataSaver::formatDriver(concurrent.drivers[i]);
+    }
+    for (size_t i = 0; arenaMatches && i < concurrent.routes.size(); ++i)
+    {
+        arenaMatches = DataSaver::formatRoute(arenaLoaded.routes[i]) == DataSaver::formatRoute(concurrent.routes[i]);
+    }
+    logTest("Arena loading matches heap loading", arenaMatches);
+
+    // An update copies the entity off its arena; assigning in place would
+    // take new arena space for every update and free none of it.
+    const string arenaFile = "data/arena_drivers.txt";
+    bool updatesOffArena = false;
+    {
+        LoadArena arena;
+        vector<Driver> arenaDrivers;
+        {
+            LoadArena::Scope scope(&arena);
+            arenaDrivers.emplace_back("AD1", "Arena Driver", "555-0100", "Class A");
+        }
+        size_t reserved = arena.reservedBytes();
+        DriverManager arenaManager(arenaDrivers, arenaFile);
+        for (char mark = 'a'; mark <= 'h'; ++mark)
+        {
+            arenaManager.updateDriver("AD1", Driver("AD1", string(100000, mark), "555-0100", "Class A"));
+        }
+        updatesOffArena = arena.reservedBytes() == reserved &&
+                          arenaManager.findDriver("AD1")->getName() == string(100000, 'h');
+    }
+    remove(arenaFile.c_str());
+    remove((arenaFile + ".log").c_str());
+    logTest("Updates move arena-loaded entities to the heap", updatesOffArena);
+
+    ofstream snapshotSource("data/snapshot_source.txt");
+    snapshotSource << "source\n";
+    snapshotSource.close();
+    vector<string> snapshotSources = {"data/snapshot_source.txt"};
+
+    bool snapshotSaved = DataSaver::saveSnapshot("data/test_snapshot.bin", concurrent, snapshotSources);
+    SystemData restored;
+    bool snapshotLoaded = DataLoader::loadSnapshot("data/test_snapshot.bin", snapshotSources, restored);
+    bool snapshotMatches = snapshotSaved && snapshotLoaded &&
+                           restored.buses.size() == concurrent.buses.size() &&
+                           restored.schedules.size() == concurrent.schedules.size() &&
+                           restored.routes.size() == concurrent.routes.size() &&
+                           restored.users.size() == concurrent.users.size();
+    for (size_t i = 0; snapshotMatches && i < concurrent.routes.size(); ++i)
+    {
+        snapshotMatches = restored.routes[i].getStopsAsString() == concurrent.routes[i].getStopsAsString() &&
+                          restored.routes[i].getEstimatedTravelTime() == concurrent.routes[i].getEstimatedTravelTime();
+    }
+    for (size_t i = 0; snapshotMatches && i < concurrent.buses.size(); ++i)
+    {
+        snapshotMatches = restored.buses[i].getId() == concurrent.buses[i].getId() &&
+                          restored.buses[i].getCapacity() == concurrent.buses[i].getCapacity();
+    }
+    logTest("Binary snapshot round-trips all entities", snapshotMatches);
+
+    fstream corrupt("data/test_snapshot.bin", ios::in | ios::out | ios::binary);
+    corrupt.seekp(-1, ios::end);
+    corrupt.put('\x7f');
+    corrupt.close();
+    SystemData rejected;
+    logTest("Reject snapshot with bad checksum",
+            !DataLoader::loadSnapshot("data/test_snapshot.bin", snapshotSources, rejected));
+
+    DataSaver::saveSnapshot("data/test_snapshot.bin", concurrent, snapshotSources);
+    ofstream touchSource("data/snapshot_source.txt", ios::app);
+    touchSource << "changed\n";
+    touchSource.close();
+    logTest("Reject snapshot older than its source files",
+            !DataLoader::loadSnapshot("data/test_snapshot.bin", snapshotSources, rejected));
+
+    remove("data/test_snapshot.bin");
+    remove("data/snapshot_source.txt");
+
+    vector<string_view> fields(4);
+    size_t fieldCount = DataLoader::splitFields("a,,b,", fields.data(), fields.size());
+    logTest("splitFields matches splitCSV field count",
+            fieldCount == DataLoader::splitCSV("a,,b,").size() && fields[1].empty() && fields[2] == "b");
+
     return true;
 }
 
@@ -104,6 +387,191 @@ bool SystemTester::testBusValidation(BusManager &busManager)
     return true;
 }
 
+bool SystemTester::testOperationLog(BusManager &busManager)
+{
+    printTestHeader("OPERATION LOG TESTS");
+
+    uintmax_t baseSize = filesystem::file_size("data/buses.txt");
+
+    Bus loggedBus("WAL_B001", 42, "Log Model", "Active");
+    bool added = busManager.addBus(loggedBus);
+    bool baseUntouched = filesystem::file_size("data/buses.txt") == baseSize;
+    logTest("Mutation appends to log without rewriting data file",
+            added && baseUntouched && filesystem::exists("data/buses.txt.log"));
+
+    vector<Bus> reloaded = DataLoader::loadBuses("data/buses.txt");
+    BusManager replayManager(reloaded, "data/buses.txt");
+    logTest("Replay applies logged changes at load", replayManager.findBus("WAL_B001") != nullptr);
+
+    loggedBus.setCapacity(44);
+    busManager.updateBus("WAL_B001", loggedBus);
+    busManager.removeBus("WAL_B001");
+    bool compacted = busManager.compact();
+    vector<Bus> afterCompaction = DataLoader::loadBuses("data/buses.txt");
+    bool folded = none_of(afterCompaction.begin(), afterCompaction.end(),
+                          [](const Bus &b)
+                          { return b.getId() == "WAL_B001"; });
+    logTest("Compaction folds log into data file",
+            compacted && folded && !filesystem::exists("data/buses.txt.log"));
+
+    // A crash after compaction rewrote the file but before it trimmed the
+    // log: "U A->B, A A" must not run again over a file that holds both.
+    const string crashFile = "data/crash_buses.txt";
+    Bus renamed("CR_B", 30, "Renamed", "Active");
+    Bus readded("CR_A", 50, "Readded", "Active");
+    string foldedContents = DataSaver::formatBuses({renamed, readded});
+    auto writeCrashFiles = [&](const string &base)
+    {
+        ofstream(crashFile, ios::binary) << base;
+        ofstream(crashFile + ".log", ios::binary)
+            << "U\tCR_A\t" << DataSaver::formatBus(renamed) << "\n"
+            << "A\tCR_A\t" << DataSaver::formatBus(readded) << "\n"
+            << "C\t" << SnapshotFormat::checksum(foldedContents) << "\t\n";
+    };
+    auto replaysCleanly = [&]()
+    {
+        vector<Bus> crashBuses = DataLoader::loadBuses(crashFile);
+        BusManager crashManager(crashBuses, crashFile);
+        const Bus *a = crashManager.findBus("CR_A");
+        const Bus *b = crashManager.findBus("CR_B");
+        return crashBuses.size() == 2 && a && a->getCapacity() == 50 && b && b->getCapacity() == 30;
+    };
+    writeCrashFiles(foldedContents);
+    bool skipsFolded = replaysCleanly();
+    writeCrashFiles("");
+    bool replaysUnfolded = replaysCleanly();
+    remove(crashFile.c_str());
+    remove((crashFile + ".log").c_str());
+    logTest("Replay skips entries the data file already holds", skipsFolded && replaysUnfolded);
+
+    // Removals, a rename and re-adds, replayed in one pass over the list.
+    const string orderFile = "data/replay_order_buses.txt";
+    auto orderBus = [](const string &id)
+    { return DataSaver::formatBus(Bus(id, 40, "Order", "Active")); };
+    ofstream(orderFile, ios::binary) << orderBus("RO_1") << "\n"
+                                     << orderBus("RO_2") << "\n"
+                                     << orderBus("RO_3") << "\n"
+                                     << orderBus("RO_4") << "\n";
+    ofstream(orderFile + ".log", ios::binary) << "R\tRO_2\t\n"
+                                              << "U\tRO_3\t" << orderBus("RO_5") << "\n"
+                                              << "A\tRO_6\t" << orderBus("RO_6") << "\n"
+                                              << "R\tRO_1\t\n"
+                                              << "A\tRO_2\t" << orderBus("RO_2") << "\n";
+    bool ordered = false;
+    {
+        vector<Bus> orderBuses = DataLoader::loadBuses(orderFile);
+        BusManager orderManager(orderBuses, orderFile);
+        vector<string> ids;
+        for (const auto &bus : orderBuses)
+        {
+            ids.push_back(bus.getId().str());
+        }
+        ordered = ids == vector<string>{"RO_5", "RO_4", "RO_6", "RO_2"} && orderManager.findBus("RO_3") == nullptr;
+    }
+    remove(orderFile.c_str());
+    remove((orderFile + ".log").c_str());
+    logTest("Replay keeps row order through renames and removals", ordered);
+
+    // Changes logged while compaction writes the file outlive the trim.
+    const string trimFile = "data/trim_test.log";
+    bool keptTail = false;
+    {
+        OperationLog trimLog(trimFile);
+        trimLog.append('A', "TR_B001", "TR_B001,40,Trim,Active");
+        trimLog.checkpoint("TR_B001,40,Trim,Active\n");
+        trimLog.append('R', "TR_B001");
+        vector<LogEntry> kept = trimLog.trimToCheckpoint() ? trimLog.readEntries() : vector<LogEntry>();
+        keptTail = kept.size() == 1 && kept[0].operation == 'R' && trimLog.size() == 1;
+    }
+    remove(trimFile.c_str());
+    logTest("Compaction keeps entries logged after its checkpoint", keptTail);
+
+    return true;
+}
+
+bool SystemTester::testGroupCommit()
+{
+    printTestHeader("GROUP COMMIT TESTS");
+
+    const string flushFile = "data/flush_test_buses.txt";
+    vector<Bus> flushBuses;
+    BusManager flushManager(flushBuses, flushFile);
+
+    {
+        // Long window: nothing is written until the barrier.
+        FlushScheduler flusher(60000);
+        flushManager.setCompactionThreshold(3);
+        flushManager.attachFlusher(flusher);
+
+        flushManager.addBus(Bus("GC_B001", 40, "Commit Model", "Active"));
+        flushManager.addBus(Bus("GC_B002", 40, "Commit Model", "Active"));
+        flushManager.updateBus("GC_B001", Bus("GC_B001", 45, "Commit Model", "Active"));
+        logTest("Mutations wait for the commit window",
+                flusher.getWriteCount() == 0 && flusher.pendingCount() == 1 && !filesystem::exists(flushFile));
+
+        bool flushed = flusher.flush();
+        vector<Bus> written = DataLoader::loadBuses(flushFile);
+        logTest("Flush barrier compacts a log that reached the threshold",
+                flushed && flusher.getWriteCount() == 1 && written.size() == 2 &&
+                    !filesystem::exists(flushFile + ".log") && !filesystem::exists(flushFile + ".tmp"));
+
+        // Below the threshold a commit only syncs the log.
+        flusher.setWindow(10);
+        flushManager.removeBus("GC_B002");
+        for (int i = 0; i < 200 && flusher.getWriteCount() < 2; ++i)
+        {
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+        vector<Bus> reloaded = DataLoader::loadBuses(flushFile);
+        BusManager reloadManager(reloaded, flushFile);
+        logTest("Background flusher syncs the log after the window",
+                flusher.getWriteCount() == 2 && DataLoader::loadBuses(flushFile).size() == 2 &&
+                    filesystem::exists(flushFile + ".log") && reloaded.size() == 1);
+    }
+
+    remove(flushFile.c_str());
+    remove((flushFile + ".log").c_str());
+    return true;
+}
+
+bool SystemTester::testIdIndex(BusManager &busManager)
+{
+    printTestHeader("ID INDEX TESTS");
+
+    busManager.addBus(Bus("IDX_B001", 30, "Index Model", "Active"));
+    busManager.addBus(Bus("IDX_B002", 30, "Index Model", "Active"));
+    busManager.addBus(Bus("IDX_B003", 30, "Index Model", "Active"));
+
+    BusManager::Handle dropped = busManager.findBusHandle("IDX_B001");
+    BusManager::Handle kept = busManager.findBusHandle("IDX_B003");
+    busManager.removeBus("IDX_B001");
+    Bus *shifted = busManager.findBus("IDX_B003");
+    logTest("Lookup follows entities shifted by removal",
+            shifted != nullptr && shifted->getId() == "IDX_B003" && !busManager.busExists("IDX_B001") &&
+                busManager.getBus(kept) == shifted);
+
+    // The new bus reuses the freed slot under a new generation.
+    busManager.addBus(Bus("IDX_B005", 30, "Index Model", "Active"));
+    logTest("Handles to removed entities are detected as stale",
+            busManager.getBus(dropped) == nullptr && !dropped.isNull() &&
+                !busManager.updateBus(dropped, Bus("IDX_B001", 30, "Index Model", "Active")) &&
+                !busManager.busExists("IDX_B001") && busManager.getBus(busManager.findBusHandle("IDX_B005")) != nullptr);
+    busManager.removeBus("IDX_B005");
+
+    bool renamed = busManager.updateBus("IDX_B002", Bus("IDX_B004", 30, "Index Model", "Active"));
+    Bus *renamedBus = busManager.findBus("IDX_B004");
+    logTest("Index follows ID change on update",
+            renamed && busManager.findBus("IDX_B002") == nullptr && renamedBus != nullptr &&
+                renamedBus->getId() == "IDX_B004");
+
+    bool rejectCollision = !busManager.updateBus("IDX_B004", Bus("IDX_B003", 30, "Index Model", "Active"));
+    logTest("Reject update onto an existing ID", rejectCollision && busManager.busExists("IDX_B004"));
+
+    busManager.removeBus("IDX_B003");
+    busManager.removeBus("IDX_B004");
+    return true;
+}
+
 bool SystemTester::testDriverValidation(DriverManager &driverManager)
 {
     printTestHeader("DRIVER VALIDATION TESTS");
@@ -187,6 +655,38 @@ bool SystemTester::testRouteValidation(RouteManager &routeManager)
     return true;
 }
 
+bool SystemTester::testRouteSearchIndexes(RouteManager &routeManager)
+{
+    printTestHeader("ROUTE SEARCH INDEX TESTS");
+
+    routeManager.addRoute(Route("IDX_R001", "Idx Origin", "Idx Terminal", {"Idx Stop A", "Idx Stop B"}, 30));
+    routeManager.addRoute(Route("IDX_R002", "Idx Depot", "Idx Terminal", {"Idx Stop B"}, 40));
+
+    vector<const Route *> byStop = routeManager.findRoutesByStop("Idx Stop B");
+    logTest("Stop search returns matches in list order",
+            byStop.size() == 2 && byStop[0]->getId() == "IDX_R001" && byStop[1]->getId() == "IDX_R002");
+
+    vector<const Route *> byOrigin = routeManager.findRoutesByOrigin("Idx Origin");
+    vector<const Route *> byDestination = routeManager.findRoutesByDestination("Idx Terminal");
+    logTest("Origin and destination searches use their indexes",
+            byOrigin.size() == 1 && byOrigin[0] == routeManager.findRoute("IDX_R001") &&
+                byDestination.size() == 2);
+
+    routeManager.updateRoute("IDX_R001", Route("IDX_R001", "Idx Origin", "Idx Terminal", {"Idx Stop C"}, 30));
+    logTest("Update moves a route between stop entries",
+            routeManager.findRoutesByStop("Idx Stop A").empty() &&
+                routeManager.findRoutesByStop("Idx Stop B").size() == 1 &&
+                routeManager.findRoutesByStop("Idx Stop C").size() == 1);
+
+    routeManager.removeRoute("IDX_R001");
+    routeManager.removeRoute("IDX_R002");
+    logTest("Remove clears index entries",
+            routeManager.findRoutesByStop("Idx Stop B").empty() &&
+                routeManager.findRoutesByDestination("Idx Terminal").empty());
+
+    return true;
+}
+
 bool SystemTester::testScheduleValidation(ScheduleManager &scheduleManager)
 {
     printTestHeader("SCHEDULE VALIDATION TESTS");
@@ -224,6 +724,138 @@ bool SystemTester::testScheduleValidation(ScheduleManager &scheduleManager)
     return true;
 }
 
+bool SystemTester::testScheduleEncoding()
+{
+    printTestHeader("SCHEDULE ENCODING TESTS");
+
+    bool roundTrip = true;
+    int32_t first = Schedule::parseDate("1999-12-31");
+    int32_t last = Schedule::parseDate("2101-01-01");
+    for (int32_t day = first; day <= last && roundTrip; ++day)
+    {
+        roundTrip = Schedule::parseDate(Schedule::formatDate(day)) == day;
+    }
+    logTest("Day numbers round-trip through YYYY-MM-DD",
+            roundTrip && last - first == 36891 && Schedule::parseDate("1970-01-01") == 0);
+
+    logTest("Reject impossible dates",
+            Schedule::parseDate("2025-02-29") == Schedule::INVALID_DAY &&
+                Schedule::parseDate("2025-13-01") == Schedule::INVALID_DAY &&
+                Schedule::parseDate("2025-1-01") == Schedule::INVALID_DAY &&
+                Schedule::parseDate("2024-02-29") != Schedule::INVALID_DAY);
+
+    logTest("Parse times to minutes since midnight",
+            Schedule::parseTime("09:05") == 545 && Schedule::parseTime("9:05") == 545 &&
+                Schedule::parseTime("23:59") == 1439 && Schedule::parseTime("24:00") == Schedule::INVALID_TIME &&
+                Schedule::parseTime("9:5") == Schedule::INVALID_TIME && Schedule::formatTime(545) == "09:05");
+
+    // Lexicographic comparison put "9:30" after "10:00".
+    Schedule early("ENC_S1", "R1", "B1", "D1", "2025-12-01", "9:30", "10:30");
+    Schedule late("ENC_S2", "R1", "B1", "D1", "2025-12-01", "10:00", "11:00");
+    logTest("Overlap compares times numerically", early.hasTimeOverlap(late) && late.hasTimeOverlap(early));
+
+    Schedule parsed;
+    string error;
+    bool badDate = DataLoader::parseScheduleRecord("S1,R1,B1,D1,2025-02-30,08:00,09:00", parsed, error) &&
+                   !error.empty() && parsed.getDay() == Schedule::INVALID_DAY;
+    bool badTime = DataLoader::parseScheduleRecord("S1,R1,B1,D1,2025-02-28,8am,09:00", parsed, error) &&
+                   !error.empty() && parsed.getDepartureMinutes() == Schedule::INVALID_TIME;
+    logTest("Loader flags malformed dates and times",
+            badDate && badTime && DataLoader::parseScheduleRecord("S1,R1,B1,D1,2025-02-28,08:00,09:00", parsed, error) &&
+                error.empty() && parsed.getDate() == "2025-02-28" && parsed.getArrivalTime() == "09:00");
+
+    return true;
+}
+
+bool SystemTester::testSymbolTable()
+{
+    printTestHeader("SYMBOL TABLE TESTS");
+
+    Symbol first = SymbolTable::intern("SYM_A");
+    logTest("Equal strings share one handle",
+            SymbolTable::intern(string("SYM_A")) == first && SymbolTable::intern("SYM_B") != first &&
+                SymbolTable::name(first) == "SYM_A" && SymbolTable::intern("") == SymbolTable::EMPTY);
+
+    size_t before = SymbolTable::size();
+    Symbol missing;
+    logTest("Find does not intern", !SymbolTable::find("SYM_NEVER_INTERNED", missing) &&
+                                        SymbolTable::size() == before && SymbolTable::find("SYM_A", missing) &&
+                                        missing == first);
+
+    // The parallel loader interns from several threads at once.
+    const size_t threadCount = 8;
+    const size_t nameCount = 2000;
+    vector<vector<Symbol>> handles(threadCount, vector<Symbol>(nameCount));
+    vector<thread> workers;
+    for (size_t t = 0; t < threadCount; ++t)
+    {
+        workers.emplace_back([&handles, t, nameCount]()
+                             {
+            for (size_t i = 0; i < nameCount; ++i)
+            {
+                size_t n = (i * 7 + t * 131) % nameCount;
+                handles[t][n] = SymbolTable::intern("SYM_T" + to_string(n));
+            } });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    bool agree = true;
+    for (size_t i = 0; i < nameCount && agree; ++i)
+    {
+        for (size_t t = 1; t < threadCount; ++t)
+        {
+            agree = agree && handles[t][i] == handles[0][i];
+        }
+        agree = agree && SymbolTable::name(handles[0][i]) == "SYM_T" + to_string(i);
+    }
+    logTest("Concurrent interning agrees on handles", agree);
+
+    Schedule schedule("SYM_S1", "R1", "B1", "D1", "2025-12-01", "08:00", "09:00");
+    schedule.setBusId("B2");
+    Bus bus("SYM_B1", 40, "Model", "Active");
+    Route route("SYM_R1", "A", "B", {"Stop X", "Stop Y"}, 30);
+    logTest("Entities store interned IDs",
+            schedule.getBusSymbol() == SymbolTable::intern("B2") && schedule.getBusId() == "B2" &&
+                schedule.getDriverSymbol() == SymbolTable::intern("D1") &&
+                bus.getStatusSymbol() == SymbolTable::intern("Active") &&
+                route.getKeyStopSymbols().size() == 2 && route.getKeyStops()[1] == "Stop Y" &&
+                route.getStopsAsString() == "Stop X|Stop Y");
+
+    return true;
+}
+
+bool SystemTester::testFixedId(BusManager &busManager)
+{
+    printTestHeader("FIXED ID TESTS");
+
+    EntityId id("FID_B001");
+    EntityId copy = id;
+    logTest("Fixed IDs compare and hash by value",
+            copy == id && id == EntityId(string("FID_B001")) && id != EntityId("FID_B002") &&
+                id.view() == "FID_B001" && id.size() == 8 && EntityId().empty() &&
+                hash<EntityId>()(copy) == hash<EntityId>()(EntityId("FID_B001")));
+
+    // Text past the capacity is kept truncated but never equals the prefix.
+    string longText(EntityId::CAPACITY + 5, 'X');
+    EntityId longId(longText);
+    EntityId prefix(longText.substr(0, EntityId::CAPACITY));
+    logTest("Overlong IDs are marked invalid",
+            !longId.isValid() && prefix.isValid() && longId != prefix &&
+                longId.view() == prefix.view() && !EntityId::fits(longText));
+
+    Bus bus(longText, 40, "Model", "Active");
+    Bus parsed;
+    string error;
+    logTest("Overlong IDs are rejected",
+            !busManager.addBus(bus) && !busManager.busExists(longText) &&
+                !DataLoader::parseBusRecord(longText + ",40,Model,Active", parsed, error) &&
+                error.find("longer than") != string::npos);
+
+    return true;
+}
+
 bool SystemTester::testScheduleOverlap(ScheduleManager &scheduleManager)
 {
     printTestHeader("SCHEDULE OVERLAP TESTS");
@@ -252,10 +884,601 @@ bool SystemTester::testScheduleOverlap(ScheduleManager &scheduleManager)
     bool addEdgeCase = scheduleManager.addSchedule(edgeCase);
     logTest("Allow back-to-back schedules", addEdgeCase);
 
+    Schedule moved("OVERLAP_S006", "R003", "B004", "D105", "2025-12-15", "15:00", "16:00");
+    bool updateMoved = scheduleManager.updateSchedule("OVERLAP_S006", moved);
+    Schedule reuseSlot("OVERLAP_S007", "R003", "B004", "D105", "2025-12-15", "12:00", "14:00");
+    bool addReuse = scheduleManager.addSchedule(reuseSlot);
+    logTest("Update frees the previous time slot", updateMoved && addReuse);
+
     scheduleManager.removeSchedule("OVERLAP_S001");
+    Schedule freedSlot("OVERLAP_S002", "R002", "B004", "D104", "2025-12-15", "08:00", "10:00");
+    bool addAfterRemove = scheduleManager.addSchedule(freedSlot);
+    logTest("Remove frees the time slot", addAfterRemove);
+
+    scheduleManager.removeSchedule("OVERLAP_S002");
     scheduleManager.removeSchedule("OVERLAP_S004");
     scheduleManager.removeSchedule("OVERLAP_S005");
     scheduleManager.removeSchedule("OVERLAP_S006");
+    scheduleManager.removeSchedule("OVERLAP_S007");
+
+    return true;
+}
+
+bool SystemTester::testIntervalIndex()
+{
+    printTestHeader("INTERVAL INDEX TESTS");
+
+    // Includes nested, inverted and empty intervals, which only loaded data can contain.
+    vector<Schedule> existing = {
+        Schedule("IV1", "R1", "B1", "D1", "2025-01-01", "08:00", "10:00"),
+        Schedule("IV2", "R1", "B1", "D1", "2025-01-01", "08:30", "09:00"),
+        Schedule("IV3", "R1", "B1", "D1", "2025-01-01", "10:00", "12:00"),
+        Schedule("IV4", "R1", "B1", "D1", "2025-01-01", "13:00", "12:30"),
+        Schedule("IV5", "R1", "B1", "D1", "2025-01-01", "14:00", "14:00"),
+        Schedule("IV6", "R1", "B1", "D1", "2025-01-02", "08:00", "18:00")};
+
+    IntervalIndex intervals;
+    for (const auto &schedule : existing)
+    {
+        intervals.insert(schedule.getBusSymbol(), schedule.getDay(),
+                         {schedule.getDepartureMinutes(), schedule.getArrivalMinutes(), schedule.getId()});
+    }
+
+    const vector<string> times = {"07:00", "08:00", "08:30", "09:00", "09:30", "10:00", "11:00",
+                                  "12:00", "12:30", "13:00", "14:00", "15:00"};
+    const vector<string> excludes = {"", "IV1", "IV2", "IV3", "IV4"};
+    const int32_t day = Schedule::parseDate("2025-01-01");
+    const Symbol bus = SymbolTable::intern("B1");
+    int mismatches = 0;
+
+    for (const auto &departure : times)
+    {
+        for (const auto &arrival : times)
+        {
+            Schedule query("Q", "R1", "B1", "D1", "2025-01-01", departure, arrival);
+            for (const auto &exclude : excludes)
+            {
+                bool scan = any_of(existing.begin(), existing.end(),
+                                   [&](const Schedule &s)
+                                   { return s.getId() != exclude && s.hasTimeOverlap(query); });
+                bool indexed = intervals.findOverlap(bus, day, query.getDepartureMinutes(),
+                                                     query.getArrivalMinutes(), exclude) != nullptr;
+                if (scan != indexed)
+                {
+                    mismatches++;
+                }
+            }
+        }
+    }
+    logTest("Index answers match a full scan", mismatches == 0,
+            mismatches ? to_string(mismatches) + " mismatches" : "");
+
+    bool erased = intervals.erase(bus, day, {8 * 60, 10 * 60, "IV1"});
+    logTest("Erase removes only the matching interval",
+            erased && intervals.size() == existing.size() - 1 &&
+                intervals.findOverlap(bus, day, 9 * 60 + 30, 9 * 60 + 45) == nullptr &&
+                intervals.findOverlap(bus, day, 8 * 60 + 45, 9 * 60 + 15) != nullptr);
+
+    return true;
+}
+
+bool SystemTester::testScheduleStore()
+{
+    printTestHeader("SCHEDULE STORE TESTS");
+
+    const string storeFile = "data/store_test_schedules.txt";
+    vector<Route> storeRoutes = {Route("ST_R1", "A", "B", {}, 60), Route("ST_R2", "B", "C", {}, 60)};
+    vector<Bus> storeBuses = {Bus("ST_B1", 40, "Store Model", "Active"), Bus("ST_B2", 40, "Store Model", "Active")};
+    vector<Driver> storeDrivers = {Driver("ST_D1", "Store One", "555-0101", "Class A"),
+                                   Driver("ST_D2", "Store Two", "555-0102", "Class A")};
+    vector<Schedule> storeSchedules;
+
+    {
+        ScheduleManager manager(storeSchedules, storeRoutes, storeBuses, storeDrivers, storeFile);
+        manager.addSchedule(Schedule("ST_S1", "ST_R1", "ST_B1", "ST_D1", "2026-03-10", "08:00", "09:00"));
+        manager.addSchedule(Schedule("ST_S2", "ST_R2", "ST_B2", "ST_D2", "2026-03-10", "08:00", "09:00"));
+        manager.addSchedule(Schedule("ST_S3", "ST_R1", "ST_B1", "ST_D1", "2026-03-10", "10:00", "11:00"));
+        manager.addSchedule(Schedule("ST_S4", "ST_R2", "ST_B2", "ST_D2", "2026-03-11", "08:00", "09:00"));
+        manager.updateSchedule("ST_S2", Schedule("ST_S2", "ST_R1", "ST_B1", "ST_D1", "2026-03-11", "12:00", "13:00"));
+        manager.removeSchedule("ST_S1");
+
+        const ScheduleStore &store = manager.getStore();
+        bool mirrored = store.size() == storeSchedules.size() && store.size() == 3;
+        for (size_t i = 0; i < store.size() && mirrored; ++i)
+        {
+            const Schedule &row = storeSchedules[i];
+            mirrored = store.routeColumn()[i] == row.getRouteSymbol() && store.busColumn()[i] == row.getBusSymbol() &&
+                       store.driverColumn()[i] == row.getDriverSymbol() && store.dayColumn()[i] == row.getDay() &&
+                       store.departureColumn()[i] == row.getDepartureMinutes() &&
+                       store.arrivalColumn()[i] == row.getArrivalMinutes();
+        }
+        logTest("Columns mirror the schedule list after add, update and remove", mirrored);
+
+        ScheduleStore::RowList expected;
+        for (size_t i = 0; i < storeSchedules.size(); ++i)
+        {
+            if (storeSchedules[i].getBusId() == "ST_B1")
+            {
+                expected.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        ScheduleView onDay = manager.getSchedulesByDate("2026-03-11");
+        logTest("Column scans match a row-by-row scan",
+                store.selectByBus(SymbolTable::intern("ST_B1")) == expected && expected.size() == 2 &&
+                    onDay.size() == 2 && onDay[0].getId() == "ST_S4" && onDay[1].getId() == "ST_S2" &&
+                    manager.getSchedulesByDriver("ST_D2").size() == 1);
+
+        logTest("Unknown IDs select nothing",
+                manager.getSchedulesByBus("ST_UNKNOWN").empty() && manager.getSchedulesByDate("2026-03-12").empty());
+
+        ScheduleView driverOnDay = manager.findSchedules(ScheduleQuery().driver("ST_D1").date("2026-03-11"));
+        ScheduleQuery atNoon = ScheduleQuery().driver("ST_D1").date("2026-03-11").departingBetween("12:00", "12:00");
+        ScheduleQuery afterNoon = ScheduleQuery().driver("ST_D1").departingBetween("12:01", "23:59");
+        logTest("Driver and date filters combine",
+                driverOnDay.size() == 1 && driverOnDay[0].getId() == "ST_S2" &&
+                    manager.findSchedules(atNoon).size() == 1 && manager.findSchedules(afterNoon).empty() &&
+                    manager.findSchedules(ScheduleQuery().driver("ST_D1").date("2026-02-30")).empty());
+
+        size_t visited = 0;
+        bool pointsIntoList = true;
+        for (const Schedule &schedule : manager.getSchedulesByBus("ST_B1"))
+        {
+            pointsIntoList = pointsIntoList && &schedule >= storeSchedules.data() &&
+                             &schedule < storeSchedules.data() + storeSchedules.size();
+            visited++;
+        }
+        logTest("Views refer to stored schedules instead of copies",
+                pointsIntoList && visited == 2 && ScheduleView(storeSchedules).size() == storeSchedules.size() &&
+                    manager.findSchedules(ScheduleQuery()).size() == storeSchedules.size());
+    }
+
+    remove(storeFile.c_str());
+    remove((storeFile + ".log").c_str());
+    return true;
+}
+
+bool SystemTester::testTimetableAudit()
+{
+    printTestHeader("TIMETABLE AUDIT TESTS");
+
+    // Rows as a data file would load them: the overlap checks never ran.
+    const string auditFile = "data/audit_test_schedules.txt";
+    vector<Route> auditRoutes = {Route("TA_R1", "A", "B", {}, 60)};
+    vector<Bus> auditBuses;
+    vector<Driver> auditDrivers;
+    vector<Schedule> auditSchedules = {
+        Schedule("TA_S1", "TA_R1", "TA_B1", "TA_D1", "2026-04-01", "08:00", "10:00"),
+        Schedule("TA_S2", "TA_R1", "TA_B1", "TA_D2", "2026-04-01", "09:00", "11:00"),
+        Schedule("TA_S3", "TA_R1", "TA_B1", "TA_D3", "2026-04-01", "09:30", "09:45"),
+        Schedule("TA_S4", "TA_R1", "TA_B1", "TA_D4", "2026-04-01", "11:00", "12:00"),
+        Schedule("TA_S5", "TA_R1", "TA_B2", "TA_D1", "2026-04-02", "08:00", "09:00"),
+        Schedule("TA_S6", "TA_R1", "TA_B3", "TA_D1", "2026-04-01", "08:30", "08:45")};
+
+    {
+        ScheduleManager manager(auditSchedules, auditRoutes, auditBuses, auditDrivers, auditFile);
+        TimetableAudit::Report report = manager.auditTimetable();
+        using Resource = TimetableAudit::Resource;
+        bool pairs = report.conflicts.size() == 4 && report.count(Resource::Bus) == 3 &&
+                     report.count(Resource::Driver) == 1 && report.schedulesChecked == 6 &&
+                     report.datesChecked == 2 && !report.clean();
+        if (pairs)
+        {
+            const TimetableAudit::Conflict &first = report.conflicts[0];
+            const TimetableAudit::Conflict &driver = report.conflicts[3];
+            pairs = first.first == "TA_S1" && first.second == "TA_S2" &&
+                    first.overlapStart == Schedule::parseTime("09:00") &&
+                    first.overlapEnd == Schedule::parseTime("10:00") &&
+                    driver.resource == SymbolTable::intern("TA_D1") && driver.first == "TA_S1" &&
+                    driver.second == "TA_S6";
+        }
+        logTest("Audit reports every double-booked pair", pairs);
+    }
+    remove(auditFile.c_str());
+    remove((auditFile + ".log").c_str());
+
+    // Random timetable checked against every pair on the same date.
+    mt19937 random(11);
+    vector<Schedule> randomSchedules;
+    for (int i = 0; i < 1500; ++i)
+    {
+        int departure = 300 + static_cast<int>(random() % 900);
+        int length = 10 + static_cast<int>(random() % 120);
+        randomSchedules.emplace_back("TA_X" + to_string(i), "TA_R1", "TA_XB" + to_string(random() % 40),
+                                     "TA_XD" + to_string(random() % 40), "2026-04-0" + to_string(1 + random() % 7),
+                                     Schedule::formatTime(static_cast<int16_t>(departure)),
+                                     Schedule::formatTime(static_cast<int16_t>(departure + length)));
+    }
+    size_t expectedBus = 0;
+    size_t expectedDriver = 0;
+    for (size_t i = 0; i < randomSchedules.size(); ++i)
+    {
+        for (size_t j = i + 1; j < randomSchedules.size(); ++j)
+        {
+            const Schedule &a = randomSchedules[i];
+            const Schedule &b = randomSchedules[j];
+            if (a.hasTimeOverlap(b))
+            {
+                expectedBus += a.getBusSymbol() == b.getBusSymbol();
+                expectedDriver += a.getDriverSymbol() == b.getDriverSymbol();
+            }
+        }
+    }
+
+    ScheduleStore randomStore;
+    randomStore.rebuild(randomSchedules);
+    TimetableAudit::Report single = TimetableAudit::run(randomSchedules, randomStore, 1);
+    TimetableAudit::Report parallel = TimetableAudit::run(randomSchedules, randomStore, 4);
+    bool same = single.conflicts.size() == parallel.conflicts.size();
+    for (size_t i = 0; i < single.conflicts.size() && same; ++i)
+    {
+        same = single.conflicts[i].first == parallel.conflicts[i].first &&
+               single.conflicts[i].second == parallel.conflicts[i].second &&
+               single.conflicts[i].kind == parallel.conflicts[i].kind;
+    }
+    logTest("Sweep matches a pairwise check on every thread count",
+            expectedBus > 0 && expectedDriver > 0 && same &&
+                single.count(TimetableAudit::Resource::Bus) == expectedBus &&
+                single.count(TimetableAudit::Resource::Driver) == expectedDriver && single.datesChecked == 7);
+
+    return true;
+}
+
+bool SystemTester::testJourneyPlanner()
+{
+    printTestHeader("JOURNEY PLANNER TESTS");
+
+    vector<Route> routes = {Route("JP_R1", "JP Alpha", "JP Gamma", {"JP Beta"}, 60),
+                            Route("JP_R2", "JP Gamma", "JP Delta", {}, 30),
+                            Route("JP_R3", "JP Beta", "JP Delta", {"JP Epsilon"}, 120),
+                            Route("JP_R4", "JP Alpha", "JP Delta", {}, 240)};
+    vector<Schedule> schedules = {
+        Schedule("JP_S1", "JP_R1", "B1", "D1", "2026-06-01", "08:00", "09:00"),
+        Schedule("JP_S2", "JP_R1", "B1", "D1", "2026-06-01", "10:00", "11:00"),
+        Schedule("JP_S3", "JP_R2", "B2", "D2", "2026-06-01", "09:10", "09:40"),
+        Schedule("JP_S4", "JP_R2", "B2", "D2", "2026-06-01", "08:00", "08:20"),
+        Schedule("JP_S5", "JP_R3", "B3", "D3", "2026-06-01", "08:40", "10:40"),
+        Schedule("JP_S6", "JP_R4", "B4", "D4", "2026-06-01", "08:00", "12:00"),
+        Schedule("JP_S7", "JP_R4", "B4", "D4", "2026-06-02", "08:00", "12:00")};
+
+    JourneyPlanner planner;
+    planner.build(routes, schedules);
+    int32_t day = Schedule::parseDate("2026-06-01");
+    auto at = [](int32_t day, int32_t dayOffset, const char *time)
+    { return static_cast<int64_t>(day + dayOffset) * JourneyPlanner::MINUTES_PER_DAY + Schedule::parseTime(time); };
+
+    // Direct at 12:00, or change at JP Gamma (JP Beta is passed at 08:30).
+    vector<JourneyPlanner::Itinerary> options = planner.plan("JP Alpha", "JP Delta", day, Schedule::parseTime("07:30"));
+    bool pareto = options.size() == 2 && options[0].transfers() == 0 && options[0].arrival() == at(day, 0, "12:00") &&
+                  options[1].transfers() == 1 && options[1].arrival() == at(day, 0, "09:40");
+    if (pareto)
+    {
+        const JourneyPlanner::Leg &first = options[1].legs[0];
+        const JourneyPlanner::Leg &second = options[1].legs[1];
+        pareto = first.scheduleId == "JP_S1" && first.routeId == "JP_R1" &&
+                 SymbolTable::name(first.to) == "JP Gamma" && first.arrival == at(day, 0, "09:00") &&
+                 second.scheduleId == "JP_S3" && second.departure == at(day, 0, "09:10");
+    }
+    logTest("Planner returns the direct trip and a faster transfer", pareto);
+
+    JourneyPlanner::Options slowTransfers;
+    slowTransfers.transferMinutes = 15;
+    vector<JourneyPlanner::Itinerary> slow =
+        planner.plan("JP Alpha", "JP Delta", day, Schedule::parseTime("07:30"), slowTransfers);
+    vector<JourneyPlanner::Itinerary> nextDay = planner.plan("JP Alpha", "JP Delta", day, Schedule::parseTime("09:30"));
+    logTest("Transfers need time and later trips run on later days",
+            slow.size() == 1 && slow[0].legs[0].scheduleId == "JP_S6" && nextDay.size() == 1 &&
+                nextDay[0].arrival() == at(day, 1, "12:00") &&
+                planner.plan("JP Delta", "JP Alpha", day, 0).empty() &&
+                planner.plan("JP Alpha", "JP Nowhere", day, 0).empty());
+
+    // Minutes since day 0 pass INT32_MAX in late years parseDate accepts.
+    int32_t lastDay = Schedule::parseDate("9999-12-31");
+    schedules.push_back(Schedule("JP_S8", "JP_R4", "B4", "D4", "9999-12-31", "08:00", "12:00"));
+    JourneyPlanner farPlanner;
+    farPlanner.build(routes, schedules);
+    vector<JourneyPlanner::Itinerary> far = farPlanner.plan("JP Alpha", "JP Delta", lastDay, Schedule::parseTime("07:30"));
+    logTest("Planner handles far-future dates",
+            far.size() == 1 && far[0].legs[0].scheduleId == "JP_S8" && far[0].arrival() == at(lastDay, 0, "12:00") &&
+                far[0].legs[0].departure == at(lastDay, 0, "08:00"));
+
+    // Random network checked against a connection scan, which finds the
+    // earliest arrival with any number of transfers.
+    mt19937 random(21);
+    const int stopTotal = 15;
+    vector<Route> randomRoutes;
+    for (int r = 0; r < 30; ++r)
+    {
+        vector<int> stops(stopTotal);
+        for (int s = 0; s < stopTotal; ++s)
+        {
+            stops[s] = s;
+        }
+        shuffle(stops.begin(), stops.end(), random);
+        vector<string> keyStops;
+        int stopCount = 2 + static_cast<int>(random() % 4);
+        for (int s = 1; s < stopCount - 1; ++s)
+        {
+            keyStops.push_back("JP Stop " + to_string(stops[s]));
+        }
+        randomRoutes.emplace_back("JP_RR" + to_string(r), "JP Stop " + to_string(stops[0]),
+                                  "JP Stop " + to_string(stops[stopCount - 1]), keyStops, 60);
+    }
+    vector<Schedule> randomTrips;
+    for (int t = 0; t < 400; ++t)
+    {
+        int departure = 300 + static_cast<int>(random() % 900);
+        int duration = 20 + static_cast<int>(random() % 3) * 20;
+        randomTrips.emplace_back("JP_T" + to_string(t), "JP_RR" + to_string(random() % 30), "B1", "D1",
+                                 "2026-06-0" + to_string(1 + random() % 2),
+                                 Schedule::formatTime(static_cast<int16_t>(departure)),
+                                 Schedule::formatTime(static_cast<int16_t>(departure + duration)));
+    }
+
+    struct Connection
+    {
+        int32_t departure;
+        int32_t arrival;
+        Symbol from;
+        Symbol to;
+        size_t trip;
+    };
+    vector<Connection> connections;
+    for (size_t t = 0; t < randomTrips.size(); ++t)
+    {
+        const Schedule &trip = randomTrips[t];
+        const Route &route = randomRoutes[stoi(trip.getRouteId().substr(5))];
+        vector<Symbol> stops = {SymbolTable::intern(route.getOrigin())};
+        stops.insert(stops.end(), route.getKeyStopSymbols().begin(), route.getKeyStopSymbols().end());
+        stops.push_back(SymbolTable::intern(route.getDestination()));
+        int32_t start = trip.getDay() * JourneyPlanner::MINUTES_PER_DAY + trip.getDepartureMinutes();
+        int32_t duration = trip.getArrivalMinutes() - trip.getDepartureMinutes();
+        int32_t last = static_cast<int32_t>(stops.size()) - 1;
+        for (int32_t s = 0; s < last; ++s)
+        {
+            connections.push_back({start + duration * s / last, start + duration * (s + 1) / last, stops[s],
+                                   stops[s + 1], t});
+        }
+    }
+    sort(connections.begin(), connections.end(), [](const Connection &a, const Connection &b)
+         { return a.departure < b.departure; });
+
+    JourneyPlanner randomPlanner;
+    randomPlanner.build(randomRoutes, randomTrips);
+    JourneyPlanner::Options unlimited;
+    unlimited.maxTransfers = 30;
+    bool agree = true;
+    size_t reachable = 0;
+    for (int q = 0; q < 60 && agree; ++q)
+    {
+        Symbol from = SymbolTable::intern("JP Stop " + to_string(random() % stopTotal));
+        Symbol to = SymbolTable::intern("JP Stop " + to_string(random() % stopTotal));
+        int16_t startMinute = static_cast<int16_t>(300 + random() % 600);
+        int32_t start = day * JourneyPlanner::MINUTES_PER_DAY + startMinute;
+        if (from == to)
+        {
+            continue;
+        }
+
+        unordered_map<Symbol, int32_t> earliest = {{from, start}};
+        vector<bool> onTrip(randomTrips.size(), false);
+        for (const Connection &connection : connections)
+        {
+            auto reached = earliest.find(connection.from);
+            int32_t buffer = connection.from == from ? 0 : unlimited.transferMinutes;
+            if (!onTrip[connection.trip] &&
+                (reached == earliest.end() || reached->second + buffer > connection.departure))
+            {
+                continue;
+            }
+            onTrip[connection.trip] = true;
+            auto arrived = earliest.find(connection.to);
+            if (arrived == earliest.end() || connection.arrival < arrived->second)
+            {
+                earliest[connection.to] = connection.arrival;
+            }
+        }
+
+        vector<JourneyPlanner::Itinerary> found =
+            randomPlanner.plan(SymbolTable::name(from), SymbolTable::name(to), day, startMinute, unlimited);
+        auto expected = earliest.find(to);
+        if (expected == earliest.end())
+        {
+            agree = found.empty();
+        }
+        else
+        {
+            agree = !found.empty() && found.back().arrival() == expected->second;
+            reachable++;
+        }
+    }
+    logTest("Earliest arrivals match a connection scan", agree && reachable > 0);
+
+    return true;
+}
+
+bool SystemTester::testTravelTimeMatrix()
+{
+    printTestHeader("TRAVEL TIME MATRIX TESTS");
+
+    vector<Route> routes = {Route("TT_R1", "TT Alpha", "TT Gamma", {"TT Beta"}, 60),
+                            Route("TT_R2", "TT Gamma", "TT Delta", {}, 30),
+                            Route("TT_R3", "TT Beta", "TT Delta", {"TT Epsilon"}, 120),
+                            Route("TT_R4", "TT Alpha", "TT Delta", {}, 240)};
+    TravelTimeMatrix matrix;
+    matrix.build(routes);
+    logTest("Travel times follow the fastest chain of routes",
+            matrix.stopCount() == 5 && matrix.travelTime("TT Alpha", "TT Delta") == 90 &&
+                matrix.travelTime("TT Beta", "TT Epsilon") == 60 && matrix.travelTime("TT Alpha", "TT Alpha") == 0 &&
+                matrix.travelTime("TT Delta", "TT Alpha") == TravelTimeMatrix::UNREACHABLE &&
+                matrix.travelTime("TT Alpha", "TT Nowhere") == TravelTimeMatrix::UNREACHABLE);
+
+    // Random changes applied incrementally, checked against a full rebuild.
+    mt19937 random(22);
+    const int stopTotal = 40;
+    auto randomRoute = [&random](const string &id)
+    {
+        vector<int> stops(stopTotal);
+        for (int s = 0; s < stopTotal; ++s)
+        {
+            stops[s] = s;
+        }
+        shuffle(stops.begin(), stops.end(), random);
+        vector<string> keyStops;
+        int stopCount = 2 + static_cast<int>(random() % 4);
+        for (int s = 1; s < stopCount - 1; ++s)
+        {
+            keyStops.push_back("TT Stop " + to_string(stops[s]));
+        }
+        return Route(id, "TT Stop " + to_string(stops[0]), "TT Stop " + to_string(stops[stopCount - 1]), keyStops,
+                     10 + static_cast<int>(random() % 90));
+    };
+    vector<Route> randomRoutes;
+    for (int r = 0; r < 50; ++r)
+    {
+        randomRoutes.push_back(randomRoute("TT_RR" + to_string(r)));
+    }
+
+    TravelTimeMatrix incremental;
+    incremental.build(randomRoutes);
+    bool agree = true;
+    size_t rowsRecomputed = 0;
+    for (int change = 0; change < 60 && agree; ++change)
+    {
+        size_t position = random() % randomRoutes.size();
+        Route before = randomRoutes[position];
+        if (change % 3 == 0)
+        {
+            randomRoutes[position].setEstimatedTravelTime(5 + static_cast<int>(random() % 120));
+            rowsRecomputed += incremental.update(randomRoutes, &before, &randomRoutes[position]);
+        }
+        else if (change % 3 == 1)
+        {
+            randomRoutes[position] = randomRoute(before.getId().str());
+            rowsRecomputed += incremental.update(randomRoutes, &before, &randomRoutes[position]);
+        }
+        else
+        {
+            // Recorded as they happen and applied together, as a query would.
+            randomRoutes[position] = randomRoutes.back();
+            randomRoutes.pop_back();
+            incremental.recordChange(&before, nullptr);
+            randomRoutes.push_back(randomRoute("TT_RN" + to_string(change)));
+            incremental.recordChange(nullptr, &randomRoutes.back());
+            agree = incremental.isStale();
+            rowsRecomputed += incremental.refresh(randomRoutes);
+            agree = agree && !incremental.isStale();
+        }
+
+        TravelTimeMatrix full;
+        full.build(randomRoutes);
+        for (int from = 0; from < stopTotal && agree; ++from)
+        {
+            for (int to = 0; to < stopTotal && agree; ++to)
+            {
+                string fromStop = "TT Stop " + to_string(from);
+                string toStop = "TT Stop " + to_string(to);
+                int32_t expected = from == to ? 0 : full.travelTime(fromStop, toStop);
+                agree = incremental.travelTime(fromStop, toStop) == expected;
+            }
+        }
+    }
+    logTest("Incremental updates match a full rebuild", agree && rowsRecomputed < 40 * stopTotal);
+
+    const string matrixFile = "data/travel_time_test.times";
+    TravelTimeMatrix loaded;
+    TravelTimeMatrix outdated;
+    vector<Route> changedRoutes = routes;
+    changedRoutes[0].setEstimatedTravelTime(61);
+    bool roundTrip = matrix.save(matrixFile, routes) && loaded.load(matrixFile, routes) &&
+                     loaded.travelTime("TT Alpha", "TT Delta") == 90 &&
+                     loaded.travelTime("TT Delta", "TT Alpha") == TravelTimeMatrix::UNREACHABLE &&
+                     !outdated.load(matrixFile, changedRoutes) && !outdated.isBuilt();
+    logTest("Saved matrix reloads only for the same routes", roundTrip);
+    remove(matrixFile.c_str());
+
+    const string routeFile = "data/travel_time_test_routes.txt";
+    {
+        vector<Route> managed = routes;
+        RouteManager manager(managed, routeFile);
+        bool tracked = manager.getTravelTime("TT Alpha", "TT Delta") == 90;
+        manager.updateRoute("TT_R2", Route("TT_R2", "TT Gamma", "TT Delta", {}, 200));
+        tracked = tracked && manager.getTravelTime("TT Alpha", "TT Delta") == 150;
+        manager.removeRoute("TT_R3");
+        tracked = tracked && manager.getTravelTime("TT Alpha", "TT Delta") == 240 &&
+                  manager.getTravelTime("TT Beta", "TT Epsilon") == TravelTimeMatrix::UNREACHABLE;
+        // A new stop and a second change, applied together by the next query.
+        manager.addRoute(Route("TT_R5", "TT Delta", "TT Zeta", {}, 15));
+        manager.updateRoute("TT_R4", Route("TT_R4", "TT Alpha", "TT Delta", {}, 100));
+        tracked = tracked && manager.getTravelTime("TT Alpha", "TT Zeta") == 115;
+        logTest("Route changes keep the manager's travel times current", tracked);
+    }
+    remove(routeFile.c_str());
+    remove((routeFile + ".log").c_str());
+    remove((routeFile + ".times").c_str());
+
+    return true;
+}
+
+bool SystemTester::testScanKernels()
+{
+    printTestHeader("SCAN KERNEL TESTS");
+
+    // Sizes around the 64-row word and the vector widths exercise the tails.
+    const vector<size_t> sizes = {0, 1, 7, 63, 64, 65, 130, 1000};
+    mt19937 random(7);
+    ScanKernels::Level supported = ScanKernels::supportedLevel();
+    bool kernelsAgree = true;
+
+    for (int level = 0; level <= static_cast<int>(supported); ++level)
+    {
+        ScanKernels::setLevel(static_cast<ScanKernels::Level>(level));
+        for (size_t size : sizes)
+        {
+            vector<uint32_t> keys(size);
+            vector<uint32_t> days(size);
+            vector<int16_t> minutes(size);
+            for (size_t i = 0; i < size; ++i)
+            {
+                keys[i] = random() % 4;
+                days[i] = random() % 2;
+                minutes[i] = static_cast<int16_t>(random() % 1440);
+            }
+
+            vector<uint64_t> bits(ScanKernels::wordCount(size), ~0ULL);
+            ScanKernels::selectEqual(keys.data(), size, 2, bits.data());
+            ScanKernels::keepEqual(days.data(), size, 1, bits.data());
+            ScanKernels::keepRange(minutes.data(), size, 360, 720, bits.data());
+
+            vector<uint32_t> expected;
+            for (size_t i = 0; i < size; ++i)
+            {
+                if (keys[i] == 2 && days[i] == 1 && minutes[i] >= 360 && minutes[i] <= 720)
+                {
+                    expected.push_back(static_cast<uint32_t>(i));
+                }
+            }
+            kernelsAgree = kernelsAgree && ScanKernels::selectedRows(bits) == expected &&
+                           ScanKernels::countSelected(bits) == expected.size();
+        }
+    }
+    ScanKernels::setLevel(supported);
+    logTest(string("Scalar, SSE2 and AVX2 kernels match a plain loop (up to ") +
+                ScanKernels::levelName(supported) + ")",
+            kernelsAgree);
+
+    vector<Schedule> schedules = {
+        Schedule("SK1", "R1", "B1", "D1", "2026-04-01", "06:59", "08:00"),
+        Schedule("SK2", "R1", "B2", "D2", "2026-04-01", "07:00", "08:00"),
+        Schedule("SK3", "R1", "B3", "D3", "2026-04-02", "07:30", "08:00"),
+        Schedule("SK4", "R1", "B4", "D4", "2026-04-01", "09:00", "10:00"),
+        Schedule("SK5", "R1", "B5", "D5", "2026-04-01", "09:01", "10:00")};
+    ScheduleStore store;
+    store.rebuild(schedules);
+    ScheduleStore::RowList window =
+        store.selectDepartingBetween(Schedule::parseDate("2026-04-01"), Schedule::parseTime("07:00"),
+                                     Schedule::parseTime("09:00"));
+    logTest("Departure window includes both ends on the given date only",
+            window == ScheduleStore::RowList({1, 3}));
 
     return true;
 }
@@ -287,6 +1510,474 @@ bool SystemTester::testAuthentication(LoginManager &loginManager)
     return true;
 }
 
+bool SystemTester::testTransactions(RouteManager &rm, BusManager &bm, DriverManager &dm, ScheduleManager &sm)
+{
+    printTestHeader("TRANSACTION TESTS");
+
+    // The schedule refers to a route, bus and driver added earlier in the batch.
+    Transaction setup(rm, bm, dm, sm);
+    setup.addRoute(Route("TX_R1", "Stop A", "Stop B", {}, 60));
+    setup.addBus(Bus("TX_B1", 40, "Batch Model", "Active"));
+    setup.addDriver(Driver("TX_D1", "Batch Driver", "555-0200", "Class A"));
+    setup.addSchedule(Schedule("TX_S1", "TX_R1", "TX_B1", "TX_D1", "2026-05-01", "08:00", "09:00"));
+    bool committed = setup.commit();
+    logTest("Batch commits changes across managers",
+            committed && setup.size() == 0 && rm.routeExists("TX_R1") && bm.busExists("TX_B1") &&
+                dm.driverExists("TX_D1") && sm.scheduleExists("TX_S1"));
+
+    // Each schedule is valid on its own; together they double-book TX_B1.
+    Transaction clash(rm, bm, dm, sm);
+    clash.updateBus("TX_B1", Bus("TX_B1", 60, "Changed Model", "Active"));
+    clash.removeSchedule("TX_S1");
+    clash.addSchedule(Schedule("TX_S2", "TX_R1", "TX_B1", "TX_D1", "2026-05-01", "10:00", "12:00"));
+    clash.addSchedule(Schedule("TX_S3", "TX_R1", "TX_B1", "TX_D1", "2026-05-01", "11:00", "13:00"));
+    bool rejected = !clash.commit();
+    Bus *bus = bm.findBus("TX_B1");
+    logTest("Overlap within a batch rolls back every change",
+            rejected && !sm.scheduleExists("TX_S2") && !sm.scheduleExists("TX_S3") && sm.scheduleExists("TX_S1") &&
+                bus && bus->getModel() == "Batch Model" && bus->getCapacity() == 40 &&
+                sm.getSchedulesByBus("TX_B1").size() == 1);
+
+    Transaction rename(rm, bm, dm, sm);
+    rename.updateSchedule("TX_S1", Schedule("TX_S9", "TX_R1", "TX_B1", "TX_D1", "2026-05-01", "08:00", "09:00"));
+    rename.removeDriver("TX_UNKNOWN");
+    bool renameRejected = !rename.commit();
+    logTest("Rolled-back renames restore the old ID",
+            renameRejected && sm.scheduleExists("TX_S1") && !sm.scheduleExists("TX_S9"));
+
+    Transaction cleanup(rm, bm, dm, sm);
+    cleanup.removeSchedule("TX_S1");
+    cleanup.removeDriver("TX_D1");
+    cleanup.removeBus("TX_B1");
+    cleanup.removeRoute("TX_R1");
+    logTest("Batch removes commit",
+            cleanup.commit() && !sm.scheduleExists("TX_S1") && !bm.busExists("TX_B1") &&
+                !dm.driverExists("TX_D1") && !rm.routeExists("TX_R1"));
+
+    return true;
+}
+
+bool SystemTester::testDepartureBoard(RouteManager &rm, BusManager &bm, DriverManager &dm, ScheduleManager &sm)
+{
+    printTestHeader("DEPARTURE BOARD TESTS");
+
+    // DB_R1 reaches DB Central 30 minutes after leaving DB North.
+    Transaction setup(rm, bm, dm, sm);
+    setup.addRoute(Route("DB_R1", "DB North", "DB South", {"DB Central", "DB Market"}, 90));
+    setup.addRoute(Route("DB_R2", "DB Central", "DB South", {}, 20));
+    for (int i = 1; i <= 4; ++i)
+    {
+        setup.addBus(Bus("DB_B" + to_string(i), 40, "Board Model", "Active"));
+        setup.addDriver(Driver("DB_D" + to_string(i), "Board Driver", "555-0300", "Class A"));
+    }
+    setup.addSchedule(Schedule("DB_S1", "DB_R1", "DB_B1", "DB_D1", "2026-07-01", "08:00", "09:30"));
+    setup.addSchedule(Schedule("DB_S2", "DB_R1", "DB_B2", "DB_D2", "2026-07-01", "07:00", "08:30"));
+    setup.addSchedule(Schedule("DB_S3", "DB_R1", "DB_B1", "DB_D1", "2026-07-02", "06:00", "07:30"));
+    setup.addSchedule(Schedule("DB_S4", "DB_R2", "DB_B3", "DB_D3", "2026-07-01", "08:10", "08:30"));
+    bool committed = setup.commit();
+
+    int32_t day = Schedule::parseDate("2026-07-01");
+    auto board = [&sm, day](const string &stop, const char *time, size_t count)
+    {
+        string listing;
+        for (const auto &departure : sm.getNextDepartures(stop, day, Schedule::parseTime(time), count))
+        {
+            const Schedule *schedule = sm.getSchedule(departure.schedule);
+            int64_t dayOffset = departure.time / DepartureBoard::MINUTES_PER_DAY - day;
+            int16_t minute = static_cast<int16_t>(departure.time % DepartureBoard::MINUTES_PER_DAY);
+            listing += (schedule ? schedule->getId().str() : "?") + "@" + to_string(dayOffset) + " " +
+                       Schedule::formatTime(minute) + ";";
+        }
+        return listing;
+    };
+    logTest("Next departures join schedules with route stops",
+            committed && board("DB Central", "08:00", 3) == "DB_S4@0 08:10;DB_S1@0 08:30;DB_S3@1 06:30;" &&
+                board("DB North", "07:00", 1) == "DB_S2@0 07:00;" &&
+                board("DB Market", "23:00", 5) == "DB_S3@1 07:00;" &&
+                board("DB South", "00:00", 5).empty() && board("DB Nowhere", "00:00", 5).empty());
+
+    sm.addSchedule(Schedule("DB_S5", "DB_R1", "DB_B4", "DB_D4", "2026-07-01", "08:05", "09:35"));
+    sm.updateSchedule("DB_S1", Schedule("DB_S1", "DB_R1", "DB_B1", "DB_D1", "2026-07-01", "09:00", "10:30"));
+    sm.removeSchedule("DB_S4");
+    bool tracksSchedules = board("DB Central", "08:00", 3) == "DB_S5@0 08:35;DB_S1@0 09:30;DB_S3@1 06:30;";
+    rm.updateRoute("DB_R1", Route("DB_R1", "DB North", "DB South", {"DB Central", "DB Market"}, 120));
+    logTest("Board follows schedule and route changes",
+            tracksSchedules && board("DB Central", "08:00", 2) == "DB_S5@0 08:45;DB_S1@0 09:40;");
+
+    // Day 9999-12-31 times 1440 minutes does not fit in 32 bits.
+    sm.addSchedule(Schedule("DB_S9", "DB_R2", "DB_B3", "DB_D3", "9999-12-31", "08:10", "08:30"));
+    int32_t lastDay = Schedule::parseDate("9999-12-31");
+    vector<DepartureBoard::Departure> farFuture = sm.getNextDepartures("DB Central", lastDay, 0, 5);
+    logTest("Board handles far-future dates",
+            farFuture.size() == 1 && farFuture[0].time / DepartureBoard::MINUTES_PER_DAY == lastDay &&
+                farFuture[0].time % DepartureBoard::MINUTES_PER_DAY == Schedule::parseTime("08:10"));
+
+    // Random timetable with changes, checked against a scan of every schedule.
+    mt19937 random(23);
+    const int stopTotal = 12;
+    vector<Route> randomRoutes;
+    for (int r = 0; r < 10; ++r)
+    {
+        vector<string> keyStops;
+        for (int s = 0; s < 3; ++s)
+        {
+            keyStops.push_back("DB Stop " + to_string(random() % stopTotal));
+        }
+        randomRoutes.emplace_back("DB_RR" + to_string(r), "DB Stop " + to_string(random() % stopTotal),
+                                  "DB Stop " + to_string(random() % stopTotal), keyStops,
+                                  30 + static_cast<int>(random() % 60));
+    }
+    auto randomTrip = [&random](int t)
+    {
+        int departure = static_cast<int>(random() % 1300);
+        return Schedule("DB_T" + to_string(t), "DB_RR" + to_string(random() % 10), "B1", "D1",
+                        "2026-07-0" + to_string(1 + random() % 3),
+                        Schedule::formatTime(static_cast<int16_t>(departure)),
+                        Schedule::formatTime(static_cast<int16_t>(departure + 60)));
+    };
+    vector<Schedule> randomTrips;
+    for (int t = 0; t < 300; ++t)
+    {
+        randomTrips.push_back(randomTrip(t));
+    }
+    SlotMap<Schedule> slots(randomTrips);
+    DepartureBoard departures;
+    departures.build(randomRoutes, randomTrips, slots);
+    for (int change = 0; change < 100; ++change)
+    {
+        DepartureBoard::Handle handle = slots.handleAt(random() % randomTrips.size());
+        departures.erase(*slots.get(handle), handle);
+        slots.erase(handle);
+        Schedule trip = randomTrip(300 + change);
+        departures.insert(trip, slots.insert(trip));
+    }
+
+    bool agree = true;
+    for (int q = 0; q < 200 && agree; ++q)
+    {
+        string stop = "DB Stop " + to_string(random() % stopTotal);
+        int32_t after = day * DepartureBoard::MINUTES_PER_DAY + static_cast<int32_t>(random() % 4000);
+        vector<int32_t> expected;
+        for (const auto &trip : randomTrips)
+        {
+            const Route &route = randomRoutes[stoi(trip.getRouteId().substr(5))];
+            vector<string> stops = {string(route.getOrigin())};
+            for (const string &keyStop : route.getKeyStops())
+            {
+                stops.push_back(keyStop);
+            }
+            int32_t start = trip.getDay() * DepartureBoard::MINUTES_PER_DAY + trip.getDepartureMinutes();
+            for (size_t k = 0; k < stops.size(); ++k)
+            {
+                int32_t time = start + route.getEstimatedTravelTime() * static_cast<int32_t>(k) /
+                                           static_cast<int32_t>(stops.size());
+                if (stops[k] == stop && time >= after)
+                {
+                    expected.push_back(time);
+                }
+            }
+        }
+        sort(expected.begin(), expected.end());
+        expected.resize(min<size_t>(expected.size(), 5));
+
+        vector<DepartureBoard::Departure> found = departures.next(stop, after / DepartureBoard::MINUTES_PER_DAY,
+                                                                  static_cast<int16_t>(after % DepartureBoard::MINUTES_PER_DAY), 5);
+        agree = found.size() == expected.size();
+        for (size_t i = 0; i < found.size() && agree; ++i)
+        {
+            agree = found[i].time == expected[i] && slots.get(found[i].schedule) != nullptr;
+        }
+    }
+    logTest("Next departures match a scan of every schedule", agree && departures.departureCount() == 1200);
+
+    Transaction cleanup(rm, bm, dm, sm);
+    cleanup.removeSchedule("DB_S1");
+    cleanup.removeSchedule("DB_S2");
+    cleanup.removeSchedule("DB_S3");
+    cleanup.removeSchedule("DB_S5");
+    for (int i = 1; i <= 4; ++i)
+    {
+        cleanup.removeBus("DB_B" + to_string(i));
+        cleanup.removeDriver("DB_D" + to_string(i));
+    }
+    cleanup.removeRoute("DB_R1");
+    cleanup.removeRoute("DB_R2");
+    cleanup.commit();
+
+    return true;
+}
+
+bool SystemTester::testAvailabilityIndex(RouteManager &rm, BusManager &bm, DriverManager &dm, ScheduleManager &sm)
+{
+    printTestHeader("AVAILABILITY INDEX TESTS");
+
+    Symbol x1 = SymbolTable::intern("AV_X1");
+    Symbol x2 = SymbolTable::intern("AV_X2");
+    Symbol x3 = SymbolTable::intern("AV_X3");
+    AvailabilityIndex index;
+    index.occupy(x1, 10, Schedule::parseTime("08:00"), Schedule::parseTime("09:00"));
+    index.occupy(x2, 10, Schedule::parseTime("09:30"), Schedule::parseTime("10:04"));
+    index.occupy(x2, 11, 0, AvailabilityIndex::MINUTES_PER_DAY);
+    index.setRoster({x3, x2, x1});
+    auto names = [](const vector<Symbol> &symbols)
+    {
+        string listing;
+        for (Symbol symbol : symbols)
+        {
+            listing += SymbolTable::name(symbol) + ";";
+        }
+        return listing;
+    };
+    logTest("Free resources exclude busy minutes only",
+            names(index.findFree(10, Schedule::parseTime("08:59"), Schedule::parseTime("09:30"))) == "AV_X3;AV_X2;" &&
+                names(index.findFree(10, Schedule::parseTime("09:00"), Schedule::parseTime("09:30"))) ==
+                    "AV_X3;AV_X2;AV_X1;" &&
+                names(index.findFree(10, Schedule::parseTime("10:03"), Schedule::parseTime("10:04"))) ==
+                    "AV_X3;AV_X1;" &&
+                names(index.findFree(11, Schedule::parseTime("23:59"), AvailabilityIndex::MINUTES_PER_DAY)) ==
+                    "AV_X3;AV_X1;" &&
+                index.isFree(x1, 12, 0, AvailabilityIndex::MINUTES_PER_DAY) && index.rowCount() == 3);
+
+    // Random bookings with removals, checked against the interval index.
+    mt19937 random(24);
+    vector<Symbol> resources;
+    for (int r = 0; r < 150; ++r)
+    {
+        resources.push_back(SymbolTable::intern("AV_R" + to_string(r)));
+    }
+    struct Booking
+    {
+        Symbol resource;
+        int32_t day;
+        IntervalIndex::Interval interval;
+    };
+    vector<Booking> bookings;
+    IntervalIndex intervals;
+    AvailabilityIndex bitmaps;
+    bitmaps.setRoster(resources);
+    for (uint32_t b = 0; b < 600; ++b)
+    {
+        int16_t start = static_cast<int16_t>(random() % 1400);
+        int16_t end = static_cast<int16_t>(start + 1 + random() % 200);
+        Booking booking = {resources[random() % resources.size()], static_cast<int32_t>(random() % 3),
+                           {start, end, EntityId("AV_T" + to_string(b))}};
+        bookings.push_back(booking);
+        intervals.insert(booking.resource, booking.day, booking.interval);
+        bitmaps.occupy(booking.resource, booking.day, start, end);
+    }
+    for (uint32_t b = 0; b < bookings.size(); b += 3)
+    {
+        intervals.erase(bookings[b].resource, bookings[b].day, bookings[b].interval);
+        bitmaps.redraw(bookings[b].resource, bookings[b].day,
+                       intervals.intervalsOf(bookings[b].resource, bookings[b].day));
+    }
+
+    bool agree = true;
+    for (int q = 0; q < 300 && agree; ++q)
+    {
+        int32_t day = static_cast<int32_t>(random() % 4);
+        int16_t start = static_cast<int16_t>(random() % 1400);
+        int16_t end = static_cast<int16_t>(start + 1 + random() % 120);
+        vector<Symbol> expected;
+        for (Symbol resource : resources)
+        {
+            if (!intervals.findOverlap(resource, day, start, end))
+            {
+                expected.push_back(resource);
+            }
+        }
+        agree = bitmaps.findFree(day, start, end) == expected;
+    }
+    logTest("Free resources match the interval index", agree);
+
+    Transaction setup(rm, bm, dm, sm);
+    setup.addRoute(Route("AV_R1", "AV North", "AV South", {}, 60));
+    setup.addBus(Bus("AV_B1", 40, "Free Model", "Active"));
+    setup.addBus(Bus("AV_B2", 40, "Free Model", "Active"));
+    setup.addBus(Bus("AV_B3", 40, "Free Model", "Maintenance"));
+    setup.addDriver(Driver("AV_D1", "Free Driver", "555-0400", "Class A"));
+    setup.addDriver(Driver("AV_D2", "Free Driver", "555-0400", "Class A"));
+    setup.addSchedule(Schedule("AV_S1", "AV_R1", "AV_B1", "AV_D1", "2026-08-01", "08:30", "09:00"));
+    bool committed = setup.commit();
+
+    int32_t day = Schedule::parseDate("2026-08-01");
+    auto freeIds = [&sm, day](const char *from, const char *to)
+    {
+        vector<Symbol> freeBuses;
+        vector<Symbol> freeDrivers;
+        sm.findFreeResources(day, Schedule::parseTime(from), Schedule::parseTime(to), freeBuses, freeDrivers);
+        string listing;
+        for (const vector<Symbol> *list : {&freeBuses, &freeDrivers})
+        {
+            for (Symbol symbol : *list)
+            {
+                if (SymbolTable::name(symbol).rfind("AV_", 0) == 0)
+                {
+                    listing += SymbolTable::name(symbol) + ";";
+                }
+            }
+            listing += "|";
+        }
+        return listing;
+    };
+    bool onlyActiveFree = committed && freeIds("08:00", "09:30") == "AV_B2;|AV_D2;|" &&
+                          freeIds("09:00", "09:30") == "AV_B1;AV_B2;|AV_D1;AV_D2;|";
+
+    sm.updateSchedule("AV_S1", Schedule("AV_S1", "AV_R1", "AV_B2", "AV_D2", "2026-08-01", "08:30", "09:00"));
+    bm.updateBus("AV_B3", Bus("AV_B3", 40, "Free Model", "Active"));
+    bool followsChanges = freeIds("08:00", "09:30") == "AV_B1;AV_B3;|AV_D1;|";
+    sm.removeSchedule("AV_S1");
+    logTest("Free buses and drivers follow schedule and status changes",
+            onlyActiveFree && followsChanges && freeIds("08:00", "09:30") == "AV_B1;AV_B2;AV_B3;|AV_D1;AV_D2;|");
+
+    Transaction cleanup(rm, bm, dm, sm);
+    for (int i = 1; i <= 3; ++i)
+    {
+        cleanup.removeBus("AV_B" + to_string(i));
+    }
+    cleanup.removeDriver("AV_D1");
+    cleanup.removeDriver("AV_D2");
+    cleanup.removeRoute("AV_R1");
+    cleanup.commit();
+
+    return true;
+}
+
+bool SystemTester::testAssignmentPlanner(RouteManager &rm, BusManager &bm, DriverManager &dm, ScheduleManager &sm)
+{
+    printTestHeader("ASSIGNMENT PLANNER TESTS");
+
+    vector<Symbol> buses;
+    vector<Symbol> drivers;
+    for (int r = 0; r < 300; ++r)
+    {
+        buses.push_back(SymbolTable::intern("AP_PB" + to_string(r)));
+        drivers.push_back(SymbolTable::intern("AP_PD" + to_string(r)));
+    }
+
+    // Random trips on three dates. Fifty buses and drivers already work
+    // two schedules each, on different dates.
+    mt19937 random(25);
+    auto randomTrip = [&random](const string &id, int32_t day)
+    {
+        int16_t departure = static_cast<int16_t>(random() % 1300);
+        return Schedule(id, "AP_R1", "", "", day, departure, static_cast<int16_t>(departure + 20 + random() % 120));
+    };
+    vector<Schedule> trips;
+    for (int t = 0; t < 600; ++t)
+    {
+        trips.push_back(randomTrip("AP_T" + to_string(t), 20000 + t % 3));
+    }
+    vector<Schedule> existing;
+    for (int e = 0; e < 100; ++e)
+    {
+        Schedule schedule = randomTrip("AP_E" + to_string(e), 20000 + e % 3);
+        existing.emplace_back(schedule.getId().str(), schedule.getRouteSymbol(), buses[e % 50],
+                              drivers[e * 7 % 50], schedule.getDay(), schedule.getDepartureMinutes(),
+                              schedule.getArrivalMinutes());
+    }
+
+    auto clash = [](const vector<Schedule> &timetable)
+    {
+        for (size_t a = 0; a < timetable.size(); ++a)
+        {
+            for (size_t b = a + 1; b < timetable.size(); ++b)
+            {
+                if (timetable[a].hasTimeOverlap(timetable[b]) &&
+                    (timetable[a].getBusSymbol() == timetable[b].getBusSymbol() ||
+                     timetable[a].getDriverSymbol() == timetable[b].getDriverSymbol()))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+    // Most trips running at once on any date, the fewest vehicles possible.
+    auto depth = [](const vector<Schedule> &timetable)
+    {
+        size_t most = 0;
+        for (const auto &trip : timetable)
+        {
+            size_t running = 0;
+            for (const auto &other : timetable)
+            {
+                running += other.getDay() == trip.getDay() &&
+                           other.getDepartureMinutes() <= trip.getDepartureMinutes() &&
+                           trip.getDepartureMinutes() < other.getArrivalMinutes();
+            }
+            most = max(most, running);
+        }
+        return most;
+    };
+
+    AssignmentPlanner::Report fresh = AssignmentPlanner::run(trips, {}, buses, drivers, 4);
+    logTest("Plan on idle rosters uses the fewest vehicles",
+            fresh.assigned.size() == trips.size() && fresh.unassigned.empty() && !clash(fresh.assigned) &&
+                fresh.busesUsed == depth(trips) && fresh.driversUsed == depth(trips) && fresh.datesPlanned == 3);
+
+    AssignmentPlanner::Report around = AssignmentPlanner::run(trips, existing, buses, drivers, 4);
+    vector<Schedule> combined = existing;
+    combined.insert(combined.end(), around.assigned.begin(), around.assigned.end());
+    AssignmentPlanner::Report single = AssignmentPlanner::run(trips, existing, buses, drivers, 1);
+    bool sameAcrossThreads = single.assigned.size() == around.assigned.size();
+    for (size_t i = 0; i < single.assigned.size() && sameAcrossThreads; ++i)
+    {
+        sameAcrossThreads = single.assigned[i].getBusSymbol() == around.assigned[i].getBusSymbol() &&
+                            single.assigned[i].getDriverSymbol() == around.assigned[i].getDriverSymbol();
+    }
+    logTest("Plan around existing schedules has no overlaps",
+            around.assigned.size() == trips.size() && !clash(combined) && sameAcrossThreads);
+
+    vector<Symbol> fewBuses(buses.begin(), buses.begin() + 3);
+    vector<Schedule> badTrips = {Schedule("AP_X1", "AP_R1", "", "", "2026-09-01", "10:00", "09:00"),
+                                 Schedule("AP_X2", "AP_R1", "", "", "", "10:00", "11:00")};
+    trips.insert(trips.end(), badTrips.begin(), badTrips.end());
+    AssignmentPlanner::Report scarce = AssignmentPlanner::run(trips, {}, fewBuses, drivers, 2);
+    logTest("Trips beyond the roster or with bad times stay unassigned",
+            !scarce.unassigned.empty() && scarce.assigned.size() + scarce.unassigned.size() == trips.size() &&
+                scarce.busesUsed <= 3 && !clash(scarce.assigned) &&
+                count(scarce.unassigned.begin(), scarce.unassigned.end(), EntityId("AP_X1")) == 1 &&
+                count(scarce.unassigned.begin(), scarce.unassigned.end(), EntityId("AP_X2")) == 1);
+
+    // Through the managers: only Active buses, and gaps in working days first.
+    Transaction setup(rm, bm, dm, sm);
+    setup.addRoute(Route("AP_R1", "AP North", "AP South", {}, 60));
+    setup.addBus(Bus("AP_B1", 40, "Plan Model", "Active"));
+    setup.addBus(Bus("AP_B2", 40, "Plan Model", "Maintenance"));
+    setup.addDriver(Driver("AP_D1", "Plan Driver", "555-0500", "Class A"));
+    setup.addSchedule(Schedule("AP_S0", "AP_R1", "AP_B1", "AP_D1", "2031-03-01", "08:00", "09:00"));
+    bool committed = setup.commit();
+
+    vector<Schedule> dayTrips = {Schedule("AP_S1", "AP_R1", "", "", "2031-03-01", "08:30", "09:30"),
+                                 Schedule("AP_S2", "AP_R1", "", "", "2031-03-01", "09:00", "10:00")};
+    AssignmentPlanner::Report plan = sm.planAssignments(dayTrips);
+    Transaction batch(rm, bm, dm, sm);
+    for (const auto &schedule : plan.assigned)
+    {
+        batch.addSchedule(schedule);
+    }
+    bool added = committed && plan.assigned.size() == 2 && batch.commit();
+    Schedule *first = sm.findSchedule("AP_S1");
+    Schedule *second = sm.findSchedule("AP_S2");
+    Bus *firstBus = first ? bm.findBus(first->getBusId()) : nullptr;
+    logTest("Assignments commit as one batch using Active buses",
+            added && first && second && second->getBusId() == "AP_B1" && second->getDriverId() == "AP_D1" &&
+                firstBus && firstBus->getStatus() == "Active" && first->getBusId() != "AP_B1");
+
+    Transaction cleanup(rm, bm, dm, sm);
+    cleanup.removeSchedule("AP_S0");
+    cleanup.removeSchedule("AP_S1");
+    cleanup.removeSchedule("AP_S2");
+    cleanup.removeBus("AP_B1");
+    cleanup.removeBus("AP_B2");
+    cleanup.removeDriver("AP_D1");
+    cleanup.removeRoute("AP_R1");
+    cleanup.commit();
+
+    return true;
+}
+
 bool SystemTester::testCRUDOperations(RouteManager &rm, BusManager &bm,
                                       DriverManager &dm, ScheduleManager &sm)
 {
@@ -340,11 +2031,12 @@ bool SystemTester::testEdgeCases(RouteManager &rm, BusManager &bm,
 {
     printTestHeader("EDGE CASE TESTS");
 
-    Bus longIdBus("THIS_IS_A_VERY_LONG_BUS_ID_TO_TEST_LIMITS", 50, "Test", "Active");
-    bool handleLongId = bm.addBus(longIdBus);
+    // IDs are capped at 20 characters; the longest allowed one still works.
+    Bus longIdBus("EDGE_LONG_BUS_ID_020", 50, "Test", "Active");
+    Bus tooLongIdBus("THIS_IS_A_VERY_LONG_BUS_ID_TO_TEST_LIMITS", 50, "Test", "Active");
+    bool handleLongId = bm.addBus(longIdBus) && !bm.addBus(tooLongIdBus);
     logTest("Handle very long ID", handleLongId);
-    if (handleLongId)
-        bm.removeBus("THIS_IS_A_VERY_LONG_BUS_ID_TO_TEST_LIMITS");
+    bm.removeBus("EDGE_LONG_BUS_ID_020");
 
     Driver specialChar("EDGE_D001", "Test-Driver's Name (Special)", "555-0000", "Class A");
     bool handleSpecialChar = dm.addDriver(specialChar);
@@ -394,11 +2086,28 @@ void SystemTester::runAllTests(RouteManager &rm, BusManager &bm, DriverManager &
 
     testDataLoading();
     testBusValidation(bm);
+    testOperationLog(bm);
+    testGroupCommit();
+    testIdIndex(bm);
     testDriverValidation(dm);
     testRouteValidation(rm);
+    testRouteSearchIndexes(rm);
     testScheduleValidation(sm);
+    testScheduleEncoding();
+    testSymbolTable();
+    testFixedId(bm);
     testScheduleOverlap(sm);
+    testIntervalIndex();
+    testScheduleStore();
+    testTimetableAudit();
+    testJourneyPlanner();
+    testTravelTimeMatrix();
+    testScanKernels();
     testAuthentication(lm);
+    testTransactions(rm, bm, dm, sm);
+    testDepartureBoard(rm, bm, dm, sm);
+    testAvailabilityIndex(rm, bm, dm, sm);
+    testAssignmentPlanner(rm, bm, dm, sm);
     testCRUDOperations(rm, bm, dm, sm);
     testEdgeCases(rm, bm, dm, sm);
 }
@@ -0,0 +1,170 @@
+﻿#include "../include/TimetableAudit.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+    struct DateRange
+    {
+        size_t begin;
+        size_t end;
+    };
+
+    // Sweeps one date's rows for one resource column. Rows are sorted by
+    // (resource, departure, ID); the active list holds earlier rows of the
+    // same resource that arrive after the current departure, so each of
+    // them overlaps it unless the current row is itself out of order.
+    void sweep(vector<uint32_t> &rows, const vector<Symbol> &resources, TimetableAudit::Resource kind,
+               const vector<Schedule> &schedules, const ScheduleStore &store,
+               vector<TimetableAudit::Conflict> &conflicts)
+    {
+        const vector<int16_t> &departures = store.departureColumn();
+        const vector<int16_t> &arrivals = store.arrivalColumn();
+
+        sort(rows.begin(), rows.end(), [&](uint32_t a, uint32_t b)
+             {
+            if (resources[a] != resources[b])
+            {
+                return resources[a] < resources[b];
+            }
+            if (departures[a] != departures[b])
+            {
+                return departures[a] < departures[b];
+            }
+            return schedules[a].getId() < schedules[b].getId(); });
+
+        vector<uint32_t> active;
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            uint32_t row = rows[i];
+            if (i > 0 && resources[rows[i - 1]] != resources[row])
+            {
+                active.clear();
+            }
+
+            int16_t departure = departures[row];
+            int16_t arrival = arrivals[row];
+            size_t kept = 0;
+            for (uint32_t earlier : active)
+            {
+                if (arrivals[earlier] <= departure)
+                {
+                    continue;
+                }
+                active[kept++] = earlier;
+                if (departures[earlier] < arrival)
+                {
+                    conflicts.push_back({kind, resources[row], store.dayColumn()[row],
+                                         schedules[earlier].getId(), schedules[row].getId(),
+                                         departure, min(arrivals[earlier], arrival)});
+                }
+            }
+            active.resize(kept);
+            active.push_back(row);
+        }
+    }
+}
+
+size_t TimetableAudit::Report::count(Resource kind) const
+{
+    return static_cast<size_t>(count_if(conflicts.begin(), conflicts.end(),
+                                        [kind](const Conflict &conflict)
+                                        { return conflict.kind == kind; }));
+}
+
+bool TimetableAudit::Report::clean() const
+{
+    return conflicts.empty();
+}
+
+TimetableAudit::Report TimetableAudit::run(const vector<Schedule> &schedules, const ScheduleStore &store,
+                                           unsigned threadCount)
+{
+    Report report;
+    report.schedulesChecked = store.size();
+
+    const vector<int32_t> &days = store.dayColumn();
+    vector<uint32_t> byDay(store.size());
+    for (uint32_t row = 0; row < byDay.size(); ++row)
+    {
+        byDay[row] = row;
+    }
+    sort(byDay.begin(), byDay.end(), [&days](uint32_t a, uint32_t b)
+         { return days[a] != days[b] ? days[a] < days[b] : a < b; });
+
+    vector<DateRange> dates;
+    for (size_t begin = 0; begin < byDay.size();)
+    {
+        size_t end = begin + 1;
+        while (end < byDay.size() && days[byDay[end]] == days[byDay[begin]])
+        {
+            ++end;
+        }
+        dates.push_back({begin, end});
+        begin = end;
+    }
+    report.datesChecked = dates.size();
+
+    if (threadCount == 0)
+    {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+    size_t workerCount = min<size_t>(threadCount, max<size_t>(dates.size(), 1));
+
+    // Workers claim whole dates, so no two threads touch the same group.
+    atomic<size_t> nextDate(0);
+    vector<vector<Conflict>> found(workerCount);
+    auto work = [&](size_t worker)
+    {
+        vector<uint32_t> rows;
+        for (size_t d = nextDate++; d < dates.size(); d = nextDate++)
+        {
+            rows.assign(byDay.begin() + dates[d].begin, byDay.begin() + dates[d].end);
+            sweep(rows, store.busColumn(), Resource::Bus, schedules, store, found[worker]);
+            sweep(rows, store.driverColumn(), Resource::Driver, schedules, store, found[worker]);
+        }
+    };
+
+    vector<thread> workers;
+    for (size_t w = 1; w < workerCount; ++w)
+    {
+        workers.emplace_back(work, w);
+    }
+    work(0);
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    for (auto &conflicts : found)
+    {
+        report.conflicts.insert(report.conflicts.end(), conflicts.begin(), conflicts.end());
+    }
+    sort(report.conflicts.begin(), report.conflicts.end(), [](const Conflict &a, const Conflict &b)
+         {
+        if (a.kind != b.kind)
+        {
+            return a.kind < b.kind;
+        }
+        if (a.day != b.day)
+        {
+            return a.day < b.day;
+        }
+        if (a.resource != b.resource)
+        {
+            return SymbolTable::name(a.resource) < SymbolTable::name(b.resource);
+        }
+        if (a.overlapStart != b.overlapStart)
+        {
+            return a.overlapStart < b.overlapStart;
+        }
+        if (a.first != b.first)
+        {
+            return a.first < b.first;
+        }
+        return a.second < b.second; });
+    return report;
+}
@@ -0,0 +1,280 @@
+﻿#include "../include/Transaction.h"
+#include "../include/DataSaver.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+static string formatRecord(const Route &route)
+{
+    return DataSaver::formatRoute(route);
+}
+
+static string formatRecord(const Bus &bus)
+{
+    return DataSaver::formatBus(bus);
+}
+
+static string formatRecord(const Driver &driver)
+{
+    return DataSaver::formatDriver(driver);
+}
+
+static string formatRecord(const Schedule &schedule)
+{
+    return DataSaver::formatSchedule(schedule);
+}
+
+Transaction::Transaction(RouteManager &routeManager, BusManager &busManager, DriverManager &driverManager,
+                         ScheduleManager &scheduleManager)
+    : routes(routeManager), buses(busManager), drivers(driverManager), schedules(scheduleManager)
+{
+}
+
+template <typename Manager, typename T>
+void Transaction::stage(Lane<Manager, T> &lane, Target target, char operation, const EntityId &id, const T *value)
+{
+    size_t position = lane.values.size();
+    if (value)
+    {
+        lane.values.push_back(*value);
+    }
+    staged.push_back({target, operation, id, position});
+}
+
+void Transaction::addRoute(const Route &route)
+{
+    stage(routes, Target::Route, 'A', route.getId(), &route);
+}
+
+void Transaction::updateRoute(const EntityId &routeId, const Route &route)
+{
+    stage(routes, Target::Route, 'U', routeId, &route);
+}
+
+void Transaction::removeRoute(const EntityId &routeId)
+{
+    stage<RouteManager, Route>(routes, Target::Route, 'R', routeId, nullptr);
+}
+
+void Transaction::addBus(const Bus &bus)
+{
+    stage(buses, Target::Bus, 'A', bus.getId(), &bus);
+}
+
+void Transaction::updateBus(const EntityId &busId, const Bus &bus)
+{
+    stage(buses, Target::Bus, 'U', busId, &bus);
+}
+
+void Transaction::removeBus(const EntityId &busId)
+{
+    stage<BusManager, Bus>(buses, Target::Bus, 'R', busId, nullptr);
+}
+
+void Transaction::addDriver(const Driver &driver)
+{
+    stage(drivers, Target::Driver, 'A', driver.getId(), &driver);
+}
+
+void Transaction::updateDriver(const EntityId &driverId, const Driver &driver)
+{
+    stage(drivers, Target::Driver, 'U', driverId, &driver);
+}
+
+void Transaction::removeDriver(const EntityId &driverId)
+{
+    stage<DriverManager, Driver>(drivers, Target::Driver, 'R', driverId, nullptr);
+}
+
+void Transaction::addSchedule(const Schedule &schedule)
+{
+    stage(schedules, Target::Schedule, 'A', schedule.getId(), &schedule);
+}
+
+void Transaction::updateSchedule(const EntityId &scheduleId, const Schedule &schedule)
+{
+    stage(schedules, Target::Schedule, 'U', scheduleId, &schedule);
+}
+
+void Transaction::removeSchedule(const EntityId &scheduleId)
+{
+    stage<ScheduleManager, Schedule>(schedules, Target::Schedule, 'R', scheduleId, nullptr);
+}
+
+template <typename Fn>
+auto Transaction::visit(Target target, Fn fn)
+{
+    switch (target)
+    {
+    case Target::Route:
+        return fn(routes);
+    case Target::Bus:
+        return fn(buses);
+    case Target::Driver:
+        return fn(drivers);
+    default:
+        return fn(schedules);
+    }
+}
+
+template <typename Manager, typename T>
+bool Transaction::apply(Lane<Manager, T> &lane, const Change &change, Change &undo)
+{
+    Manager &manager = lane.manager;
+    undo = {change.target, 'R', change.id, 0};
+
+    if (change.operation == 'A')
+    {
+        const T &value = lane.values[change.value];
+        if (!manager.checkAdd(value))
+        {
+            return false;
+        }
+        manager.applyAdd(value);
+        lane.entries.push_back({'A', change.id.str(), formatRecord(value)});
+        return true;
+    }
+
+    // Updates and removes keep the entity they overwrite for the undo.
+    const T *existing = manager.slots.get(manager.index.find(change.id));
+    if (change.operation == 'U')
+    {
+        const T &value = lane.values[change.value];
+        if (!manager.checkUpdate(change.id, value))
+        {
+            return false;
+        }
+        lane.previous.push_back(*existing);
+        manager.applyUpdate(change.id, value);
+        lane.entries.push_back({'U', change.id.str(), formatRecord(value)});
+        undo = {change.target, 'U', value.getId(), lane.previous.size() - 1};
+        return true;
+    }
+
+    if (!manager.checkRemove(change.id))
+    {
+        return false;
+    }
+    lane.previous.push_back(*existing);
+    manager.applyRemove(change.id);
+    lane.entries.push_back({'R', change.id.str(), ""});
+    undo = {change.target, 'A', change.id, lane.previous.size() - 1};
+    return true;
+}
+
+template <typename Manager, typename T>
+void Transaction::revert(Lane<Manager, T> &lane, const Change &undo)
+{
+    // Unchecked: the data it restores passed (or predates) the checks.
+    Manager &manager = lane.manager;
+    if (undo.operation == 'R')
+    {
+        manager.applyRemove(undo.id);
+        lane.undoEntries.push_back({'R', undo.id.str(), ""});
+    }
+    else if (undo.operation == 'U')
+    {
+        const T &value = lane.previous[undo.value];
+        manager.applyUpdate(undo.id, value);
+        lane.undoEntries.push_back({'U', undo.id.str(), formatRecord(value)});
+    }
+    else
+    {
+        const T &value = lane.previous[undo.value];
+        manager.applyAdd(value);
+        lane.undoEntries.push_back({'A', undo.id.str(), formatRecord(value)});
+    }
+}
+
+template <typename Manager, typename T>
+void Transaction::resetLane(Lane<Manager, T> &lane)
+{
+    lane.values.clear();
+    lane.previous.clear();
+    lane.entries.clear();
+    lane.undoEntries.clear();
+}
+
+bool Transaction::commit()
+{
+    // Every distinct group-commit flusher is locked once, in address order,
+    // so no flush sees half a batch.
+    vector<FlushScheduler *> flushers = {routes.manager.flusher, buses.manager.flusher,
+                                         drivers.manager.flusher, schedules.manager.flusher};
+    sort(flushers.begin(), flushers.end());
+    flushers.erase(unique(flushers.begin(), flushers.end()), flushers.end());
+    vector<FlushScheduler::Guard> guards;
+    guards.reserve(flushers.size());
+    for (FlushScheduler *flusher : flushers)
+    {
+        guards.emplace_back(flusher);
+    }
+
+    vector<Change> undo(staged.size());
+    size_t applied = 0;
+    while (applied < staged.size() &&
+           visit(staged[applied].target, [&](auto &lane)
+                 { return apply(lane, staged[applied], undo[applied]); }))
+    {
+        applied++;
+    }
+
+    bool committed = applied == staged.size();
+    Target order[] = {Target::Route, Target::Bus, Target::Driver, Target::Schedule};
+    size_t written = 0;
+    if (committed)
+    {
+        while (written < 4 && visit(order[written], [](auto &lane)
+                                    { return lane.manager.persistBatch(lane.entries); }))
+        {
+            written++;
+        }
+        committed = written == 4;
+        if (!committed)
+        {
+            cout << "Error: The transaction could not be written and was rolled back." << endl;
+        }
+    }
+    else
+    {
+        cout << "Error: Change " << applied + 1 << " of " << staged.size()
+             << " was rejected; the transaction was rolled back." << endl;
+    }
+
+    if (committed)
+    {
+        cout << "Transaction committed " << staged.size() << " changes." << endl;
+    }
+    else
+    {
+        for (size_t i = applied; i-- > 0;)
+        {
+            visit(undo[i].target, [&](auto &lane)
+                  { revert(lane, undo[i]); });
+        }
+        // Logs that already took the batch also take its undo.
+        for (size_t i = 0; i < written; ++i)
+        {
+            visit(order[i], [](auto &lane)
+                  { return lane.manager.persistBatch(lane.undoEntries); });
+        }
+    }
+
+    clear();
+    return committed;
+}
+
+void Transaction::clear()
+{
+    staged.clear();
+    resetLane(routes);
+    resetLane(buses);
+    resetLane(drivers);
+    resetLane(schedules);
+}
+
+size_t Transaction::size() const
+{
+    return staged.size();
+}
@@ -0,0 +1,415 @@
+﻿#include "../include/TravelTimeMatrix.h"
+#include "../include/DataSaver.h"
+#include "../include/MappedFile.h"
+#include "../include/SnapshotFormat.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <functional>
+#include <queue>
+#include <thread>
+#include <tuple>
+
+using namespace std;
+
+static const char MAGIC[4] = {'B', 'M', 'T', 'T'};
+static const uint32_t VERSION = 1;
+static const size_t HEADER_SIZE = 28;
+
+void TravelTimeMatrix::routeHops(const Route &route, vector<Hop> &out)
+{
+    vector<Symbol> names;
+    names.push_back(SymbolTable::intern(route.getOrigin()));
+    names.insert(names.end(), route.getKeyStopSymbols().begin(), route.getKeyStopSymbols().end());
+    names.push_back(SymbolTable::intern(route.getDestination()));
+
+    // Hop k ends at duration * (k + 1) / hops, so the hops add up to the route's time.
+    int32_t duration = route.getEstimatedTravelTime();
+    int32_t hops = static_cast<int32_t>(names.size() - 1);
+    for (int32_t k = 0; k < hops; ++k)
+    {
+        out.push_back({names[k], names[k + 1], duration * (k + 1) / hops - duration * k / hops});
+    }
+}
+
+bool TravelTimeMatrix::hopEdges(const vector<Hop> &hops, vector<Edge> &out) const
+{
+    for (const Hop &hop : hops)
+    {
+        auto from = stopIndex.find(hop.from);
+        auto to = stopIndex.find(hop.to);
+        if (from == stopIndex.end() || to == stopIndex.end())
+        {
+            return false;
+        }
+        out.push_back({from->second, to->second, hop.minutes});
+    }
+    return true;
+}
+
+void TravelTimeMatrix::indexStops(const vector<Route> &routes)
+{
+    stopNames.clear();
+    stopIndex.clear();
+    auto addStop = [this](Symbol name)
+    {
+        if (stopIndex.emplace(name, static_cast<uint32_t>(stopNames.size())).second)
+        {
+            stopNames.push_back(name);
+        }
+    };
+    for (const auto &route : routes)
+    {
+        addStop(SymbolTable::intern(route.getOrigin()));
+        for (Symbol stop : route.getKeyStopSymbols())
+        {
+            addStop(stop);
+        }
+        addStop(SymbolTable::intern(route.getDestination()));
+    }
+}
+
+void TravelTimeMatrix::buildEdges(const vector<Route> &routes)
+{
+    vector<Hop> hops;
+    for (const auto &route : routes)
+    {
+        routeHops(route, hops);
+    }
+    vector<Edge> all;
+    all.reserve(hops.size());
+    hopEdges(hops, all);
+
+    // Counting sort by origin stop.
+    edgeStart.assign(stopNames.size() + 1, 0);
+    for (const Edge &edge : all)
+    {
+        edgeStart[edge.from + 1]++;
+    }
+    for (size_t s = 0; s < stopNames.size(); ++s)
+    {
+        edgeStart[s + 1] += edgeStart[s];
+    }
+    edges.resize(all.size());
+    vector<uint32_t> next(edgeStart.begin(), edgeStart.end() - 1);
+    for (const Edge &edge : all)
+    {
+        edges[next[edge.from]++] = edge;
+    }
+}
+
+void TravelTimeMatrix::computeRows(const vector<uint32_t> &origins, unsigned threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+    size_t workerCount = min<size_t>(threadCount, max<size_t>(origins.size(), 1));
+    size_t stops = stopNames.size();
+
+    // Workers claim whole rows, so each row is written by one thread.
+    atomic<size_t> nextOrigin(0);
+    auto work = [&]()
+    {
+        using Entry = pair<int32_t, uint32_t>;
+        vector<int32_t> distance(stops);
+        vector<Entry> heapStorage;
+        for (size_t o = nextOrigin++; o < origins.size(); o = nextOrigin++)
+        {
+            uint32_t origin = origins[o];
+            fill(distance.begin(), distance.end(), INT32_MAX);
+            distance[origin] = 0;
+            heapStorage.clear();
+            priority_queue<Entry, vector<Entry>, greater<Entry>> heap(greater<Entry>(), move(heapStorage));
+            heap.push({0, origin});
+            while (!heap.empty())
+            {
+                auto [reached, stop] = heap.top();
+                heap.pop();
+                if (reached > distance[stop])
+                {
+                    continue;
+                }
+                for (uint32_t e = edgeStart[stop]; e < edgeStart[stop + 1]; ++e)
+                {
+                    int32_t arrival = reached + edges[e].minutes;
+                    if (arrival < distance[edges[e].to])
+                    {
+                        distance[edges[e].to] = arrival;
+                        heap.push({arrival, edges[e].to});
+                    }
+                }
+            }
+
+            int32_t *row = times.data() + origin * stops;
+            for (size_t s = 0; s < stops; ++s)
+            {
+                row[s] = distance[s] == INT32_MAX ? UNREACHABLE : distance[s];
+            }
+        }
+    };
+
+    vector<thread> workers;
+    for (size_t w = 1; w < workerCount; ++w)
+    {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void TravelTimeMatrix::build(const vector<Route> &routes, unsigned threadCount)
+{
+    indexStops(routes);
+    buildEdges(routes);
+    times.assign(stopNames.size() * stopNames.size(), UNREACHABLE);
+
+    vector<uint32_t> origins(stopNames.size());
+    for (uint32_t s = 0; s < origins.size(); ++s)
+    {
+        origins[s] = s;
+    }
+    computeRows(origins, threadCount);
+    built = true;
+    pendingRemoved.clear();
+    pendingAdded.clear();
+}
+
+void TravelTimeMatrix::recordChange(const Route *before, const Route *after)
+{
+    if (!built)
+    {
+        return;
+    }
+    if (before)
+    {
+        routeHops(*before, pendingRemoved);
+    }
+    if (after)
+    {
+        routeHops(*after, pendingAdded);
+    }
+
+    // Beyond this many changed hops a rebuild is cheaper than testing every
+    // row against them, so the matrix is dropped and rebuilt when next needed.
+    if (pendingRemoved.size() + pendingAdded.size() > edges.size())
+    {
+        built = false;
+        pendingRemoved.clear();
+        pendingAdded.clear();
+    }
+}
+
+bool TravelTimeMatrix::isStale() const
+{
+    return !pendingRemoved.empty() || !pendingAdded.empty();
+}
+
+size_t TravelTimeMatrix::update(const vector<Route> &routes, const Route *before, const Route *after,
+                                unsigned threadCount)
+{
+    bool wasBuilt = built;
+    recordChange(before, after);
+    if (wasBuilt && !built)
+    {
+        build(routes, threadCount);
+        return stopNames.size();
+    }
+    return refresh(routes, threadCount);
+}
+
+size_t TravelTimeMatrix::refresh(const vector<Route> &routes, unsigned threadCount)
+{
+    if (!built || !isStale())
+    {
+        return 0;
+    }
+
+    vector<Edge> removed;
+    vector<Edge> added;
+    bool known = hopEdges(pendingRemoved, removed) && hopEdges(pendingAdded, added);
+    pendingRemoved.clear();
+    pendingAdded.clear();
+    if (!known)
+    {
+        // A stop new to the matrix changes its shape; start over.
+        build(routes, threadCount);
+        return stopNames.size();
+    }
+
+    // Hops the route keeps unchanged cancel out.
+    auto less = [](const Edge &a, const Edge &b)
+    { return tie(a.from, a.to, a.minutes) < tie(b.from, b.to, b.minutes); };
+    sort(removed.begin(), removed.end(), less);
+    sort(added.begin(), added.end(), less);
+    vector<Edge> gone;
+    vector<Edge> fresh;
+    set_difference(removed.begin(), removed.end(), added.begin(), added.end(), back_inserter(gone), less);
+    set_difference(added.begin(), added.end(), removed.begin(), removed.end(), back_inserter(fresh), less);
+
+    buildEdges(routes);
+
+    // A row is stale if a dropped hop lies on one of its shortest paths
+    // (the hop is tight: d(u) + w == d(v)) or a new hop shortens the way to
+    // its end. Every other row keeps its shortest paths, and no new hop can
+    // improve them. This holds for any number of changes at once, as the
+    // rows are those from before all of them.
+    size_t stops = stopNames.size();
+    vector<uint32_t> stale;
+    for (uint32_t origin = 0; origin < stops; ++origin)
+    {
+        const int32_t *row = times.data() + origin * stops;
+        bool affected = false;
+        for (size_t i = 0; i < gone.size() && !affected; ++i)
+        {
+            int32_t start = row[gone[i].from];
+            affected = start != UNREACHABLE && row[gone[i].to] == start + gone[i].minutes;
+        }
+        for (size_t i = 0; i < fresh.size() && !affected; ++i)
+        {
+            int32_t start = row[fresh[i].from];
+            affected = start != UNREACHABLE &&
+                       (row[fresh[i].to] == UNREACHABLE || start + fresh[i].minutes < row[fresh[i].to]);
+        }
+        if (affected)
+        {
+            stale.push_back(origin);
+        }
+    }
+
+    computeRows(stale, threadCount);
+    return stale.size();
+}
+
+int32_t TravelTimeMatrix::travelTime(string_view from, string_view to) const
+{
+    Symbol fromName;
+    Symbol toName;
+    if (!SymbolTable::find(from, fromName) || !SymbolTable::find(to, toName))
+    {
+        return UNREACHABLE;
+    }
+    auto fromStop = stopIndex.find(fromName);
+    auto toStop = stopIndex.find(toName);
+    if (fromStop == stopIndex.end() || toStop == stopIndex.end())
+    {
+        return UNREACHABLE;
+    }
+    return times[static_cast<size_t>(fromStop->second) * stopNames.size() + toStop->second];
+}
+
+uint64_t TravelTimeMatrix::fingerprint(const vector<Route> &routes)
+{
+    // A sum, so removals that reorder the list do not change it.
+    uint64_t hash = routes.size();
+    for (const auto &route : routes)
+    {
+        hash += SnapshotFormat::checksum(DataSaver::formatRoute(route));
+    }
+    return hash;
+}
+
+bool TravelTimeMatrix::save(const string &filename, const vector<Route> &routes) const
+{
+    return DataSaver::writeFileAtomically(filename, encode(routes));
+}
+
+string TravelTimeMatrix::encode(const vector<Route> &routes) const
+{
+    using SnapshotFormat::putU32;
+
+    string payload;
+    for (Symbol stop : stopNames)
+    {
+        const string &name = SymbolTable::name(stop);
+        putU32(payload, static_cast<uint32_t>(name.size()));
+        payload += name;
+    }
+    for (int32_t minutes : times)
+    {
+        putU32(payload, static_cast<uint32_t>(minutes));
+    }
+
+    string header(MAGIC, 4);
+    putU32(header, VERSION);
+    putU32(header, static_cast<uint32_t>(stopNames.size()));
+    SnapshotFormat::putU64(header, fingerprint(routes));
+    SnapshotFormat::putU64(header, SnapshotFormat::checksum(payload));
+
+    return header + payload;
+}
+
+bool TravelTimeMatrix::load(const string &filename, const vector<Route> &routes)
+{
+    MappedFile file(filename);
+    if (!file.isOpen())
+    {
+        return false;
+    }
+
+    string_view bytes = file.view();
+    if (bytes.size() < HEADER_SIZE || bytes.compare(0, 4, string_view(MAGIC, 4)) != 0 ||
+        SnapshotFormat::getU32(bytes.data() + 4) != VERSION ||
+        SnapshotFormat::getU64(bytes.data() + 12) != fingerprint(routes))
+    {
+        return false;
+    }
+    string_view payload = bytes.substr(HEADER_SIZE);
+    if (SnapshotFormat::checksum(payload) != SnapshotFormat::getU64(bytes.data() + 20))
+    {
+        return false;
+    }
+
+    size_t stops = SnapshotFormat::getU32(bytes.data() + 8);
+    vector<Symbol> names;
+    size_t offset = 0;
+    for (size_t s = 0; s < stops; ++s)
+    {
+        if (payload.size() - offset < 4)
+        {
+            return false;
+        }
+        size_t length = SnapshotFormat::getU32(payload.data() + offset);
+        offset += 4;
+        if (payload.size() - offset < length)
+        {
+            return false;
+        }
+        names.push_back(SymbolTable::intern(payload.substr(offset, length)));
+        offset += length;
+    }
+    if (payload.size() - offset != stops * stops * 4)
+    {
+        return false;
+    }
+
+    stopNames = move(names);
+    stopIndex.clear();
+    for (uint32_t s = 0; s < stopNames.size(); ++s)
+    {
+        stopIndex.emplace(stopNames[s], s);
+    }
+    times.resize(stops * stops);
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        times[i] = static_cast<int32_t>(SnapshotFormat::getU32(payload.data() + offset + 4 * i));
+    }
+    buildEdges(routes);
+    built = true;
+    pendingRemoved.clear();
+    pendingAdded.clear();
+    return true;
+}
+
+bool TravelTimeMatrix::isBuilt() const
+{
+    return built;
+}
+
+size_t TravelTimeMatrix::stopCount() const
+{
+    return stopNames.size();
+}
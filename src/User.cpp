@@ -8,12 +8,12 @@ User::User(const string &username, const string &password, UserRole role)
     : username(username), password(password), role(role) {}
 
 
-string User::getUsername() const
+const string &User::getUsername() const
 {
     return username;
 }
 
-string User::getPassword() const
+const string &User::getPassword() const
 {
     return password;
 }
@@ -0,0 +1,30 @@
+﻿#include <iostream>
+#include <cstdlib>
+#include <filesystem>
+#include "../include/BenchmarkRunner.h"
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    // Optional arguments: number of schedules to generate (default 1,000,000)
+    // and number of in-memory schedules for the lookup benchmark (default 10,000,000)
+    size_t schedules = 1000000;
+    size_t lookupSchedules = 10000000;
+    if (argc > 1)
+    {
+        schedules = strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2)
+    {
+        lookupSchedules = strtoull(argv[2], nullptr, 10);
+    }
+
+    const string BENCH_PATH = "bench_data/";
+    filesystem::create_directories(BENCH_PATH);
+
+    BenchmarkRunner runner(BENCH_PATH, schedules, lookupSchedules);
+    runner.runAllBenchmarks();
+
+    return 0;
+}
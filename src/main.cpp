@@ -1,4 +1,7 @@
 ﻿#include "../include/DataLoader.h"
+#include "../include/DataSaver.h"
+#include "../include/StartupLoader.h"
+#include "../include/FlushScheduler.h"
 #include "../include/DisplayManager.h"
 #include "../include/LoginManager.h"
 #include "../include/RouteManager.h"
@@ -8,6 +11,7 @@
 #include "../include/AdminDashboard.h"
 #include "../include/DriverDashboard.h"
 #include "../include/PassengerMenu.h"
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
 #include <limits>
@@ -78,16 +82,25 @@ int main()
     const string ROUTES_FILE = DATA_PATH + "routes.txt";
     const string SCHEDULES_FILE = DATA_PATH + "schedules.txt";
     const string CREDENTIALS_FILE = DATA_PATH + "credentials.txt";
+    const string SNAPSHOT_FILE = DATA_PATH + "snapshot.bin";
 
     cout << "\n========================================" << endl;
     cout << "   INITIALIZING SYSTEM..." << endl;
     cout << "========================================" << endl;
 
-    vector<Bus> buses = DataLoader::loadBuses(BUSES_FILE);
-    vector<Driver> drivers = DataLoader::loadDrivers(DRIVERS_FILE);
-    vector<Route> routes = DataLoader::loadRoutes(ROUTES_FILE);
-    vector<Schedule> schedules = DataLoader::loadSchedules(SCHEDULES_FILE);
-    vector<User> users = DataLoader::loadCredentials(CREDENTIALS_FILE);
+    DataLoader::setLoadMode(LoadMode::PARALLEL);
+
+    StartupLoader startupLoader(BUSES_FILE, DRIVERS_FILE, ROUTES_FILE, SCHEDULES_FILE, CREDENTIALS_FILE);
+    startupLoader.setSnapshotFile(SNAPSHOT_FILE);
+    startupLoader.setArenaLoading(true);
+    SystemData data = startupLoader.loadAll();
+    startupLoader.displayTimings();
+
+    vector<Bus> &buses = data.buses;
+    vector<Driver> &drivers = data.drivers;
+    vector<Route> &routes = data.routes;
+    vector<Schedule> &schedules = data.schedules;
+    vector<User> &users = data.users;
 
     cout << "\nSystem initialized successfully!" << endl;
     cout << "\nPress Enter to continue...";
@@ -99,6 +112,14 @@ int main()
     BusManager busManager(buses, BUSES_FILE);
     DriverManager driverManager(drivers, DRIVERS_FILE);
     ScheduleManager scheduleManager(schedules, routes, buses, drivers, SCHEDULES_FILE);
+    scheduleManager.setReferenceLookups(routeManager, busManager, driverManager);
+
+    // Declared after the managers so it is destroyed before them.
+    FlushScheduler flusher;
+    routeManager.attachFlusher(flusher);
+    busManager.attachFlusher(flusher);
+    driverManager.attachFlusher(flusher);
+    scheduleManager.attachFlusher(flusher);
 
     bool running = true;
 
@@ -170,14 +191,28 @@ int main()
         case 3:
         {
             
-            PassengerMenu passengerMenu(routeManager);
+            PassengerMenu passengerMenu(routeManager, scheduleManager);
             passengerMenu.show();
             break;
         }
 
         case 4:
         {
-            
+            // Fold every log into its data file, then refresh the snapshot
+            // so the next start can skip CSV parsing. A log left behind would
+            // be replayed over the snapshot, so then the snapshot is dropped.
+            flusher.flush();
+            bool folded = routeManager.compact() && busManager.compact() && driverManager.compact() &&
+                          scheduleManager.compact() && scheduleManager.unreadableRows() == 0;
+            if (folded)
+            {
+                DataSaver::saveSnapshot(SNAPSHOT_FILE, data, startupLoader.getSourceFiles());
+            }
+            else
+            {
+                remove(SNAPSHOT_FILE.c_str());
+            }
+
             cout << "\n========================================" << endl;
             cout << "   Thank you for using" << endl;
             cout << "   Bus Management System" << endl;
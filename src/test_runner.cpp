@@ -1,5 +1,6 @@
 ﻿#include <iostream>
 #include "../include/DataLoader.h"
+#include "../include/StartupLoader.h"
 #include "../include/RouteManager.h"
 #include "../include/BusManager.h"
 #include "../include/DriverManager.h"
@@ -18,11 +19,16 @@ int main()
 
     // Load all data
     const string DATA_PATH = "data/";
-    vector<Bus> buses = DataLoader::loadBuses(DATA_PATH + "buses.txt");
-    vector<Driver> drivers = DataLoader::loadDrivers(DATA_PATH + "drivers.txt");
-    vector<Route> routes = DataLoader::loadRoutes(DATA_PATH + "routes.txt");
-    vector<Schedule> schedules = DataLoader::loadSchedules(DATA_PATH + "schedules.txt");
-    vector<User> users = DataLoader::loadCredentials(DATA_PATH + "credentials.txt");
+    StartupLoader startupLoader(DATA_PATH + "buses.txt", DATA_PATH + "drivers.txt", DATA_PATH + "routes.txt",
+                                DATA_PATH + "schedules.txt", DATA_PATH + "credentials.txt");
+    SystemData data = startupLoader.loadAll();
+    startupLoader.displayTimings();
+
+    vector<Bus> &buses = data.buses;
+    vector<Driver> &drivers = data.drivers;
+    vector<Route> &routes = data.routes;
+    vector<Schedule> &schedules = data.schedules;
+    vector<User> &users = data.users;
 
     cout << "\nTest environment initialized successfully!\n";
 
@@ -32,6 +38,7 @@ int main()
     BusManager busManager(buses, DATA_PATH + "buses.txt");
     DriverManager driverManager(drivers, DATA_PATH + "drivers.txt");
     ScheduleManager scheduleManager(schedules, routes, buses, drivers, DATA_PATH + "schedules.txt");
+    scheduleManager.setReferenceLookups(routeManager, busManager, driverManager);
 
     // Create and run tester
     SystemTester tester;